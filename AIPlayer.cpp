@@ -1,117 +1,481 @@
 #include "AIPlayer.h"
+#include "GameSession.h"
 #include "Referee.h"
-#include <iostream>
+#include "Trace.h"
+#include "Log.h"
+#include "ByteIO.h"
 #include <vector>
 #include <ctime>
-#include <cstdlib>
 #include <fstream> // 文件流
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <sstream>
 
 using namespace std;
 
-CAIPlayer::CAIPlayer(int color) : CPlayer(color) {
-    srand((unsigned)time(NULL));
+template <int N, class TRule>
+CAIPlayerT<N, TRule>::CAIPlayerT(int color)
+    : CPlayerT<N>(color), m_rng((unsigned)time(NULL) + color), m_iSearchDepth(0), m_iMultiPV(1),
+      m_iPlayouts(0), m_eMCTSMode(MCTS_PUCT), m_iMCTSBatch(1), m_bMoveOrdering(true), m_iTTEntries(AI_TT_ENTRIES) {
     m_strWeightFile = "ai_brain.txt"; // 大脑记忆文件
     LoadWeights(); // 出生时先读取记忆
 }
 
-// [新增] 读取记忆
-void CAIPlayer::LoadWeights() {
-    ifstream file(m_strWeightFile);
+template <int N, class TRule>
+CAIPlayerT<N, TRule>::CAIPlayerT(int color, shared_ptr<const AIWeights> pWeights)
+    : CPlayerT<N>(color), m_pWeights(pWeights), m_rng((unsigned)time(NULL) + color),
+      m_iSearchDepth(0), m_iMultiPV(1), m_iPlayouts(0), m_eMCTSMode(MCTS_PUCT), m_iMCTSBatch(1), m_bMoveOrdering(true),
+      m_iTTEntries(AI_TT_ENTRIES) {
+    // 共享权重只读，m_strWeightFile 留空，Learn 不会写盘
+}
+
+AIWeights ReadAIWeights(const string& strFile) {
+    AIWeights stWeights;
+    ifstream file(strFile);
     if (file.is_open()) {
-        file >> m_stWeights.iWin5 >> m_stWeights.iLive4 >> m_stWeights.iDash4
-             >> m_stWeights.iLive3 >> m_stWeights.iLive2
-             >> m_stWeights.fAttackFactor >> m_stWeights.fDefenseFactor;
+        file >> stWeights.iWin5 >> stWeights.iLive4 >> stWeights.iDash4
+             >> stWeights.iLive3 >> stWeights.iLive2
+             >> stWeights.fAttackFactor >> stWeights.fDefenseFactor;
         file.close();
     } else {
         // 如果没有记忆，使用默认值 (什么都不做)
     }
+    return stWeights;
+}
+
+// [新增] 读取记忆
+template <int N, class TRule>
+void CAIPlayerT<N, TRule>::LoadWeights() {
+    m_pWeights = make_shared<AIWeights>(ReadAIWeights(m_strWeightFile));
 }
 
 // [新增] 保存记忆
-void CAIPlayer::SaveWeights() {
+template <int N, class TRule>
+void CAIPlayerT<N, TRule>::SaveWeights() {
+    if (m_strWeightFile.empty()) return; // 共享权重模式不落盘
+
+    const AIWeights& w = *m_pWeights;
     ofstream file(m_strWeightFile);
     if (file.is_open()) {
-        file << m_stWeights.iWin5 << " " << m_stWeights.iLive4 << " "
-             << m_stWeights.iDash4 << " " << m_stWeights.iLive3 << " "
-             << m_stWeights.iLive2 << " "
-             << m_stWeights.fAttackFactor << " " << m_stWeights.fDefenseFactor;
+        file << w.iWin5 << " " << w.iLive4 << " "
+             << w.iDash4 << " " << w.iLive3 << " "
+             << w.iLive2 << " "
+             << w.fAttackFactor << " " << w.fDefenseFactor;
         file.close();
         // [新增] 打印成功提示，并显示当前路径
-        cout << "[系统] AI 记忆已保存至: " << m_strWeightFile << endl;
+        WZQ_LOG(LOG_INFO, LOG_CAT_IO, "AI 记忆已保存").Text("file", m_strWeightFile);
     } else {
         // [新增] 打印失败提示
-        cout << "[错误] 无法创建记忆文件！请检查文件夹权限。" << endl;
+        WZQ_LOG(LOG_ERROR, LOG_CAT_IO, "无法创建记忆文件！请检查文件夹权限。").Text("file", m_strWeightFile);
     }
 }
 
 // [新增] 核心进化逻辑
-void CAIPlayer::Learn(bool bAiWon) {
+template <int N, class TRule>
+void CAIPlayerT<N, TRule>::Learn(bool bAiWon) {
+    // 权重可能被别人共享，先拷贝一份再改 (写时复制)
+    AIWeights stWeights = *m_pWeights;
+
     if (bAiWon) {
         // 如果赢了，稍微增强一点自信（进攻欲望）
         // 或者是保持现状，认为当前策略是好的
         // 这里我们设计：赢了就微调，让它更激进一点点
-        m_stWeights.fAttackFactor += 0.05f;
-        if(m_stWeights.fAttackFactor > 2.0f) m_stWeights.fAttackFactor = 2.0f; // 封顶
+        stWeights.fAttackFactor += 0.05f;
+        if(stWeights.fAttackFactor > 2.0f) stWeights.fAttackFactor = 2.0f; // 封顶
 
-        cout << "\n [AI复盘] 哈哈！我赢了！我觉得我的进攻策略很棒！(进攻欲望↑)" << endl;
+        WZQ_LOG(LOG_INFO, LOG_CAT_LEARN, "哈哈！我赢了！我觉得我的进攻策略很棒！(进攻欲望↑)")
+            .Real("attack", stWeights.fAttackFactor).Real("defense", stWeights.fDefenseFactor);
     } else {
         // 如果输了，反思：是不是我太浪了？还是防守不够？
         // 策略：增加防守权重，降低进攻权重
-        m_stWeights.fDefenseFactor += 0.1f;
-        m_stWeights.fAttackFactor -= 0.05f;
+        stWeights.fDefenseFactor += 0.1f;
+        stWeights.fAttackFactor -= 0.05f;
 
-        if (m_stWeights.fDefenseFactor > 2.5f) m_stWeights.fDefenseFactor = 2.5f;
-        if (m_stWeights.fAttackFactor < 0.5f) m_stWeights.fAttackFactor = 0.5f;
+        if (stWeights.fDefenseFactor > 2.5f) stWeights.fDefenseFactor = 2.5f;
+        if (stWeights.fAttackFactor < 0.5f) stWeights.fAttackFactor = 0.5f;
 
-        cout << "\n [AI复盘] 哎呀输了... 我下次会更注意防守的。 (防守意识↑)" << endl;
+        WZQ_LOG(LOG_INFO, LOG_CAT_LEARN, "哎呀输了... 我下次会更注意防守的。 (防守意识↑)")
+            .Real("attack", stWeights.fAttackFactor).Real("defense", stWeights.fDefenseFactor);
     }
+    m_pWeights = make_shared<AIWeights>(stWeights);
+
     // 这一步很关键：把学到的新参数存进硬盘
     SaveWeights();
 }
 
-Point CAIPlayer::MakeMove(CBoard& board) {
-    cout << endl << ">> 电脑正在思考 (攻:" << m_stWeights.fAttackFactor
-         << " 防:" << m_stWeights.fDefenseFactor << ")..." << endl;
+template <int N, class TRule>
+bool CAIPlayerT<N, TRule>::SetNetwork(shared_ptr<const CNNUENetwork> pNet) {
+    if (pNet && pNet->GetBoardSize() != N) return false;
+    m_pNetwork = pNet;
+    return true;
+}
 
-    clock_t start = clock();
-    while (clock() - start < 500);
+template <int N, class TRule>
+void CAIPlayerT<N, TRule>::SetTTEntries(size_t iEntries) {
+    m_iTTEntries = iEntries;
+    // CTransTable 按 2 的幂向下取整，比较取整后的大小
+    size_t iRounded = 1;
+    while (iRounded * 2 <= iEntries) iRounded *= 2;
+    if (m_pTT && m_pTT->GetEntryCount() != iRounded) m_pTT.reset();
+}
 
-    int maxScore = -99999999;
-    vector<Point> bestPoints;
+// 状态：深度 多主变例 模拟盘数 MCTS 方式 批量 走法排序 (各 4 字节) 随机数状态 (8 字节) 置换表条目数 (8 字节，0 为没分配)
+// 槽位，最后是以上全部的 HashWords (8 字节)；固定部分正好 40 字节，置换表的校验和可以接着算
+static const size_t AI_STATE_FIXED_BYTES = 6 * 4 + 8 + 8;
 
-    for (int y = 0; y < BOARD_SIZE; y++) {
-        for (int x = 0; x < BOARD_SIZE; x++) {
-            if (!board.IsEmpty(x, y)) continue;
+template <int N, class TRule>
+void CAIPlayerT<N, TRule>::SaveState(vector<uint8_t>& v) const {
+    size_t iStart = v.size();
+    PutU32(v, (uint32_t)m_iSearchDepth);
+    PutU32(v, (uint32_t)m_iMultiPV);
+    PutU32(v, (uint32_t)m_iPlayouts);
+    PutU32(v, (uint32_t)m_eMCTSMode);
+    PutU32(v, (uint32_t)m_iMCTSBatch);
+    PutU32(v, m_bMoveOrdering ? 1u : 0u);
+    ostringstream ssRng;
+    ssRng << m_rng;
+    PutU64(v, strtoull(ssRng.str().c_str(), NULL, 10));
+    PutU64(v, m_pTT ? (uint64_t)m_pTT->GetEntryCount() : 0);
+    uint64_t ullHash = HashWords(&v[iStart], AI_STATE_FIXED_BYTES);
+    if (m_pTT) {
+        size_t iAt = v.size();
+        v.resize(iAt + m_pTT->GetRawBytes());
+        ullHash = m_pTT->SaveRaw(&v[iAt], ullHash);
+    }
+    PutU64(v, ullHash);
+}
+
+template <int N, class TRule>
+size_t CAIPlayerT<N, TRule>::LoadState(const uint8_t* p, size_t iBytes) {
+    const size_t iFixed = AI_STATE_FIXED_BYTES;
+    if (iBytes < iFixed + 8) return 0;
+    uint64_t ullEntries = GetU64(p + 32);
+    // 条目数必须是 2 的幂，并且槽位都在范围内
+    if ((ullEntries & (ullEntries - 1)) != 0 || ullEntries > (iBytes - iFixed - 8) / 16) return 0;
+    uint32_t uMode = GetU32(p + 12);
+    if (uMode != MCTS_PUCT && uMode != MCTS_UCB1) return 0;
+
+    // 置换表读进新表，和校验和一起一遍做完；校验通过才换上
+    size_t iUsed = iFixed + (size_t)ullEntries * 16;
+    uint64_t ullHash = HashWords(p, iFixed);
+    shared_ptr<CTransTable> pTT;
+    if (ullEntries > 0) pTT = make_shared<CTransTable>((size_t)ullEntries, p + iFixed, &ullHash);
+    if (ullHash != GetU64(p + iUsed)) return 0;
+
+    m_iSearchDepth = min(max((int)GetU32(p), 0), SEARCH_MAX_PLY - 1);
+    m_iMultiPV = min(max((int)GetU32(p + 4), 1), N * N);
+    m_iPlayouts = max((int)GetU32(p + 8), 0);
+    m_eMCTSMode = (EMCTSMode)uMode;
+    m_iMCTSBatch = min(max((int)GetU32(p + 16), 1), (int)CBatchPlayoutT<N, TRule>::MAX_LANES);
+    m_bMoveOrdering = GetU32(p + 20) != 0;
+    istringstream ssRng(to_string(GetU64(p + 24)));
+    ssRng >> m_rng;
+    m_pTT = pTT;
+    if (pTT) m_iTTEntries = (size_t)ullEntries;
+    return iUsed + 8;
+}
 
-            if (m_iColor == BLACK) {
-                board.PlacePiece(x, y, BLACK);
-                if (CReferee::CheckForbidden(board, x, y)) {
-                    board.UndoPiece(x, y);
-                    continue;
+template <int N, class TRule>
+Point CAIPlayerT<N, TRule>::MakeMove(Board& board) {
+    WZQ_TRACE_SCOPE("ai.move", "ai");
+    WZQ_LOG(LOG_INFO, LOG_CAT_AI, "电脑正在思考...")
+        .Real("attack", m_pWeights->fAttackFactor).Real("defense", m_pWeights->fDefenseFactor);
+
+    if (m_iPlayouts > 0) {
+        CSearchControl ctl(CSearchControl::Clock::now() + chrono::seconds(10), -1, 1);
+        Point p = SearchMove(board, ctl);
+        const SMCTSStats& st = m_stLastMCTS;
+        WZQ_LOG(LOG_INFO, LOG_CAT_SEARCH, "MCTS 完成")
+            .Text("move", PointToString(p)).Int("playouts", st.iPlayouts).Int("nodes", st.iTreeNodes)
+            .Int("win_pct", (int)(st.dBestWinRate * 100));
+        return p;
+    }
+    if (m_iSearchDepth <= 0) {
+        clock_t start = clock();
+        while (clock() - start < 500);
+        return SearchMove(board);
+    }
+
+    // 深度搜索：最多想 10 秒 (留出 15 秒限时的余量)，本机其余核心一起跑 Lazy SMP
+    CSearchControl ctl(CSearchControl::Clock::now() + chrono::seconds(10), -1, 1);
+    int iHelpers = min(3, (int)thread::hardware_concurrency() - 1);
+    Point p = SearchMove(board, ctl, 1 + max(0, iHelpers));
+
+    const SSearchStats& st = m_stLastStats;
+    WZQ_LOG(LOG_INFO, LOG_CAT_SEARCH, "搜索完成")
+        .Text("move", PointToString(p)).Int("depth", st.iDepth).Int("nodes", st.llNodes).Int("score", st.iScore)
+        .Int("first_cut_pct", (int)(st.stOrder.GetFirstCutoffRate() * 100));
+    // 主变例在思考结束后才拼字符串，不占搜索时间
+    for (size_t i = 0; i < st.vecLines.size(); i++) {
+        const SSearchLine& line = st.vecLines[i];
+        string strPV;
+        for (size_t k = 0; k < line.vecPV.size(); k++) strPV += (k ? " " : "") + PointToString(line.vecPV[k]);
+        WZQ_LOG(LOG_INFO, LOG_CAT_SEARCH, "候选")
+            .Int("rank", (long long)i + 1).Text("move", PointToString(line.stMove)).Int("score", line.iScore).Text("pv", strPV);
+    }
+    return p;
+}
+
+template <int N, class TRule>
+Point CAIPlayerT<N, TRule>::SearchMove(Board& board) {
+    CSearchControl ctl = CSearchControl::Unlimited();
+    return SearchMove(board, ctl);
+}
+
+template <int N, class TRule>
+Point CAIPlayerT<N, TRule>::SearchMove(Board& board, CSearchControl& ctl) {
+    CAISearchTaskT<N, TRule> task(*this, board);
+    task.Run(ctl);
+    return task.Finish();
+}
+
+template <int N, class TRule>
+Point CAIPlayerT<N, TRule>::SearchMove(Board& board, CSearchControl& ctl, int iThreads) {
+    CAISearchTaskT<N, TRule> task(*this, board);
+    vector<thread> vecThreads;
+    for (int i = 1; i < iThreads; i++) {
+        vecThreads.push_back(thread([&task, &ctl] {
+            CTrace::SetThreadName("search helper");
+            task.Run(ctl);
+        }));
+    }
+    task.Run(ctl);
+    for (size_t i = 0; i < vecThreads.size(); i++) vecThreads[i].join();
+    return task.Finish();
+}
+
+// 扫描顺序：从天元向外一圈一圈扫 (各线程按这个顺序分格子，兜底时也先找中间的空位)
+template <int N>
+static const vector<Point>& GetScanOrder() {
+    static const vector<Point> vecOrder = [] {
+        vector<Point> v;
+        int c = N / 2;
+        for (int r = 0; r <= c + 1; r++) {
+            for (int y = 0; y < N; y++) {
+                for (int x = 0; x < N; x++) {
+                    int d = max(abs(x - c), abs(y - c));
+                    if (d == r) v.push_back({x, y});
                 }
-                board.UndoPiece(x, y);
             }
+        }
+        return v;
+    }();
+    return vecOrder;
+}
+
+template <int N, class TRule>
+CAISearchTaskT<N, TRule>::CAISearchTaskT(CAIPlayerT<N, TRule>& ai, const Board& board)
+    : m_ai(ai), m_board(board), m_atNextCell(0), m_iMaxScore(-99999999),
+      m_pWeights(ai.m_pWeights), m_pNetwork(ai.m_pNetwork), m_atSearchers(0), m_llSearchNodes(0),
+      m_llTTProbes(0), m_llTTHits(0) {
+    m_stOrderTotal.llCutoffs = 0;
+    m_stOrderTotal.llFirstCutoffs = 0;
+    if (m_ai.m_iSearchDepth > 0 && !m_ai.m_pTT) m_ai.m_pTT = make_shared<CTransTable>(m_ai.m_iTTEntries);
+    // 随机种子在这里 (持有对局锁时) 取好，搜索期间不碰 AI 的随机数，思考中也能存快照
+    m_uMCTSSeed = m_ai.m_iPlayouts > 0 ? (unsigned)m_ai.m_rng() : 0;
+    // 只有上一手以来变动的格子需要重算，之后各线程只读查询
+    if (m_ai.m_iColor == BLACK) m_ai.m_forbidden.Sync(board);
 
-            int score = EvaluatePoint(board, x, y);
-            if (score > maxScore) {
-                maxScore = score;
-                bestPoints.clear();
-                bestPoints.push_back({x, y});
-            } else if (score == maxScore) {
-                bestPoints.push_back({x, y});
+    // 贪心只看一层，评分图对跳活三、跳四的防守点不敏感：必应点从威胁索引直接取
+    m_bForced = false;
+    memset(m_arrForced, 0, sizeof(m_arrForced));
+    if (m_ai.m_iSearchDepth == 0 && m_ai.m_iPlayouts == 0) {
+        m_ai.m_threats.Sync(board);
+        CMoveListT<N> vecForced;
+        m_ai.m_threats.GetForcedMoves(m_ai.m_iColor, true, vecForced);
+        for (int i = 0; i < vecForced.size(); i++) {
+            int x = vecForced[i] % N, y = vecForced[i] / N;
+            if (m_ai.m_iColor == BLACK && m_ai.m_forbidden.IsForbidden(x, y)) continue;
+            m_arrForced[vecForced[i]] = true;
+            m_bForced = true;
+        }
+    }
+}
+
+template <int N, class TRule>
+void CAISearchTaskT<N, TRule>::Run(CSearchControl& ctl) {
+    WZQ_TRACE_SCOPE("ai.run", "ai");
+    if (m_ai.m_iPlayouts > 0) {
+        RunMCTS(ctl);
+        return;
+    }
+    if (m_ai.m_iSearchDepth > 0) {
+        RunAlphaBeta(ctl);
+        return;
+    }
+
+    // 全盘评分一次算完 (SIMD)，之后每个格子只是查表
+    // 节点按整张图一次记上；预算砍不掉已经算完的评分，所以查表总是扫完全盘
+    call_once(m_onceScores, [this, &ctl] {
+        m_ai.ScoreMap(m_board, m_arrScores);
+        ctl.CountNodes(N * N);
+    });
+
+    const vector<Point>& vecOrder = GetScanOrder<N>();
+
+    int maxScore = -99999999;
+    CFixedList<Point, N * N> bestPoints; // 各线程分到的格子不重叠，合并后也不会超过 N * N
+
+    while (true) {
+        int idx = m_atNextCell++;
+        if (idx >= (int)vecOrder.size()) break;
+
+        int x = vecOrder[idx].iX;
+        int y = vecOrder[idx].iY;
+        if (!m_board.IsEmpty(x, y)) continue;
+        if (m_ai.m_iColor == BLACK && m_ai.m_forbidden.IsForbidden(x, y)) continue;
+        if (m_bForced && !m_arrForced[y * N + x]) continue;
+
+        int score = m_arrScores[y * N + x];
+        if (score > maxScore) {
+            maxScore = score;
+            bestPoints.clear();
+            bestPoints.push_back({x, y});
+        } else if (score == maxScore) {
+            bestPoints.push_back({x, y});
+        }
+    }
+
+    // 合并到全局结果
+    lock_guard<mutex> lock(m_mtx);
+    if (maxScore > m_iMaxScore) {
+        m_iMaxScore = maxScore;
+        m_vecBest = bestPoints;
+    } else if (maxScore == m_iMaxScore) {
+        for (int i = 0; i < bestPoints.size(); i++) m_vecBest.push_back(bestPoints[i]);
+    }
+}
+
+template <int N, class TRule>
+void CAISearchTaskT<N, TRule>::RunAlphaBeta(CSearchControl& ctl) {
+    // 后加入的线程从更深一层起步，各线程错开，通过置换表互相借用结果
+    int iIndex = m_atSearchers++;
+    int iMaxDepth = m_ai.m_iSearchDepth;
+
+    CAlphaBetaT<N, TRule> search(*m_pWeights, *m_ai.m_pTT, ctl);
+    search.SetOrdering(m_ai.m_bMoveOrdering);
+    search.SetNetwork(m_pNetwork.get());
+    bool bMultiPV = (m_ai.m_iMultiPV > 1 && iIndex == 0);
+    SSearchStats stats = bMultiPV ? search.SearchMultiPV(m_board, m_ai.m_iColor, iMaxDepth, m_ai.m_iMultiPV)
+                                  : search.Search(m_board, m_ai.m_iColor, iMaxDepth, 1 + iIndex % 2);
+
+    lock_guard<mutex> lock(m_mtx);
+    m_llSearchNodes += stats.llNodes;
+    m_llTTProbes += stats.llTTProbes;
+    m_llTTHits += stats.llTTHits;
+    m_stOrderTotal.llCutoffs += stats.stOrder.llCutoffs;
+    m_stOrderTotal.llFirstCutoffs += stats.stOrder.llFirstCutoffs;
+    if (stats.stMove.iX < 0) return;
+    // 多主变例时只认搜各条线的那个线程的结果，否则取搜得最深的
+    if (m_ai.m_iMultiPV > 1) {
+        if (bMultiPV) m_stSearch = stats;
+    } else if (stats.iDepth > m_stSearch.iDepth) {
+        m_stSearch = stats;
+    }
+}
+
+template <int N, class TRule>
+void CAISearchTaskT<N, TRule>::RunMCTS(CSearchControl& ctl) {
+    if (m_atSearchers++ > 0) return;
+    CMCTST<N, TRule> mcts(*m_pWeights, m_ai.m_eMCTSMode, m_uMCTSSeed);
+    mcts.SetBatch(m_ai.m_iMCTSBatch);
+    m_stMCTS = mcts.Search(m_board, m_ai.m_iColor, m_ai.m_iPlayouts, ctl);
+}
+
+template <int N, class TRule>
+Point CAISearchTaskT<N, TRule>::Finish() {
+    if (m_ai.m_iPlayouts > 0) {
+        m_ai.m_stLastMCTS = m_stMCTS;
+        if (m_stMCTS.stMove.iX >= 0) return m_stMCTS.stMove;
+    } else if (m_ai.m_iSearchDepth > 0) {
+        m_ai.m_stLastStats = m_stSearch;
+        m_ai.m_stLastStats.llNodes = m_llSearchNodes;
+        m_ai.m_stLastStats.llTTProbes = m_llTTProbes;
+        m_ai.m_stLastStats.llTTHits = m_llTTHits;
+        m_ai.m_stLastStats.stOrder = m_stOrderTotal;
+        if (m_stSearch.stMove.iX >= 0) return m_stSearch.stMove;
+        // 一层都没搜完：退回下面的兜底逻辑
+    }
+
+    if (m_vecBest.empty()) {
+        // 搜索没给出结果：有必应点就只在必应点里挑，否则取评分图上分最高的合法空位
+        // (Alpha-Beta / MCTS 没算过评分图，这里补算一次)；同分取扫描顺序靠前的
+        call_once(m_onceScores, [this] { m_ai.ScoreMap(m_board, m_arrScores); });
+        const vector<Point>& vecOrder = GetScanOrder<N>();
+        Point stBest = { -1, -1 };
+        int iBestScore = 0;
+        for (size_t i = 0; i < vecOrder.size(); i++) {
+            int x = vecOrder[i].iX, y = vecOrder[i].iY;
+            if (!m_board.IsEmpty(x, y)) continue;
+            if (m_ai.m_iColor == BLACK && m_ai.m_forbidden.IsForbidden(x, y)) continue;
+            if (m_bForced && !m_arrForced[y * N + x]) continue;
+            if (stBest.iX < 0 || m_arrScores[y * N + x] > iBestScore) {
+                stBest = {x, y};
+                iBestScore = m_arrScores[y * N + x];
             }
         }
+        if (stBest.iX >= 0) return stBest;
+        return {N / 2, N / 2};
+    }
+
+    // 多线程合并的顺序不固定，先排好序，保证同样的随机数选出同样的点
+    sort(m_vecBest.begin(), m_vecBest.end(), [](const Point& a, const Point& b) {
+        return a.iY != b.iY ? a.iY < b.iY : a.iX < b.iX;
+    });
+    int index = (int)(m_ai.m_rng() % m_vecBest.size());
+    return m_vecBest[index];
+}
+
+template <int N, class TRule>
+void CAIPlayerT<N, TRule>::ScoreMap(const Board& board, int* pOut, EEvalKernel eKernel) {
+    const AIWeights& w = *m_pWeights;
+    int myColor = this->m_iColor;
+    int enemyColor = (myColor == BLACK) ? WHITE : BLACK;
+
+    SEvalInput in;
+    in.Clear(N);
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            in.SetCell(x, y, (int8_t)board.GetPiece(x, y));
+        }
     }
+    in.iMyColor = (int8_t)myColor;
+    in.iEnemyColor = (int8_t)enemyColor;
+    in.stParams.iWin5 = w.iWin5;
+    in.stParams.iLive4 = w.iLive4;
+    in.stParams.iDash4 = w.iDash4;
+    in.stParams.iLive3 = w.iLive3;
+    in.stParams.iLive2 = w.iLive2;
+    in.stParams.fAttackFactor = w.fAttackFactor;
+    in.stParams.fDefenseFactor = w.fDefenseFactor;
+    in.stParams.bMyExactFive = (myColor == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+    in.stParams.bEnemyExactFive = (enemyColor == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+
+    CEvalKernel::ScoreMap(in, pOut, eKernel);
+}
+
+template <int N, class TRule>
+int CAIPlayerT<N, TRule>::CheckScoreMap(Board& board, EEvalKernel eKernel) {
+    int arrScores[N * N];
+    ScoreMap(board, arrScores, eKernel);
 
-    if (bestPoints.empty()) return {7, 7};
-    int index = rand() % bestPoints.size();
-    return bestPoints[index];
+    int iMismatches = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            if (!board.IsEmpty(x, y)) continue;
+            if (arrScores[y * N + x] != EvaluatePoint(board, x, y)) iMismatches++;
+        }
+    }
+    return iMismatches;
 }
 
-int CAIPlayer::EvaluatePoint(CBoard& board, int x, int y) {
+template <int N, class TRule>
+int CAIPlayerT<N, TRule>::EvaluatePoint(Board& board, int x, int y) {
     int totalScore = 0;
-    int myColor = m_iColor;
-    int enemyColor = (m_iColor == BLACK) ? WHITE : BLACK;
+    int myColor = this->m_iColor;
+    int enemyColor = (myColor == BLACK) ? WHITE : BLACK;
 
     // 使用读取到的权重参数进行计算
     int myScore = 0;
@@ -121,7 +485,7 @@ int CAIPlayer::EvaluatePoint(CBoard& board, int x, int y) {
     myScore += GetLineScore(board, x, y, 1, -1, myColor);
 
     // 乘上性格系数
-    totalScore += (int)(myScore * m_stWeights.fAttackFactor);
+    totalScore += (int)(myScore * m_pWeights->fAttackFactor);
 
     int enemyScore = 0;
     enemyScore += GetLineScore(board, x, y, 1, 0, enemyColor);
@@ -130,20 +494,22 @@ int CAIPlayer::EvaluatePoint(CBoard& board, int x, int y) {
     enemyScore += GetLineScore(board, x, y, 1, -1, enemyColor);
 
     // 乘上性格系数
-    totalScore += (int)(enemyScore * m_stWeights.fDefenseFactor);
+    totalScore += (int)(enemyScore * m_pWeights->fDefenseFactor);
 
-    if (x >= 5 && x <= 9 && y >= 5 && y <= 9) totalScore += 10;
+    // 天元附近 5x5 的小加分 (15 路即 F6-J10)
+    if (abs(x - N / 2) <= 2 && abs(y - N / 2) <= 2) totalScore += 10;
 
     return totalScore;
 }
 
-int CAIPlayer::GetLineScore(CBoard& board, int x, int y, int dx, int dy, int color) {
+template <int N, class TRule>
+int CAIPlayerT<N, TRule>::GetLineScore(Board& board, int x, int y, int dx, int dy, int color) {
     int count = 1;
     int emptyEnds = 0;
 
     // ... (中间的扫描代码保持不变) ...
     // 这里为了节省篇幅省略，请使用上一版相同的扫描逻辑
-    // 仅修改下面的 return 值，使用 m_stWeights 中的变量
+    // 仅修改下面的 return 值，使用 m_pWeights 中的变量
 
     // 正向扫描...
     int i = 1;
@@ -157,18 +523,25 @@ int CAIPlayer::GetLineScore(CBoard& board, int x, int y, int dx, int dy, int col
     // ...
 
     // 使用变量代替硬编码
-    if (count >= 5) return m_stWeights.iWin5;
+    // 必须正好五连的规则下，长连不是胜利 (编译期常量，自由规则下这行不存在)
+    bool bExactFive = (color == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+    if (bExactFive && count > 5) return 0;
+    if (count >= 5) return m_pWeights->iWin5;
     if (count == 4) {
-        if (emptyEnds == 2) return m_stWeights.iLive4;
-        if (emptyEnds == 1) return m_stWeights.iDash4;
+        if (emptyEnds == 2) return m_pWeights->iLive4;
+        if (emptyEnds == 1) return m_pWeights->iDash4;
     }
     if (count == 3) {
-        if (emptyEnds == 2) return m_stWeights.iLive3;
-        if (emptyEnds == 1) return m_stWeights.iLive2; // 眠三价值较低，近似活二
+        if (emptyEnds == 2) return m_pWeights->iLive3;
+        if (emptyEnds == 1) return m_pWeights->iLive2; // 眠三价值较低，近似活二
     }
     if (count == 2) {
-        if (emptyEnds == 2) return m_stWeights.iLive2;
+        if (emptyEnds == 2) return m_pWeights->iLive2;
     }
 
     return count;
-}
\ No newline at end of file
+}
+
+// 显式实例化所有支持的 大小 × 规则 组合
+#define INSTANTIATE_AI(N, TRule) template class CAIPlayerT<N, TRule>; template class CAISearchTaskT<N, TRule>;
+WZQ_FOR_EACH_GAME(INSTANTIATE_AI)
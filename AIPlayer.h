@@ -3,7 +3,21 @@
 
 #include "Player.h"
 #include "Board.h"
+#include "Rules.h"
+#include "SearchControl.h"
+#include "EvalKernel.h"
+#include "AlphaBeta.h"
+#include "TransTable.h"
+#include "ForbiddenMap.h"
+#include "ThreatIndex.h"
+#include "MCTS.h"
+#include "FixedList.h"
 #include <string>
+#include <memory>
+#include <random>
+#include <vector>
+#include <mutex>
+#include <atomic>
 
 // AI的“大脑参数”
 struct AIWeights {
@@ -19,25 +33,160 @@ struct AIWeights {
     float fDefenseFactor = 1.0f; // 防守系数 (越高越怕死)
 };
 
-class CAIPlayer : public CPlayer {
+// 从文件读取一份权重 (文件不存在时返回默认值)
+AIWeights ReadAIWeights(const std::string& strFile);
+
+// 置换表默认条目数 (每条 16 字节，共 1MB)
+const size_t AI_TT_ENTRIES = 1 << 16;
+
+// 服务器上开了搜索深度的对局每手的节点预算 (深度 4~5 通常搜得完；调度器负载高时按比例收紧)
+const long long AI_SEARCH_NODES = 200000;
+
+template <int N, class TRule> class CAISearchTaskT;
+
+// AI 玩家：按棋盘大小和规则特化
+template <int N, class TRule>
+class CAIPlayerT : public CPlayerT<N> {
 public:
-    CAIPlayer(int color);
+    typedef CBoardT<N> Board;
+
+    CAIPlayerT(int color);
+
+    // [新增] 共享权重构造：多局对弈时所有 AI 共用同一份只读权重，不读写文件
+    CAIPlayerT(int color, std::shared_ptr<const AIWeights> pWeights);
+
+    virtual Point MakeMove(Board& board) override;
+
+    // [新增] 纯计算版本：不打印、不等待，供服务器的工作线程调用
+    Point SearchMove(Board& board);
+
+    // [新增] 带预算的版本：节点数/截止时间由 ctl 控制
+    Point SearchMove(Board& board, CSearchControl& ctl);
 
-    virtual Point MakeMove(CBoard& board) override;
+    // [新增] 多线程版本：再开 iThreads - 1 个线程一起跑同一个搜索任务 (Lazy SMP)
+    Point SearchMove(Board& board, CSearchControl& ctl, int iThreads);
 
     // [新增] 学习功能：根据胜负调整参数
     void Learn(bool bAiWon);
 
+    // [新增] 一次算出全盘所有空位的 EvaluatePoint 分数 (pOut[y * N + x])
+    void ScoreMap(const Board& board, int* pOut, EEvalKernel eKernel = CEvalKernel::GetBest());
+
+    // [新增] 差分校验：用指定内核算评分图，与逐格 EvaluatePoint 比对，返回不一致的空位数
+    int CheckScoreMap(Board& board, EEvalKernel eKernel);
+
+    // [新增] 搜索深度：0 为原来的一层贪心评分，>0 时用迭代加深的 Alpha-Beta 搜索
+    void SetSearchDepth(int iDepth) { m_iSearchDepth = iDepth; }
+    int GetSearchDepth() const { return m_iSearchDepth; }
+
+    // [新增] 蒙特卡洛树搜索：iPlayouts > 0 时每步最多模拟这么多盘 (优先于 Alpha-Beta)
+    void SetMCTS(int iPlayouts, EMCTSMode eMode) { m_iPlayouts = iPlayouts; m_eMCTSMode = eMode; }
+    const SMCTSStats& GetLastMCTSStats() const { return m_stLastMCTS; }
+    // [新增] MCTS 每个叶子同步模拟的盘数 (1 为逐盘模拟)
+    void SetMCTSBatch(int iLanes) { m_iMCTSBatch = iLanes; }
+
+    // [新增] 多主变例：iLines > 1 时 Alpha-Beta 搜出前 K 个走法各自的评分和主变例，
+    // 结果在 GetLastSearchStats().vecLines；落子仍取第一条线
+    void SetMultiPV(int iLines) { m_iMultiPV = iLines < 1 ? 1 : iLines; }
+    int GetMultiPV() const { return m_iMultiPV; }
+
+    // [新增] 关闭走法排序 (只用来对比节点数)
+    void SetMoveOrdering(bool bEnabled) { m_bMoveOrdering = bEnabled; }
+
+    // [新增] 搜索时用神经网络评估叶子节点；棋盘大小不符时返回 false 并保持原来的棋型评估
+    bool SetNetwork(std::shared_ptr<const CNNUENetwork> pNet);
+
+    // [新增] 上一次 Alpha-Beta 搜索的深度、节点数、首着剪枝率等
+    const SSearchStats& GetLastSearchStats() const { return m_stLastStats; }
+
+    // [新增] 置换表条目数 (向下取整到 2 的幂)，下次搜索时按这个大小分配；已分配的大小不同就丢掉重建
+    void SetTTEntries(size_t iEntries);
+    size_t GetTTBytes() const { return m_pTT ? m_pTT->GetBytes() : 0; }
+
+    // [新增] 快照：搜索设置、随机数状态和整张置换表追加到 v，末尾带这一段的 HashWords 校验和；
+    // LoadState 从 p 开始的 iBytes 字节还原，返回用掉的字节数，格式或校验和不对返回 0 (AI 保持原样)
+    // 读进来的设置按 Set 系列函数的范围截断；权重和网络是共享的，不在里面
+    void SaveState(std::vector<uint8_t>& v) const;
+    size_t LoadState(const uint8_t* p, size_t iBytes);
+
 private:
-    AIWeights m_stWeights; // 当前的权重
-    std::string m_strWeightFile; // 记忆文件路径
+    friend class CAISearchTaskT<N, TRule>;
+
+    std::shared_ptr<const AIWeights> m_pWeights; // 当前的权重 (可能与其他 AI 共享)
+    std::string m_strWeightFile; // 记忆文件路径 (为空表示不保存)
+    std::minstd_rand m_rng;      // 每个 AI 自带随机数，多线程下互不干扰 (状态只有 8 字节)
+    int m_iSearchDepth;          // 0 表示不搜索
+    int m_iMultiPV;              // 1 表示只要最佳走法
+    int m_iPlayouts;             // 0 表示不用 MCTS
+    EMCTSMode m_eMCTSMode;
+    int m_iMCTSBatch;
+    SMCTSStats m_stLastMCTS;
+    bool m_bMoveOrdering;
+    std::shared_ptr<const CNNUENetwork> m_pNetwork; // 为空表示用棋型分 (EvaluatePoint 同一套)
+    std::shared_ptr<CTransTable> m_pTT; // 第一次搜索时才分配，贪心模式不占内存
+    size_t m_iTTEntries;
+    SSearchStats m_stLastStats;
+    CForbiddenMapT<N, TRule> m_forbidden; // 执黑时的禁手点图，每次搜索前与棋盘增量对齐
+    CThreatIndexT<N, TRule> m_threats;    // 双方的四和活三，同样每次搜索前增量对齐
 
-    int EvaluatePoint(CBoard& board, int x, int y);
-    int GetLineScore(CBoard& board, int x, int y, int dx, int dy, int color);
+    int EvaluatePoint(Board& board, int x, int y);
+    int GetLineScore(Board& board, int x, int y, int dx, int dy, int color);
 
     // 文件操作
     void LoadWeights();
     void SaveWeights();
 };
 
-#endif
\ No newline at end of file
+// [新增] 一次可拆分的 AI 搜索
+// 多个工作线程可以同时调用 Run，按格子分摊；全部退出后调用 Finish 取结果
+// 开了搜索深度时改为 Lazy SMP：每个线程各跑一遍迭代加深，共享置换表，取搜得最深的结果
+// 多主变例时由第一个进入的线程搜各条线，其余线程照常单线搜索，只负责往置换表里填结果
+// MCTS 的树不加锁，只由第一个进入的线程搜索，其余线程直接返回
+template <int N, class TRule>
+class CAISearchTaskT : public CSearchTask {
+public:
+    typedef CBoardT<N> Board;
+
+    CAISearchTaskT(CAIPlayerT<N, TRule>& ai, const Board& board);
+
+    // 线程安全，可并发进入；预算用完或超时就返回
+    virtual void Run(CSearchControl& ctl) override;
+
+    // 所有 Run 返回后调用，挑选最佳点
+    virtual Point Finish() override;
+
+private:
+    CAIPlayerT<N, TRule>& m_ai;
+    Board m_board;                 // 棋盘快照，搜索期间对局可以继续被查询
+    std::atomic<int> m_atNextCell; // 下一个要分发的格子 (扫描顺序下标)
+
+    std::once_flag m_onceScores;   // 评分图只由第一个进入的线程算一次
+    int m_arrScores[N * N];
+    bool m_bForced;                // 贪心模式下有必应点 (成五、挡五、挡活三) 时只在其中挑
+    bool m_arrForced[N * N];
+
+    std::mutex m_mtx;
+    int m_iMaxScore;
+    CFixedList<Point, N * N> m_vecBest;
+
+    std::shared_ptr<const AIWeights> m_pWeights; // 搜索期间权重不会被 Learn 换掉
+    std::shared_ptr<const CNNUENetwork> m_pNetwork;
+    std::atomic<int> m_atSearchers;  // 已进入 Alpha-Beta 的线程数，决定起始深度的错开
+    SSearchStats m_stSearch;         // 各线程中搜得最深的结果
+    long long m_llSearchNodes;
+    long long m_llTTProbes;
+    long long m_llTTHits;
+    SOrderStats m_stOrderTotal;
+
+    SMCTSStats m_stMCTS;
+    unsigned m_uMCTSSeed;            // 建任务时从 AI 的随机数里取
+
+    void RunAlphaBeta(CSearchControl& ctl);
+    void RunMCTS(CSearchControl& ctl);
+};
+
+// 默认：15x15 连珠规则
+typedef CAIPlayerT<BOARD_SIZE, CRenjuRule> CAIPlayer;
+typedef CAISearchTaskT<BOARD_SIZE, CRenjuRule> CAISearchTask;
+
+#endif
@@ -0,0 +1,58 @@
+#include "AllocCounter.h"
+#include <cstdlib>
+#include <new>
+
+// 常量初始化的 thread_local，不需要构造，进程启动早期的分配也能安全计数
+static thread_local long long t_llAllocs = 0;
+
+long long CAllocCounter::GetThreadCount() {
+    return t_llAllocs;
+}
+
+void* operator new(std::size_t iSize) {
+    t_llAllocs++;
+    if (iSize == 0) iSize = 1;
+    while (true) {
+        void* p = std::malloc(iSize);
+        if (p != nullptr) return p;
+        std::new_handler pHandler = std::get_new_handler();
+        if (pHandler == nullptr) throw std::bad_alloc();
+        pHandler();
+    }
+}
+
+void* operator new[](std::size_t iSize) {
+    return operator new(iSize);
+}
+
+void* operator new(std::size_t iSize, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(iSize);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t iSize, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(iSize);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
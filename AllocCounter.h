@@ -0,0 +1,19 @@
+#ifndef _ALLOCCOUNTER_H_
+#define _ALLOCCOUNTER_H_
+
+// 堆分配计数 (测试用)：AllocCounter.cpp 替换了全局 operator new，每次分配给当前线程的计数加一
+// 用法：搜索前后各读一次 GetThreadCount，差值就是这次搜索在本线程上分配了几次 (见 --check-alloc)
+// 只统计 operator new；直接调 malloc 的 (C 库内部) 不算，CArena 的块另有 CArena::GetThreadBlockCount
+// AllocCounter.cpp 只在 CMake 选项 WZQ_ALLOC_COUNTER 打开时编进去，正式的程序不替换 operator new
+class CAllocCounter {
+public:
+#ifdef WZQ_ALLOC_COUNTER
+    static bool IsEnabled() { return true; }
+    static long long GetThreadCount();
+#else
+    static bool IsEnabled() { return false; }
+    static long long GetThreadCount() { return 0; }
+#endif
+};
+
+#endif
@@ -0,0 +1,328 @@
+#include "AlphaBeta.h"
+#include "AIPlayer.h"
+#include "Referee.h"
+#include "Trace.h"
+#include <algorithm>
+
+using namespace std;
+
+static const int SEARCH_INF = SEARCH_WIN_SCORE + 1000;
+
+// 必胜/必败分在置换表里按“距当前节点的层数”存，取出时再换回“距根的层数”
+static int ScoreToTT(int v, int ply) { return !IsMateScore(v) ? v : (v > 0 ? v + ply : v - ply); }
+static int ScoreFromTT(int v, int ply) { return !IsMateScore(v) ? v : (v > 0 ? v - ply : v + ply); }
+
+template <int N, class TRule>
+CAlphaBetaT<N, TRule>::CAlphaBetaT(const AIWeights& weights, CTransTable& tt, CSearchControl& ctl)
+    : m_weights(weights), m_tt(tt), m_ctl(ctl), m_ullHash(0), m_iStones(0), m_bAborted(false), m_llNodes(0),
+      m_llTTProbes(0), m_llTTHits(0) {
+    m_evalIn.Clear(N);
+    m_evalIn.stParams.iWin5 = weights.iWin5;
+    m_evalIn.stParams.iLive4 = weights.iLive4;
+    m_evalIn.stParams.iDash4 = weights.iDash4;
+    m_evalIn.stParams.iLive3 = weights.iLive3;
+    m_evalIn.stParams.iLive2 = weights.iLive2;
+    m_evalIn.stParams.fAttackFactor = weights.fAttackFactor;
+    m_evalIn.stParams.fDefenseFactor = weights.fDefenseFactor;
+}
+
+template <int N, class TRule>
+void CAlphaBetaT<N, TRule>::SetNetwork(const CNNUENetwork* pNet) {
+    if (pNet != nullptr && pNet->GetBoardSize() == N) m_pAcc.reset(new CNNUEAccumulator(*pNet));
+    else m_pAcc.reset();
+}
+
+template <int N, class TRule>
+void CAlphaBetaT<N, TRule>::Setup(const Board& board) {
+    m_board = board;
+    m_ullHash = 0;
+    m_iStones = 0;
+    m_evalIn.Clear(N);
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int piece = board.GetPiece(x, y);
+            m_evalIn.SetCell(x, y, (int8_t)piece);
+            if (piece == EMPTY) continue;
+            m_ullHash ^= CZobrist::Piece(piece, y * N + x);
+            m_iStones++;
+        }
+    }
+    m_forbidden.Sync(board);
+    m_threats.Sync(board);
+    if (m_pAcc) m_pAcc->Refresh(board);
+    m_orderer.Clear();
+    m_bAborted = false;
+    m_llNodes = 0;
+    m_llTTProbes = 0;
+    m_llTTHits = 0;
+    m_vecRootExcluded.clear();
+}
+
+template <int N, class TRule>
+void CAlphaBetaT<N, TRule>::FillPV(vector<Point>& vecPV) const {
+    vecPV.clear();
+    for (int i = 0; i < m_arrPVLen[0]; i++) {
+        vecPV.push_back({ m_arrPV[0][i] % N, m_arrPV[0][i] / N });
+    }
+}
+
+template <int N, class TRule>
+void CAlphaBetaT<N, TRule>::FillLine(int iScore, SSearchLine& line) const {
+    line.iScore = iScore;
+    line.stMove.iX = m_arrPV[0][0] % N;
+    line.stMove.iY = m_arrPV[0][0] / N;
+    FillPV(line.vecPV);
+}
+
+template <int N, class TRule>
+SSearchStats CAlphaBetaT<N, TRule>::Search(const Board& board, int color, int iMaxDepth, int iStartDepth) {
+    SSearchStats stats;
+    Search(board, color, iMaxDepth, iStartDepth, stats);
+    return stats;
+}
+
+template <int N, class TRule>
+void CAlphaBetaT<N, TRule>::Search(const Board& board, int color, int iMaxDepth, int iStartDepth, SSearchStats& stats) {
+    Setup(board);
+    if (iMaxDepth > SEARCH_MAX_PLY - 1) iMaxDepth = SEARCH_MAX_PLY - 1;
+    if (iStartDepth < 1) iStartDepth = 1;
+    if (iStartDepth > iMaxDepth) iStartDepth = iMaxDepth;
+
+    stats.Clear();
+    for (int depth = iStartDepth; depth <= iMaxDepth; depth++) {
+        WZQ_TRACE_SCOPE("search.depth", "search");
+        int v = Negamax(depth, 0, -SEARCH_INF, SEARCH_INF, color);
+        if (m_bAborted) break; // 没搜完的这一层不可信，用上一层的结果
+        if (m_arrPVLen[0] == 0) break; // 没有合法走法
+
+        stats.iDepth = depth;
+        stats.iScore = v;
+        stats.stMove.iX = m_arrPV[0][0] % N;
+        stats.stMove.iY = m_arrPV[0][0] / N;
+        FillPV(stats.vecPV);
+        // 已经算出胜负，再加深也不会变
+        if (IsMateScore(v)) break;
+    }
+    stats.llNodes = m_llNodes;
+    stats.llTTProbes = m_llTTProbes;
+    stats.llTTHits = m_llTTHits;
+    stats.stOrder = m_orderer.GetStats();
+}
+
+template <int N, class TRule>
+SSearchStats CAlphaBetaT<N, TRule>::SearchMultiPV(const Board& board, int color, int iMaxDepth, int iLines) {
+    Setup(board);
+    if (iMaxDepth > SEARCH_MAX_PLY - 1) iMaxDepth = SEARCH_MAX_PLY - 1;
+    if (iLines < 1) iLines = 1;
+
+    SSearchStats stats;
+    vector<SSearchLine> vecLines;
+    for (int depth = 1; depth <= iMaxDepth; depth++) {
+        WZQ_TRACE_SCOPE("search.depth", "search");
+        vecLines.clear();
+        m_vecRootExcluded.clear();
+        for (int k = 0; k < iLines; k++) {
+            int v = Negamax(depth, 0, -SEARCH_INF, SEARCH_INF, color);
+            if (m_bAborted || m_arrPVLen[0] == 0) break; // 超时，或者根节点已经没有别的走法
+            vecLines.push_back(SSearchLine());
+            FillLine(v, vecLines.back());
+            m_vecRootExcluded.push_back(m_arrPV[0][0]);
+        }
+        m_vecRootExcluded.clear();
+        if (m_bAborted || vecLines.empty()) break; // 没搜完的这一层不可信，用上一层的结果
+
+        // 排除法搜出来的分数本身就是递减的，只有置换表里不同深度的结果混进来时才会乱序
+        stable_sort(vecLines.begin(), vecLines.end(),
+                    [](const SSearchLine& a, const SSearchLine& b) { return a.iScore > b.iScore; });
+        stats.iDepth = depth;
+        stats.iScore = vecLines[0].iScore;
+        stats.stMove = vecLines[0].stMove;
+        stats.vecPV = vecLines[0].vecPV;
+        stats.vecLines = vecLines;
+
+        // 每条线都已经算出胜负，再加深也不会变
+        bool bAllMate = true;
+        for (size_t i = 0; i < vecLines.size(); i++) {
+            if (!IsMateScore(vecLines[i].iScore)) bAllMate = false;
+        }
+        if (bAllMate) break;
+    }
+    stats.llNodes = m_llNodes;
+    stats.llTTProbes = m_llTTProbes;
+    stats.llTTHits = m_llTTHits;
+    stats.stOrder = m_orderer.GetStats();
+    return stats;
+}
+
+template <int N, class TRule>
+int CAlphaBetaT<N, TRule>::Negamax(int depth, int ply, int alpha, int beta, int color) {
+    m_arrPVLen[ply] = 0;
+    if (!m_ctl.CountNode()) {
+        m_bAborted = true;
+        return 0;
+    }
+    m_llNodes++;
+
+    if (depth == 0 || ply >= SEARCH_MAX_PLY - 1) return Evaluate(color);
+
+    int enemy = (color == BLACK) ? WHITE : BLACK;
+    uint64_t ullKey = m_ullHash ^ (color == WHITE ? CZobrist::WhiteToMove() : 0);
+
+    int iTTMove = -1;
+    STTEntry entry;
+    bool bHit;
+    {
+        WZQ_TRACE_DETAIL("tt.probe", "tt");
+        bHit = m_tt.Probe(ullKey, &entry);
+    }
+    m_llTTProbes++;
+    if (bHit) {
+        m_llTTHits++;
+        iTTMove = entry.iMove;
+        // 根节点不直接返回，保证总能拿到主变例
+        if (ply > 0 && entry.iDepth >= depth) {
+            int v = ScoreFromTT(entry.iValue, ply);
+            if (entry.iBound == TT_EXACT) return v;
+            if (entry.iBound == TT_LOWER && v >= beta) return v;
+            if (entry.iBound == TT_UPPER && v <= alpha) return v;
+        }
+    }
+
+    CMoveListT<N> vecMoves; // 放在栈上，递归时不分配堆内存
+    GenerateMoves(color, vecMoves);
+    if (vecMoves.empty()) return 0; // 棋盘下满或只剩禁手点，按和棋算
+    m_orderer.Order(m_board, color, ply, iTTMove, vecMoves);
+
+    int alphaOrig = alpha;
+    int best = -SEARCH_INF;
+    int bestMove = -1;
+    for (int i = 0; i < vecMoves.size(); i++) {
+        int iCell = vecMoves[i];
+        int x = iCell % N, y = iCell / N;
+        if (ply == 0 && !m_vecRootExcluded.empty() &&
+            find(m_vecRootExcluded.begin(), m_vecRootExcluded.end(), iCell) != m_vecRootExcluded.end()) {
+            continue;
+        }
+
+        Place(iCell, color);
+        int v;
+        if (CRefereeT<N, TRule>::CheckWin(m_board, x, y)) {
+            v = SEARCH_WIN_SCORE - (ply + 1);
+            m_arrPVLen[ply + 1] = 0;
+        } else {
+            v = -Negamax(depth - 1, ply + 1, -beta, -alpha, enemy);
+        }
+        Undo(iCell, color);
+        if (m_bAborted) return 0;
+
+        if (v > best) {
+            best = v;
+            bestMove = iCell;
+            if (v > alpha) {
+                alpha = v;
+                m_arrPV[ply][0] = iCell;
+                for (int k = 0; k < m_arrPVLen[ply + 1]; k++) m_arrPV[ply][k + 1] = m_arrPV[ply + 1][k];
+                m_arrPVLen[ply] = m_arrPVLen[ply + 1] + 1;
+            }
+        }
+        if (alpha >= beta) {
+            m_orderer.OnCutoff(color, ply, iCell, depth, i);
+            break;
+        }
+    }
+
+    int iBound = TT_EXACT;
+    if (best <= alphaOrig) iBound = TT_UPPER;
+    else if (best >= beta) iBound = TT_LOWER;
+    // 排除了部分根走法时的根结果不代表这个局面，不写进置换表
+    if (bestMove < 0) return best;
+    if (ply > 0 || m_vecRootExcluded.empty()) m_tt.Store(ullKey, ScoreToTT(best, ply), depth, iBound, bestMove);
+    return best;
+}
+
+// 局面评估 (站在 color 的角度)
+// 有网络时直接用累加器前向一次；否则取双方各自最好的一个落点的棋型分之差
+template <int N, class TRule>
+int CAlphaBetaT<N, TRule>::Evaluate(int color) {
+    if (m_pAcc) return m_pAcc->Evaluate(color);
+
+    int enemy = (color == BLACK) ? WHITE : BLACK;
+    m_evalIn.iMyColor = (int8_t)color;
+    m_evalIn.iEnemyColor = (int8_t)enemy;
+    m_evalIn.stParams.bMyExactFive = (color == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+    m_evalIn.stParams.bEnemyExactFive = (enemy == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+    CEvalKernel::LineSums(m_evalIn, m_arrMySums, m_arrEnemySums);
+
+    int maxMy = 0, maxEnemy = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            if (!m_board.IsEmpty(x, y)) continue;
+            maxMy = max(maxMy, m_arrMySums[y * N + x]);
+            maxEnemy = max(maxEnemy, m_arrEnemySums[y * N + x]);
+        }
+    }
+    return (int)(maxMy * m_weights.fAttackFactor) - (int)(maxEnemy * m_weights.fDefenseFactor);
+}
+
+// 候选走法：已有棋子周围两格内的空位 (行优先)；空棋盘只下天元
+// 黑棋的禁手点直接不生成 (成五的点不在禁手图里，照常生成)
+// 自己能成五只走成五点，对方能成五只走挡点 (威胁索引直接查)；挡点全是禁手时照常生成，反正已经输了
+template <int N, class TRule>
+void CAlphaBetaT<N, TRule>::GenerateMoves(int color, CMoveListT<N>& vecMoves) {
+    if (m_threats.GetForcedMoves(color, false, vecMoves)) {
+        int iKeep = 0;
+        for (int i = 0; i < vecMoves.size(); i++) {
+            int iCell = vecMoves[i];
+            if (color == BLACK && m_forbidden.IsForbidden(iCell % N, iCell / N)) continue;
+            vecMoves[iKeep++] = iCell;
+        }
+        vecMoves.resize(iKeep);
+        if (!vecMoves.empty()) return;
+    }
+
+    vecMoves.clear();
+    if (m_iStones == 0) {
+        vecMoves.push_back((N / 2) * N + N / 2);
+        return;
+    }
+
+    bool arrNear[N * N] = {};
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            if (m_board.IsEmpty(x, y)) continue;
+            for (int ny = max(0, y - 2); ny <= min(N - 1, y + 2); ny++) {
+                for (int nx = max(0, x - 2); nx <= min(N - 1, x + 2); nx++) arrNear[ny * N + nx] = true;
+            }
+        }
+    }
+    for (int i = 0; i < N * N; i++) {
+        if (!arrNear[i] || !m_board.IsEmpty(i % N, i / N)) continue;
+        if (color == BLACK && m_forbidden.IsForbidden(i % N, i / N)) continue;
+        vecMoves.push_back(i);
+    }
+}
+
+template <int N, class TRule>
+void CAlphaBetaT<N, TRule>::Place(int iCell, int color) {
+    m_board.PlacePiece(iCell % N, iCell / N, color);
+    m_evalIn.SetCell(iCell % N, iCell / N, (int8_t)color);
+    m_ullHash ^= CZobrist::Piece(color, iCell);
+    m_forbidden.Place(iCell % N, iCell / N, color);
+    m_threats.Place(iCell % N, iCell / N, color);
+    if (m_pAcc) m_pAcc->Add(color, iCell);
+    m_iStones++;
+}
+
+template <int N, class TRule>
+void CAlphaBetaT<N, TRule>::Undo(int iCell, int color) {
+    m_board.UndoPiece(iCell % N, iCell / N);
+    m_evalIn.SetCell(iCell % N, iCell / N, (int8_t)EMPTY);
+    m_ullHash ^= CZobrist::Piece(color, iCell);
+    m_forbidden.Undo(iCell % N, iCell / N);
+    m_threats.Undo(iCell % N, iCell / N);
+    if (m_pAcc) m_pAcc->Remove(color, iCell);
+    m_iStones--;
+}
+
+#define INSTANTIATE_ALPHABETA(N, TRule) template class CAlphaBetaT<N, TRule>;
+WZQ_FOR_EACH_GAME(INSTANTIATE_ALPHABETA)
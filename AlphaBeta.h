@@ -0,0 +1,116 @@
+#ifndef _ALPHABETA_H_
+#define _ALPHABETA_H_
+
+#include "Board.h"
+#include "Rules.h"
+#include "MoveOrder.h"
+#include "ForbiddenMap.h"
+#include "ThreatIndex.h"
+#include "TransTable.h"
+#include "SearchControl.h"
+#include "EvalKernel.h"
+#include "NNUE.h"
+#include <memory>
+#include <vector>
+
+struct AIWeights;
+
+// 必胜分：赢得越快分越高 (WIN_SCORE - 层数)
+const int SEARCH_WIN_SCORE = 10000000;
+
+// 分数是否表示已经算出胜负
+inline bool IsMateScore(int v) { return v > SEARCH_WIN_SCORE - 2 * SEARCH_MAX_PLY || v < -(SEARCH_WIN_SCORE - 2 * SEARCH_MAX_PLY); }
+
+// 多主变例分析里的一条线
+struct SSearchLine {
+    Point stMove;
+    int iScore;
+    std::vector<Point> vecPV;
+};
+
+// 一次搜索的结果和统计
+struct SSearchStats {
+    Point stMove;          // 最佳走法；iX < 0 表示一层都没搜完
+    int iScore;
+    int iDepth;            // 完整搜完的深度
+    long long llNodes;
+    long long llTTProbes;  // 置换表查询次数 (每个搜索实例自己数，多线程时各自加总)
+    long long llTTHits;
+    SOrderStats stOrder;
+    std::vector<Point> vecPV; // 主变例
+    std::vector<SSearchLine> vecLines; // 多主变例时按分数从高到低的前 K 条；单主变例时为空
+
+    SSearchStats() { Clear(); }
+
+    // 清空结果，保留主变例的容量 (反复搜索时不再分配)
+    void Clear() {
+        stMove.iX = -1; stMove.iY = -1;
+        iScore = 0; iDepth = 0; llNodes = 0; llTTProbes = 0; llTTHits = 0;
+        stOrder.llCutoffs = 0; stOrder.llFirstCutoffs = 0;
+        vecPV.clear();
+        vecLines.clear();
+    }
+};
+
+// 迭代加深的负极大值 Alpha-Beta 搜索
+// 置换表可以被多个线程的搜索共享 (Lazy SMP)，其余状态每个实例一份
+template <int N, class TRule>
+class CAlphaBetaT {
+public:
+    typedef CBoardT<N> Board;
+
+    CAlphaBetaT(const AIWeights& weights, CTransTable& tt, CSearchControl& ctl);
+
+    // 关闭走法排序 (对比节点数用)
+    void SetOrdering(bool bEnabled) { m_orderer.SetEnabled(bEnabled); }
+
+    // 用神经网络评估叶子节点 (棋盘大小必须是 N)；传空指针退回棋型分评估
+    void SetNetwork(const CNNUENetwork* pNet);
+
+    // 从 iStartDepth 加深到 iMaxDepth；超时或预算用完时返回最后一次完整搜完的结果
+    SSearchStats Search(const Board& board, int color, int iMaxDepth, int iStartDepth = 1);
+    // 同上，结果写进调用方的 stats：复用同一个 stats 反复搜索时，整个搜索不分配堆内存
+    void Search(const Board& board, int color, int iMaxDepth, int iStartDepth, SSearchStats& stats);
+
+    // 多主变例：每层依次搜 K 遍根节点，第 i 遍排除前面已选出的 i-1 个根走法，
+    // 各遍共用同一棵树的置换表和排序历史，后几遍大部分子树直接命中
+    // 结果的 stMove/iScore/vecPV 是第一条线，vecLines 是完整搜完的最深一层的各条线
+    SSearchStats SearchMultiPV(const Board& board, int color, int iMaxDepth, int iLines);
+
+private:
+    const AIWeights& m_weights;
+    CTransTable& m_tt;
+    CSearchControl& m_ctl;
+    CMoveOrdererT<N, TRule> m_orderer;
+    CForbiddenMapT<N, TRule> m_forbidden; // 随 Place/Undo 增量维护，黑棋生成走法时直接跳过禁手点
+    CThreatIndexT<N, TRule> m_threats;    // 同上；有人能成五时只生成成五/挡五的点
+
+    Board m_board;
+    uint64_t m_ullHash;
+    int m_iStones;
+    bool m_bAborted;
+    long long m_llNodes;
+    long long m_llTTProbes;
+    long long m_llTTHits;
+    CMoveListT<N> m_vecRootExcluded; // 多主变例时根节点跳过的走法
+
+    // 三角形主变例表
+    int m_arrPV[SEARCH_MAX_PLY][SEARCH_MAX_PLY];
+    int m_arrPVLen[SEARCH_MAX_PLY];
+
+    std::unique_ptr<CNNUEAccumulator> m_pAcc; // 有网络时随 Place/Undo 增量更新
+    SEvalInput m_evalIn;
+    int m_arrMySums[N * N];
+    int m_arrEnemySums[N * N];
+
+    void Setup(const Board& board);
+    void FillPV(std::vector<Point>& vecPV) const;
+    void FillLine(int iScore, SSearchLine& line) const;
+    int Negamax(int depth, int ply, int alpha, int beta, int color);
+    int Evaluate(int color);
+    void GenerateMoves(int color, CMoveListT<N>& vecMoves);
+    void Place(int iCell, int color);
+    void Undo(int iCell, int color);
+};
+
+#endif
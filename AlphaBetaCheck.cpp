@@ -0,0 +1,104 @@
+#include "AlphaBeta.h"
+#include "Checks.h"
+#include "AIPlayer.h"
+#include "Board.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+// 走法排序对比：WuZiQiDemo --bench-search [深度] [局面数]
+// 用贪心 AI 自对弈摆出中局，同样深度下分别开/关走法排序搜索，比较节点数和首着剪枝率
+int RunSearchBench(int argc, char* argv[]) {
+    int iDepth = (argc > 2) ? atoi(argv[2]) : 4;
+    int iPositions = (argc > 3) ? atoi(argv[3]) : 8;
+    shared_ptr<const AIWeights> pWeights = make_shared<AIWeights>();
+
+    long long arrNodes[2] = { 0, 0 };
+    long long arrProbes[2] = { 0, 0 }, arrHits[2] = { 0, 0 };
+    SOrderStats arrOrder[2] = { { 0, 0 }, { 0, 0 } };
+    for (int i = 0; i < iPositions; i++) {
+        CBoard board;
+        CAIPlayer black(BLACK, pWeights), white(WHITE, pWeights);
+        board.PlacePiece(BOARD_SIZE / 2, BOARD_SIZE / 2, BLACK);
+        board.PlacePiece(BOARD_SIZE / 2 + 1 - i % 3, BOARD_SIZE / 2 + 1, WHITE);
+        int iPlies = 4 + 2 * (i % 4);
+        for (int k = 0; k < iPlies; k++) {
+            CAIPlayer& ai = (k % 2 == 0) ? black : white;
+            Point p = ai.SearchMove(board);
+            board.PlacePiece(p.iX, p.iY, (k % 2 == 0) ? BLACK : WHITE);
+        }
+
+        for (int k = 0; k < 2; k++) {
+            CAIPlayer ai(BLACK, pWeights);
+            ai.SetSearchDepth(iDepth);
+            ai.SetMoveOrdering(k == 0);
+            ai.SearchMove(board);
+            const SSearchStats& st = ai.GetLastSearchStats();
+            arrNodes[k] += st.llNodes;
+            arrProbes[k] += st.llTTProbes;
+            arrHits[k] += st.llTTHits;
+            arrOrder[k].llCutoffs += st.stOrder.llCutoffs;
+            arrOrder[k].llFirstCutoffs += st.stOrder.llFirstCutoffs;
+        }
+    }
+
+    cout << "深度 " << iDepth << ", " << iPositions << " 个局面" << endl;
+    const char* arrNames[] = { "排序开", "排序关" };
+    for (int k = 0; k < 2; k++) {
+        cout << " " << arrNames[k] << ": 节点 " << arrNodes[k]
+             << "  首着剪枝率 " << (int)(arrOrder[k].GetFirstCutoffRate() * 100) << "%"
+             << "  置换表命中率 " << (arrProbes[k] > 0 ? (int)(arrHits[k] * 100 / arrProbes[k]) : 0) << "%" << endl;
+    }
+    return 0;
+}
+
+// 多主变例的额外开销：WuZiQiDemo --bench-multipv [K] [深度] [局面数]
+// 局面与 --bench-search 相同；同样深度下各用新置换表搜单主变例和前 K 条，比较节点数和用时
+int RunMultiPVBench(int argc, char* argv[]) {
+    int iLines = (argc > 2) ? atoi(argv[2]) : 3;
+    int iDepth = (argc > 3) ? atoi(argv[3]) : 4;
+    int iPositions = (argc > 4) ? atoi(argv[4]) : 8;
+    if (iLines < 2) iLines = 2;
+    shared_ptr<const AIWeights> pWeights = make_shared<AIWeights>();
+
+    long long arrNodes[2] = { 0, 0 };
+    double arrSeconds[2] = { 0, 0 };
+    int iShortLines = 0; // 根节点可选走法不足 K 个的局面
+    for (int i = 0; i < iPositions; i++) {
+        CBoard board;
+        CAIPlayer black(BLACK, pWeights), white(WHITE, pWeights);
+        board.PlacePiece(BOARD_SIZE / 2, BOARD_SIZE / 2, BLACK);
+        board.PlacePiece(BOARD_SIZE / 2 + 1 - i % 3, BOARD_SIZE / 2 + 1, WHITE);
+        int iPlies = 4 + 2 * (i % 4);
+        for (int k = 0; k < iPlies; k++) {
+            CAIPlayer& ai = (k % 2 == 0) ? black : white;
+            Point p = ai.SearchMove(board);
+            board.PlacePiece(p.iX, p.iY, (k % 2 == 0) ? BLACK : WHITE);
+        }
+
+        for (int k = 0; k < 2; k++) {
+            CAIPlayer ai(BLACK, pWeights);
+            ai.SetSearchDepth(iDepth);
+            ai.SetMultiPV(k == 0 ? 1 : iLines);
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            ai.SearchMove(board);
+            arrSeconds[k] += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            const SSearchStats& st = ai.GetLastSearchStats();
+            arrNodes[k] += st.llNodes;
+            if (k == 1 && (int)st.vecLines.size() < iLines) iShortLines++;
+        }
+    }
+
+    cout << "深度 " << iDepth << ", " << iPositions << " 个局面, K = " << iLines << endl;
+    cout << " 单主变例: 节点 " << arrNodes[0] << "  用时 " << arrSeconds[0] << "s" << endl;
+    cout << " 前 " << iLines << " 条: 节点 " << arrNodes[1] << "  用时 " << arrSeconds[1] << "s" << endl;
+    if (arrNodes[0] > 0 && arrSeconds[0] > 0) {
+        cout << " 开销: 节点 x" << (double)arrNodes[1] / arrNodes[0] << "  用时 x" << arrSeconds[1] / arrSeconds[0]
+             << " (独立搜 K 遍约为 x" << iLines << ")" << endl;
+    }
+    if (iShortLines > 0) cout << " 其中 " << iShortLines << " 个局面可选走法不足 " << iLines << " 个 (必应)" << endl;
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "Arena.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+static thread_local long long t_llBlockAllocs = 0;
+
+CArena::CArena(size_t iBlockSize) : m_iBlock(0), m_iUsed(0), m_iBlockSize(iBlockSize) {}
+
+CArena::~CArena() {
+    for (size_t i = 0; i < m_vecBlocks.size(); i++) free(m_vecBlocks[i].pData);
+}
+
+void* CArena::Allocate(size_t iBytes, size_t iAlign) {
+    while (true) {
+        if (m_iBlock < (int)m_vecBlocks.size()) {
+            SBlock& block = m_vecBlocks[m_iBlock];
+            // 按块内偏移对齐：块本身来自 malloc，已经按最大基本类型对齐
+            size_t iStart = (m_iUsed + iAlign - 1) & ~(iAlign - 1);
+            if (iStart + iBytes <= block.iSize) {
+                m_iUsed = iStart + iBytes;
+                return block.pData + iStart;
+            }
+            // 这一块剩下的不够，换下一块 (剩下的零头浪费掉)；整块都装不下就在这里插一块大的
+            if (m_iUsed > 0) {
+                m_iBlock++;
+                m_iUsed = 0;
+                continue;
+            }
+        }
+
+        // 后面没有块了，或者这一块太小：插一块新的，原来的往后挪
+        SBlock block;
+        block.iSize = max(m_iBlockSize, iBytes + iAlign);
+        block.pData = static_cast<char*>(malloc(block.iSize));
+        if (block.pData == nullptr) throw bad_alloc();
+        t_llBlockAllocs++;
+        m_vecBlocks.insert(m_vecBlocks.begin() + m_iBlock, block);
+        m_iUsed = 0;
+    }
+}
+
+size_t CArena::GetReserved() const {
+    size_t iTotal = 0;
+    for (size_t i = 0; i < m_vecBlocks.size(); i++) iTotal += m_vecBlocks[i].iSize;
+    return iTotal;
+}
+
+long long CArena::GetThreadBlockCount() {
+    return t_llBlockAllocs;
+}
+
+CArena& CArena::ForThread() {
+    static thread_local CArena s_arena;
+    return s_arena;
+}
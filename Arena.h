@@ -0,0 +1,77 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// 每块默认 1MB
+const size_t ARENA_BLOCK_SIZE = (size_t)1 << 20;
+
+// 线性分配器 (bump arena)：从大块内存里顺序往后切，不能单独释放，只能整体回退到之前记下的位置
+// 块用完了才向系统再要一块，回退时块留着下次接着用：第一次搜索把块撑够，之后同样规模的搜索不再碰堆
+// 每个线程一份 (ForThread)，不加锁；搜索开头放一个 CArenaScope，搜完整体回退
+class CArena {
+public:
+    // 回退点
+    struct SMark {
+        int iBlock;
+        size_t iUsed;
+    };
+
+    explicit CArena(size_t iBlockSize = ARENA_BLOCK_SIZE);
+    ~CArena();
+
+    // iAlign 必须是 2 的幂
+    void* Allocate(size_t iBytes, size_t iAlign = 16);
+
+    // 元素不构造也不析构，只能放 POD
+    template <class T>
+    T* AllocateArray(size_t iCount) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena arrays are never destroyed");
+        return static_cast<T*>(Allocate(sizeof(T) * iCount, alignof(T)));
+    }
+
+    SMark GetMark() const { SMark mark = { m_iBlock, m_iUsed }; return mark; }
+    void Rewind(const SMark& mark) { m_iBlock = mark.iBlock; m_iUsed = mark.iUsed; }
+    void Reset() { m_iBlock = 0; m_iUsed = 0; }
+
+    // 已经向系统要的总字节数
+    size_t GetReserved() const;
+
+    // 当前线程上所有分配器累计向系统要块的次数 (--check-alloc 用它确认热身之后不再长块)
+    static long long GetThreadBlockCount();
+
+    // 当前线程的分配器
+    static CArena& ForThread();
+
+private:
+    struct SBlock {
+        char* pData;
+        size_t iSize;
+    };
+
+    std::vector<SBlock> m_vecBlocks;
+    int m_iBlock;     // 正在切的块
+    size_t m_iUsed;   // 这一块已经切掉的字节
+    size_t m_iBlockSize;
+
+    CArena(const CArena&);
+    CArena& operator=(const CArena&);
+};
+
+// 作用域回退：构造时记下位置，析构时退回去，作用域里分配的东西一起作废
+class CArenaScope {
+public:
+    explicit CArenaScope(CArena& arena) : m_arena(arena), m_stMark(arena.GetMark()) {}
+    ~CArenaScope() { m_arena.Rewind(m_stMark); }
+
+private:
+    CArena& m_arena;
+    CArena::SMark m_stMark;
+
+    CArenaScope(const CArenaScope&);
+    CArenaScope& operator=(const CArenaScope&);
+};
+
+#endif
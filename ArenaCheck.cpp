@@ -0,0 +1,121 @@
+#include "Arena.h"
+#include "Checks.h"
+#include "AIPlayer.h"
+#include "AllocCounter.h"
+#include "AlphaBeta.h"
+#include "Board.h"
+#include "MCTS.h"
+#include "ProofSolver.h"
+#include "Rules.h"
+#include "SearchControl.h"
+#include "TransTable.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+// 堆分配自检：WuZiQiDemo --check-alloc [深度] [局面数]
+// 贪心自对弈摆出局面，Alpha-Beta / 证明数 / MCTS / 贪心各在同一局面上先搜一遍热身
+// (撑大线程分配器的块和结果的容量)，清空置换表后再搜一遍：第二遍在本线程上的 operator new 次数
+// 加上线程分配器新要的块数必须为 0；需要用 -DWZQ_ALLOC_COUNTER=ON 配置的构建
+enum { ALLOC_ALPHABETA = 0, ALLOC_PROOF, ALLOC_MCTS, ALLOC_GREEDY, ALLOC_ENGINES };
+
+static long long CountAllocations() {
+    return CAllocCounter::GetThreadCount() + CArena::GetThreadBlockCount();
+}
+
+template <int N, class TRule>
+static void CheckAllocations(int iDepth, int iPositions, long long* arrAllocs, long long* arrWarmup) {
+    shared_ptr<const AIWeights> pWeights = make_shared<AIWeights>();
+    for (int i = 0; i < iPositions; i++) {
+        CBoardT<N> board;
+        CAIPlayerT<N, TRule> black(BLACK, pWeights), white(WHITE, pWeights);
+        board.PlacePiece(N / 2, N / 2, BLACK);
+        int color = WHITE;
+        for (int k = 0; k < 5 + 2 * i; k++) {
+            Point p = (color == BLACK ? black : white).SearchMove(board);
+            board.PlacePiece(p.iX, p.iY, color);
+            color = 3 - color;
+        }
+
+        CTransTable tt(AI_TT_ENTRIES);
+        CSearchControl ctlSearch = CSearchControl::Unlimited();
+        CAlphaBetaT<N, TRule> search(*pWeights, tt, ctlSearch);
+        SSearchStats stats;
+        CProofSolverT<N, TRule> solver((size_t)4 << 20);
+        SProofResult proof;
+        CAIPlayerT<N, TRule> greedy(color, pWeights);
+
+        // 第一遍热身，只记第二遍
+        for (int pass = 0; pass < 2; pass++) {
+            long long* arrCount = (pass == 1) ? arrAllocs : arrWarmup;
+            long long llBefore;
+
+            tt.Clear();
+            llBefore = CountAllocations();
+            search.Search(board, color, iDepth, 1, stats);
+            arrCount[ALLOC_ALPHABETA] += CountAllocations() - llBefore;
+
+            solver.Clear();
+            CSearchControl ctlProof(CSearchControl::Clock::time_point::max(), 20000, 1);
+            llBefore = CountAllocations();
+            solver.Solve(board, color, ctlProof, proof);
+            arrCount[ALLOC_PROOF] += CountAllocations() - llBefore;
+
+            CMCTST<N, TRule> mcts(*pWeights, MCTS_PUCT, 7 + i);
+            CSearchControl ctlMCTS = CSearchControl::Unlimited();
+            llBefore = CountAllocations();
+            mcts.Search(board, color, 300, ctlMCTS);
+            arrCount[ALLOC_MCTS] += CountAllocations() - llBefore;
+
+            llBefore = CountAllocations();
+            greedy.SearchMove(board);
+            arrCount[ALLOC_GREEDY] += CountAllocations() - llBefore;
+        }
+    }
+}
+
+struct SAllocChecker {
+    typedef int ResultType;
+    int iDepth;
+    int iPositions;
+    long long* arrAllocs;
+    long long* arrWarmup;
+
+    template <int N, class TRule>
+    int Run() {
+        CheckAllocations<N, TRule>(iDepth, iPositions, arrAllocs, arrWarmup);
+        return 0;
+    }
+};
+
+int RunAllocCheck(int argc, char* argv[]) {
+    if (!CAllocCounter::IsEnabled()) {
+        cout << "--check-alloc 需要替换 operator new：用 cmake -DWZQ_ALLOC_COUNTER=ON 重新配置后再编译" << endl;
+        return 1;
+    }
+    int iDepth = (argc > 2) ? atoi(argv[2]) : 4;
+    int iPositions = (argc > 3) ? atoi(argv[3]) : 2;
+
+    const int arrSizes[] = { 15, 19, 20 };
+    const int arrRules[] = { RULE_RENJU, RULE_STANDARD, RULE_FREESTYLE };
+    long long arrAllocs[ALLOC_ENGINES] = {}, arrWarmup[ALLOC_ENGINES] = {};
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            SAllocChecker checker = { iDepth, iPositions, arrAllocs, arrWarmup };
+            DispatchGame(arrSizes[i], arrRules[j], checker);
+        }
+    }
+
+    long long llTotal = 0;
+    for (int k = 0; k < ALLOC_ENGINES; k++) llTotal += arrAllocs[k];
+    const char* arrNames[ALLOC_ENGINES] = { "Alpha-Beta", "证明数", "MCTS", "贪心" };
+    cout << (llTotal == 0 ? "[通过]" : "[失败]") << " 9 种组合 x " << iPositions << " 个局面, 深度 " << iDepth
+         << ", 线程分配器占用 " << CArena::ForThread().GetReserved() / 1024 << " KB" << endl;
+    for (int k = 0; k < ALLOC_ENGINES; k++) {
+        cout << " " << arrNames[k] << ": 热身 " << arrWarmup[k] << " 次分配, 之后 " << arrAllocs[k] << " 次" << endl;
+    }
+    return llTotal == 0 ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+#include "BatchPlayout.h"
+#include "Referee.h"
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// 最低位的 1 是第几位 (ullBits 不为 0)
+static inline int LowestLane(uint64_t ullBits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(ullBits);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long iIndex;
+    _BitScanForward64(&iIndex, ullBits);
+    return (int)iIndex;
+#else
+    int i = 0;
+    while (!(ullBits & 1)) { ullBits >>= 1; i++; }
+    return i;
+#endif
+}
+
+// 沿步长 S 的一个方向：b[i] 起连续五格都有子的盘
+// EXACT 时两头外侧一格也不能是己方子 (否则是长连)；棋盘外的格子都是 0，不用判边界
+template <int S, bool EXACT>
+static inline uint64_t LineFiveMask(const uint64_t* b, int iFrom, int iTo) {
+    uint64_t ullWin = 0;
+    for (int i = iFrom; i < iTo; i++) {
+        uint64_t m = b[i] & b[i + S] & b[i + 2 * S] & b[i + 3 * S] & b[i + 4 * S];
+        if (EXACT) m &= ~(b[i - S] | b[i + 5 * S]);
+        ullWin |= m;
+    }
+    return ullWin;
+}
+
+template <int N, class TRule>
+CBatchPlayoutT<N, TRule>::CBatchPlayoutT() {
+    memset(m_arrStones, 0, sizeof(m_arrStones));
+    memset(m_arrInSet, 0, sizeof(m_arrInSet));
+    memset(m_arrCandCount, 0, sizeof(m_arrCandCount));
+    memset(m_arrMoveCount, 0, sizeof(m_arrMoveCount));
+}
+
+template <int N, class TRule>
+template <bool EXACT>
+uint64_t CBatchPlayoutT<N, TRule>::FiveMask(int c) const {
+    const uint64_t* b = m_arrStones[c];
+    int iFrom = ORIGIN, iTo = ORIGIN + N * P;
+    return LineFiveMask<1, EXACT>(b, iFrom, iTo) | LineFiveMask<P, EXACT>(b, iFrom, iTo) |
+           LineFiveMask<P + 1, EXACT>(b, iFrom, iTo) | LineFiveMask<P - 1, EXACT>(b, iFrom, iTo);
+}
+
+template <int N, class TRule>
+uint64_t CBatchPlayoutT<N, TRule>::FiveMaskFor(int color) const {
+    bool bExact = (color == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+    return bExact ? FiveMask<true>(color - 1) : FiveMask<false>(color - 1);
+}
+
+template <int N, class TRule>
+void CBatchPlayoutT<N, TRule>::Run(const Board& board, int color, int iLanes, minstd_rand& rng, int8_t* arrWinners) {
+    if (iLanes < 1) iLanes = 1;
+    if (iLanes > MAX_LANES) iLanes = MAX_LANES;
+    uint64_t ullLanes = (iLanes == MAX_LANES) ? ~0ULL : ((1ULL << iLanes) - 1);
+    for (int j = 0; j < iLanes; j++) {
+        arrWinners[j] = EMPTY;
+        m_arrMoveCount[j] = 0;
+    }
+
+    // 起始局面：棋子和棋盘外的格子都算“已进候选”，之后只有空位会被加入
+    memset(m_arrStones, 0, sizeof(m_arrStones));
+    for (int i = 0; i < CELLS; i++) m_arrInSet[i] = ~0ULL;
+    int iEmpty = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int piece = board.GetPiece(x, y);
+            int idx = ORIGIN + y * P + x;
+            if (piece == EMPTY) {
+                m_arrInSet[idx] = 0;
+                iEmpty++;
+            } else {
+                m_arrStones[piece - 1][idx] = ullLanes;
+            }
+        }
+    }
+    for (int c = 0; c < 2; c++) {
+        if (FiveMaskFor(c + 1) == 0) continue;
+        for (int j = 0; j < iLanes; j++) arrWinners[j] = (int8_t)(c + 1);
+        return;
+    }
+
+    // 各盘的初始候选相同：算一次再复制
+    static const int arrNear[8] = { -P - 1, -P, -P + 1, -1, 1, P - 1, P, P + 1 };
+    int16_t arrInit[N * N];
+    int iInit = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int idx = ORIGIN + y * P + x;
+            if ((m_arrStones[0][idx] | m_arrStones[1][idx]) == 0) continue; // 空位
+            for (int k = 0; k < 8; k++) {
+                int n = idx + arrNear[k];
+                if (m_arrInSet[n] != 0) continue;
+                m_arrInSet[n] = ~0ULL;
+                arrInit[iInit++] = (int16_t)n;
+            }
+        }
+    }
+    if (iInit == 0 && iEmpty > 0) {
+        int idx = ORIGIN + (N / 2) * P + N / 2;
+        m_arrInSet[idx] = ~0ULL;
+        arrInit[iInit++] = (int16_t)idx;
+    }
+    for (int j = 0; j < iLanes; j++) {
+        memcpy(m_arrCand[j], arrInit, iInit * sizeof(int16_t));
+        m_arrCandCount[j] = iInit;
+        if (TRule::HAS_FORBIDDEN) m_arrBoards[j] = board;
+    }
+
+    uint64_t ullActive = ullLanes;
+    while (ullActive != 0) {
+        int c = color - 1;
+        uint64_t ullMoved = 0;
+        for (uint64_t ullLeft = ullActive; ullLeft != 0; ullLeft &= ullLeft - 1) {
+            int j = LowestLane(ullLeft);
+            uint64_t ullBit = 1ULL << j;
+            int& iCount = m_arrCandCount[j];
+            if (iCount == 0) { // 无处可下：和棋
+                ullActive &= ~ullBit;
+                continue;
+            }
+            int k = (int)(rng() % iCount);
+            int idx = m_arrCand[j][k];
+            m_arrCand[j][k] = m_arrCand[j][--iCount];
+            m_arrStones[c][idx] |= ullBit;
+            m_arrMoves[j][m_arrMoveCount[j]++] = (int16_t)idx;
+            if (TRule::HAS_FORBIDDEN) m_arrBoards[j].PlacePiece((idx - ORIGIN) % P, (idx - ORIGIN) / P, color);
+
+            for (int n = 0; n < 8; n++) {
+                int iNear = idx + arrNear[n];
+                if (m_arrInSet[iNear] & ullBit) continue;
+                m_arrInSet[iNear] |= ullBit;
+                m_arrCand[j][iCount++] = (int16_t)iNear;
+            }
+            ullMoved |= ullBit;
+        }
+
+        // 起始局面没有五连，扫出来的五连都是这一步刚走成的
+        uint64_t ullWin = FiveMaskFor(color) & ullMoved;
+        for (uint64_t ullLeft = ullWin; ullLeft != 0; ullLeft &= ullLeft - 1) arrWinners[LowestLane(ullLeft)] = (int8_t)color;
+        ullActive &= ~ullWin;
+
+        if (TRule::HAS_FORBIDDEN && color == BLACK) {
+            for (uint64_t ullLeft = ullMoved & ~ullWin; ullLeft != 0; ullLeft &= ullLeft - 1) {
+                int j = LowestLane(ullLeft);
+                int idx = m_arrMoves[j][m_arrMoveCount[j] - 1];
+                if (!CRefereeT<N, TRule>::CheckForbidden(m_arrBoards[j], (idx - ORIGIN) % P, (idx - ORIGIN) / P)) continue;
+                arrWinners[j] = WHITE;
+                ullActive &= ~(1ULL << j);
+            }
+        }
+        color = (color == BLACK) ? WHITE : BLACK;
+    }
+}
+
+#define INSTANTIATE_BATCHPLAYOUT(N, TRule) template class CBatchPlayoutT<N, TRule>;
+WZQ_FOR_EACH_GAME(INSTANTIATE_BATCHPLAYOUT)
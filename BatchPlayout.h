@@ -0,0 +1,58 @@
+#ifndef _BATCHPLAYOUT_H_
+#define _BATCHPLAYOUT_H_
+
+#include "Board.h"
+#include "Rules.h"
+#include <cstdint>
+#include <random>
+
+// 批量随机对局：最多 64 盘从同一局面出发同步推进，每一步所有没结束的盘各走一手 (颜色相同)
+//
+// 棋盘按位切片：m_arrStones[c][格子] 的第 j 位表示第 j 盘这一格有 c 方的子，64 盘共用一组字
+// 判胜不逐盘看：把走棋方的切片沿格子编号错开 1 / P / P+1 / P-1 (四个方向) 连与五次，
+// 一遍扫下来就是所有盘的五连掩码；正好五连的一方再与掉两头的己方子。结束的盘从活动掩码里去掉
+// 格子按 P = N + 1 列存放，多出的一列和上下几行始终为空，窗口跨行时自动落空，不用判边界
+//
+// 每盘的随机选点、候选维护仍是标量 (各盘候选不同)，但只碰切片里的位，不调用棋盘的成员函数
+// 连珠规则下黑棋的禁手借每盘一份 CBoardT 调 CReferee 判断
+// 走法与 CMCTST::Simulate 相同：从“与已有棋子相邻的空位”里均匀随机选，黑棋走到禁手点判负
+template <int N, class TRule>
+class CBatchPlayoutT {
+public:
+    typedef CBoardT<N> Board;
+    enum { MAX_LANES = 64 };
+
+    CBatchPlayoutT();
+
+    // 从 board 出发、color 先走，同时下 iLanes 盘 (1..64)，arrWinners[j] 为第 j 盘的胜者 (EMPTY 为和棋)
+    // 起始局面里已经有五连时直接判那一方胜
+    void Run(const Board& board, int color, int iLanes, std::minstd_rand& rng, int8_t* arrWinners);
+
+    // 上一次 Run 第 j 盘走过的格子 (y * N + x，按顺序)，校验用
+    int GetLaneMoveCount(int j) const { return m_arrMoveCount[j]; }
+    int GetLaneMove(int j, int k) const { return ToCell(m_arrMoves[j][k]); }
+
+private:
+    enum {
+        P = N + 1,                 // 每行 N 格 + 1 格空列
+        ORIGIN = 2 * P,            // 第 0 行之前留两行空行
+        CELLS = (N + 8) * P        // 之后留的空行够五连窗口再往外看一格
+    };
+
+    uint64_t m_arrStones[2][CELLS];
+    uint64_t m_arrInSet[CELLS];                // 已进候选 (或已有子)；棋盘外的格子全 1，永远不会被加入
+    int16_t m_arrCand[MAX_LANES][N * N];       // 每盘的候选，存切片下标
+    int m_arrCandCount[MAX_LANES];
+    int16_t m_arrMoves[MAX_LANES][N * N];
+    int m_arrMoveCount[MAX_LANES];
+    Board m_arrBoards[TRule::HAS_FORBIDDEN ? MAX_LANES : 1]; // 只有有禁手的规则才用
+
+    static int ToCell(int iIndex) { return ((iIndex - ORIGIN) / P) * N + (iIndex - ORIGIN) % P; }
+
+    // 所有盘里 c 方 (0 黑 1 白) 的五连掩码
+    template <bool EXACT>
+    uint64_t FiveMask(int c) const;
+    uint64_t FiveMaskFor(int color) const;
+};
+
+#endif
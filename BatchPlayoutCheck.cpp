@@ -0,0 +1,210 @@
+#include "BatchPlayout.h"
+#include "Checks.h"
+#include "AIPlayer.h"
+#include "Board.h"
+#include "MCTS.h"
+#include "Referee.h"
+#include "Rules.h"
+#include "SearchControl.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+
+using namespace std;
+
+// 批量模拟校验：WuZiQiDemo --check-playouts [局面数]
+// 随机摆出不含五连的局面，每个局面批量下 64 盘，逐盘用 CReferee 复盘：每步都落在与已有棋子相邻的空位，
+// 中途没有人成五或走到禁手，最后一步的结果与报告的胜者一致；和棋时棋盘上已无相邻空位
+template <int N, class TRule>
+static int CheckBatchPlayouts(int iPositions, minstd_rand& rng, long long* pGames, long long* pMoves) {
+    typedef CBatchPlayoutT<N, TRule> Batch;
+    unique_ptr<Batch> pBatch(new Batch());
+    int8_t arrWinners[Batch::MAX_LANES];
+    int iMismatches = 0;
+    for (int i = 0; i < iPositions; i++) {
+        CBoardT<N> start;
+        int color = BLACK;
+        int iStones = (int)(rng() % (N * 2));
+        for (int k = 0; k < iStones; k++) {
+            int x = N / 2 + (int)(rng() % 9) - 4, y = N / 2 + (int)(rng() % 9) - 4;
+            if (!start.IsEmpty(x, y)) continue;
+            start.PlacePiece(x, y, color);
+            if (CRefereeT<N, TRule>::CheckWin(start, x, y) ||
+                (color == BLACK && CRefereeT<N, TRule>::CheckForbidden(start, x, y))) {
+                start.UndoPiece(x, y);
+                continue;
+            }
+            color = 3 - color;
+        }
+
+        int iStartStones = 0;
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) iStartStones += (start.GetPiece(x, y) != EMPTY);
+        }
+
+        int iLanes = 1 + (int)(rng() % Batch::MAX_LANES);
+        pBatch->Run(start, color, iLanes, rng, arrWinners);
+        for (int j = 0; j < iLanes; j++) {
+            CBoardT<N> board = start;
+            int toMove = color, winner = EMPTY;
+            bool bOk = true, bOver = false;
+            int iCount = pBatch->GetLaneMoveCount(j);
+            for (int k = 0; k < iCount && bOk; k++) {
+                int x = pBatch->GetLaneMove(j, k) % N, y = pBatch->GetLaneMove(j, k) / N;
+                bool bNear = iStartStones + k == 0 && x == N / 2 && y == N / 2; // 空棋盘先下天元
+                for (int dy = -1; dy <= 1 && !bNear; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        if (board.IsValid(x + dx, y + dy) && board.GetPiece(x + dx, y + dy) != EMPTY) bNear = true;
+                    }
+                }
+                bOk = !bOver && board.IsEmpty(x, y) && bNear;
+                if (!bOk) break;
+                board.PlacePiece(x, y, toMove);
+                if (CRefereeT<N, TRule>::CheckWin(board, x, y)) {
+                    winner = toMove;
+                    bOver = true;
+                } else if (toMove == BLACK && CRefereeT<N, TRule>::CheckForbidden(board, x, y)) {
+                    winner = WHITE;
+                    bOver = true;
+                }
+                toMove = 3 - toMove;
+            }
+            // 和棋：不能还有与棋子相邻的空位
+            for (int y = 0; y < N && bOk && !bOver; y++) {
+                for (int x = 0; x < N && bOk; x++) {
+                    if (board.GetPiece(x, y) == EMPTY) continue;
+                    for (int dy = -1; dy <= 1; dy++) {
+                        for (int dx = -1; dx <= 1; dx++) {
+                            if (board.IsValid(x + dx, y + dy) && board.IsEmpty(x + dx, y + dy)) bOk = false;
+                        }
+                    }
+                }
+            }
+            if (bOk && winner != arrWinners[j]) bOk = false;
+            if (!bOk) {
+                if (iMismatches == 0) {
+                    cout << " [不一致] " << N << "x" << N << " " << TRule::Name() << " 第 " << i << " 个局面 第 "
+                         << j << " 盘, 报告胜者 " << (int)arrWinners[j] << endl;
+                }
+                iMismatches++;
+            }
+            (*pGames)++;
+            *pMoves += iCount;
+        }
+    }
+    return iMismatches;
+}
+
+struct SPlayoutChecker {
+    typedef int ResultType;
+    int iPositions;
+    minstd_rand* pRng;
+    long long* pGames;
+    long long* pMoves;
+
+    template <int N, class TRule>
+    int Run() { return CheckBatchPlayouts<N, TRule>(iPositions, *pRng, pGames, pMoves); }
+};
+
+int RunPlayoutCheck(int argc, char* argv[]) {
+    int iPositions = (argc > 2) ? atoi(argv[2]) : 20;
+    minstd_rand rng(41);
+    long long llGames = 0, llMoves = 0;
+
+    const int arrSizes[] = { 15, 19, 20 };
+    const int arrRules[] = { RULE_RENJU, RULE_STANDARD, RULE_FREESTYLE };
+    int iMismatches = 0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            SPlayoutChecker checker = { iPositions, &rng, &llGames, &llMoves };
+            iMismatches += DispatchGame(arrSizes[i], arrRules[j], checker);
+        }
+    }
+
+    cout << (iMismatches == 0 ? "[通过]" : "[失败]") << " 9 种组合 x " << iPositions << " 个局面, 复盘 "
+         << llGames << " 盘, 平均每盘 " << (llGames ? (double)llMoves / llGames : 0.0)
+         << " 手, 不一致数: " << iMismatches << endl;
+    return iMismatches == 0 ? 0 : 1;
+}
+
+// 批量模拟对比：WuZiQiDemo --bench-playouts [模拟数] [每批盘数] [棋盘大小]
+// 同一个开局上逐盘 Simulate 与批量内核各下同样多盘，比较每秒盘数和黑胜率 (两者应在统计误差内一致)；
+// 再用 MCTS 在同一局面上各搜一次，比较每秒模拟数
+struct SPlayoutBench {
+    typedef int ResultType;
+    int iPlayouts;
+    int iLanes;
+
+    template <int N, class TRule>
+    int Run() {
+        shared_ptr<const AIWeights> pWeights = make_shared<AIWeights>();
+        CBoardT<N> board;
+        CAIPlayerT<N, TRule> black(BLACK, pWeights), white(WHITE, pWeights);
+        board.PlacePiece(N / 2, N / 2, BLACK);
+        int color = WHITE;
+        for (int k = 0; k < 5; k++) {
+            Point p = (color == BLACK ? black : white).SearchMove(board);
+            board.PlacePiece(p.iX, p.iY, color);
+            color = 3 - color;
+        }
+
+        CMCTST<N, TRule> mcts(*pWeights, MCTS_PUCT, 41);
+        int arrScalar[3] = { 0, 0, 0 };
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        for (int k = 0; k < iPlayouts; k++) {
+            CBoardT<N> work = board;
+            arrScalar[mcts.Simulate(work, color)]++;
+        }
+        double dScalar = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        typedef CBatchPlayoutT<N, TRule> Batch;
+        unique_ptr<Batch> pBatch(new Batch());
+        minstd_rand rng(41);
+        int8_t arrWinners[Batch::MAX_LANES];
+        int arrBatch[3] = { 0, 0, 0 };
+        t0 = chrono::steady_clock::now();
+        for (int k = 0; k < iPlayouts; k += iLanes) {
+            int iCount = min(iLanes, iPlayouts - k);
+            pBatch->Run(board, color, iCount, rng, arrWinners);
+            for (int j = 0; j < iCount; j++) arrBatch[arrWinners[j]]++;
+        }
+        double dBatch = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        double arrSearch[2] = { 0, 0 };
+        int arrSearchPlayouts[2] = { 0, 0 };
+        for (int m = 0; m < 2; m++) {
+            CMCTST<N, TRule> search(*pWeights, MCTS_PUCT, 41);
+            search.SetBatch(m == 0 ? 1 : iLanes);
+            CSearchControl ctl = CSearchControl::Unlimited();
+            t0 = chrono::steady_clock::now();
+            arrSearchPlayouts[m] = search.Search(board, color, iPlayouts, ctl).iPlayouts;
+            arrSearch[m] = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        }
+
+        cout << " " << N << "x" << N << " " << TRule::Name() << ": 逐盘 " << (int)(iPlayouts / dScalar)
+             << " 盘/秒 (黑胜 " << 100.0 * arrScalar[BLACK] / iPlayouts << "%), 批量 " << (int)(iPlayouts / dBatch)
+             << " 盘/秒 (黑胜 " << 100.0 * arrBatch[BLACK] / iPlayouts << "%), 加速 " << dScalar / dBatch << " 倍" << endl;
+        cout << "   MCTS: 逐盘 " << (int)(arrSearchPlayouts[0] / arrSearch[0]) << " 次/秒, 每叶 " << iLanes << " 盘 "
+             << (int)(arrSearchPlayouts[1] / arrSearch[1]) << " 次/秒" << endl;
+        return 0;
+    }
+};
+
+int RunPlayoutBench(int argc, char* argv[]) {
+    int iPlayouts = (argc > 2) ? atoi(argv[2]) : 20000;
+    int iLanes = (argc > 3) ? atoi(argv[3]) : 64;
+    int iSize = (argc > 4) ? atoi(argv[4]) : 15;
+    if (iLanes < 1) iLanes = 1;
+    if (iLanes > 64) iLanes = 64;
+
+    cout << "每种规则 " << iPlayouts << " 盘, 每批 " << iLanes << " 盘" << endl;
+    const int arrRules[] = { RULE_RENJU, RULE_STANDARD, RULE_FREESTYLE };
+    for (int j = 0; j < 3; j++) {
+        SPlayoutBench bench = { iPlayouts, iLanes };
+        DispatchGame(iSize, arrRules[j], bench);
+    }
+    return 0;
+}
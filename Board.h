@@ -3,13 +3,18 @@
 
 #include "Global.h"
 
-class CBoard {
+// 棋盘：大小 N 是编译期常量，所有循环和数组都按 N 特化
+template <int N>
+class CBoardT {
+public:
+    static const int SIZE = N;
+
 private:
-    int m_iGrid[BOARD_SIZE][BOARD_SIZE]; // 棋盘数据
-    Point m_stLastMove;                  // 记录最后一步棋的位置
+    int m_iGrid[N][N];      // 棋盘数据
+    Point m_stLastMove;     // 记录最后一步棋的位置
 
 public:
-    CBoard();
+    CBoardT();
     
     // 重置棋盘
     void Reset();
@@ -39,4 +44,7 @@ public:
     Point GetLastMove() const;
 };
 
-#endif
\ No newline at end of file
+// 默认的 15x15 棋盘
+typedef CBoardT<BOARD_SIZE> CBoard;
+
+#endif
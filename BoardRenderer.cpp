@@ -0,0 +1,105 @@
+#include "BoardRenderer.h"
+#include "Console.h"
+#include "Rules.h"
+#include "Trace.h"
+#include <cstdio>
+
+using namespace std;
+
+template <int N>
+CBoardRendererT<N>::CBoardRendererT() : m_bValid(false), m_iChangedRows(0) {}
+
+template <int N>
+void CBoardRendererT<N>::AppendHeader(string& strOut) {
+    // 1. 顶部列号 (15 路为 A - O)
+    strOut += "   "; // 左边留空，给行号让位
+    for (int i = 0; i < N; i++) {
+        // 关键对齐：字母 + 空格 = 2字符宽
+        // 配合下面的棋盘符号（1字符）+ 空格（1字符）= 2字符宽
+        strOut += (char)('A' + i);
+        strOut += ' ';
+    }
+}
+
+template <int N>
+void CBoardRendererT<N>::AppendRow(const Board& board, int y, string& strOut) {
+    // 行号，占2位，右对齐
+    char szLabel[16]; // 够放下任意 int，-Wformat-truncation 不再报
+    snprintf(szLabel, sizeof(szLabel), "%2d ", y + 1);
+    strOut += szLabel;
+
+    Point stLast = board.GetLastMove();
+    int iColor = -1; // 当前已生效的颜色，相同就不再重复输出转义序列
+    for (int x = 0; x < N; x++) {
+        int iPiece = board.GetPiece(x, y);
+        bool bIsLast = (x == stLast.iX && y == stLast.iY);
+
+        // 最后一步红色，其余棋子白色，空位灰色线条
+        int iWant = (iPiece == EMPTY) ? 8 : (bIsLast ? 12 : 7);
+        if (iWant != iColor) {
+            strOut += CConsole::ColorCode(iWant);
+            iColor = iWant;
+        }
+
+        if (iPiece == BLACK) {
+            strOut += "●";
+        } else if (iPiece == WHITE) {
+            strOut += "○";
+        } else if (y == 0) {
+            strOut += (x == 0) ? "┌" : (x == N - 1) ? "┐" : "┬";
+        } else if (y == N - 1) {
+            strOut += (x == 0) ? "└" : (x == N - 1) ? "┘" : "┴";
+        } else {
+            strOut += (x == 0) ? "├" : (x == N - 1) ? "┤" : "┼";
+        }
+
+        // 关键对齐：符号后面补一个空格
+        strOut += ' ';
+    }
+    // 还原颜色
+    strOut += CConsole::ColorCode(7);
+}
+
+template <int N>
+void CBoardRendererT<N>::RenderFrame(const Board& board, string& strOut) {
+    WZQ_TRACE_SCOPE("render.frame", "render");
+    AppendHeader(strOut);
+    strOut += '\n';
+    for (int y = 0; y < N; y++) {
+        AppendRow(board, y, strOut);
+        strOut += '\n';
+    }
+}
+
+template <int N>
+void CBoardRendererT<N>::RenderDiff(const Board& board, string& strOut) {
+    WZQ_TRACE_SCOPE("render.diff", "render");
+    m_iChangedRows = 0;
+    if (!m_bValid) {
+        strOut += CConsole::ClearScreen();
+        AppendHeader(strOut);
+    }
+
+    string strRow;
+    for (int y = 0; y < N; y++) {
+        strRow.clear();
+        AppendRow(board, y, strRow);
+        if (m_bValid && strRow == m_arrShown[y]) continue;
+
+        // 第 1 行是列号，棋盘第 y 行在屏幕第 y + 2 行
+        strOut += CConsole::MoveTo(y + 2, 1);
+        strOut += strRow;
+        strOut += CConsole::ClearToLineEnd();
+        m_arrShown[y].swap(strRow);
+        m_iChangedRows++;
+    }
+    m_bValid = true;
+
+    strOut += CConsole::MoveTo(SCREEN_ROWS + 1, 1);
+    strOut += CConsole::ClearBelow();
+}
+
+// 显式实例化所有支持的棋盘大小
+#define INSTANTIATE_RENDERER(N) template class CBoardRendererT<N>;
+WZQ_FOR_EACH_SIZE(INSTANTIATE_RENDERER)
+WZQ_FOR_EACH_SMALL_SIZE(INSTANTIATE_RENDERER)
@@ -0,0 +1,50 @@
+#ifndef _BOARDRENDERER_H_
+#define _BOARDRENDERER_H_
+
+#include "Board.h"
+#include <string>
+
+// 棋盘渲染器：整帧先拼进一个字符串 (带 ANSI 颜色)，再由 CConsole::Write 一次写出
+//
+// 两种用法：
+//  RenderFrame：流式整帧，接在当前光标后面输出 (Draw 用)
+//  RenderDiff ：棋盘固定在屏幕左上角，只重画和上一帧不同的行
+// 按行而不是按格子比较：●○ 和制表符在不同终端里可能占 1 或 2 列，按列号定位格子不可靠，
+// 而行首总是第 1 列；每手棋最多改变两行 (新落子和上一手的高亮)
+template <int N>
+class CBoardRendererT {
+public:
+    typedef CBoardT<N> Board;
+
+    // 棋盘 (含列号行) 占用的屏幕行数，状态文字从下一行开始
+    static const int SCREEN_ROWS = N + 1;
+
+    CBoardRendererT();
+
+    // 追加一整帧到 strOut
+    void RenderFrame(const Board& board, std::string& strOut);
+
+    // 追加增量更新到 strOut；第一次 (或 Invalidate 之后) 清屏并画整帧
+    // 结尾把光标放到棋盘下方，并清掉下方旧的状态文字
+    void RenderDiff(const Board& board, std::string& strOut);
+
+    // 屏幕被别的输出弄乱了，下次 RenderDiff 整帧重画
+    void Invalidate() { m_bValid = false; }
+
+    // 上一次 RenderDiff 重画的行数 (整帧为 N)
+    int GetLastChangedRows() const { return m_iChangedRows; }
+
+    // 单独一行的文本 (行号 + 棋盘符号，含颜色)
+    static void AppendRow(const Board& board, int y, std::string& strOut);
+    static void AppendHeader(std::string& strOut);
+
+private:
+    std::string m_arrShown[N]; // 上一帧每行的内容
+    bool m_bValid;
+    int m_iChangedRows;
+};
+
+// 默认 15x15
+typedef CBoardRendererT<BOARD_SIZE> CBoardRenderer;
+
+#endif
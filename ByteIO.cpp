@@ -0,0 +1,36 @@
+#include "ByteIO.h"
+#include <cstdio>
+#include <fstream>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace std;
+
+bool WriteFileAtomic(const string& strFile, const vector<uint8_t>& v, string* pError) {
+    string strTemp = strFile + ".tmp";
+    {
+        ofstream file(strTemp, ios::binary);
+        if (file.is_open()) {
+            file.write((const char*)v.data(), (streamsize)v.size());
+            // 缓冲区里剩下的在 close 时才写出，磁盘满之类的错误要在这里查，不能等析构时悄悄丢掉
+            file.close();
+        }
+        if (file.fail()) {
+            remove(strTemp.c_str());
+            if (pError) *pError = "无法写入 " + strTemp;
+            return false;
+        }
+    }
+#ifdef _WIN32
+    // Windows 上 rename 不覆盖已有文件
+    bool bRenamed = MoveFileExA(strTemp.c_str(), strFile.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool bRenamed = rename(strTemp.c_str(), strFile.c_str()) == 0;
+#endif
+    if (bRenamed) return true;
+    // 旧文件原样留着，只清掉临时文件
+    remove(strTemp.c_str());
+    if (pError) *pError = "无法改名为 " + strFile;
+    return false;
+}
@@ -0,0 +1,68 @@
+#ifndef _BYTEIO_H_
+#define _BYTEIO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 二进制文件读写的小工具：一律小端，与平台无关
+// 网络文件、证明结果等自定义格式共用，文件末尾统一带 FNV-1a 校验和
+
+inline void PutU32(std::vector<uint8_t>& v, uint32_t x) {
+    for (int i = 0; i < 4; i++) v.push_back((uint8_t)(x >> (8 * i)));
+}
+
+inline void PutU64(std::vector<uint8_t>& v, uint64_t x) {
+    for (int i = 0; i < 8; i++) v.push_back((uint8_t)(x >> (8 * i)));
+}
+
+// 写到已分配好的缓冲区里 (大块数据先 resize 再逐条写，比逐字节 push_back 快)
+inline void SetU64(uint8_t* p, uint64_t x) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(x >> (8 * i));
+}
+
+inline uint32_t GetU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint64_t GetU64(const uint8_t* p) {
+    return (uint64_t)GetU32(p) | ((uint64_t)GetU32(p + 4) << 32);
+}
+
+inline uint32_t Fnv1a(const uint8_t* p, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// 一次吃 8 字节的 64 位校验和，大块数据 (快照里的置换表) 用，比逐字节的 FNV-1a 快得多
+// 每一步对输入的字都是可逆的，改动任何一个字结果一定不同
+// 可以分段接着算 (上一段的结果当 h 传进去)，这时除了最后一段，每段长度都要是 8 的倍数
+const uint64_t HASH_WORDS_SEED = 0x9E3779B97F4A7C15ULL;
+
+inline uint64_t HashWord(uint64_t h, uint64_t w) {
+    h = (h ^ w) * 0xFF51AFD7ED558CCDULL;
+    return h ^ (h >> 32);
+}
+
+inline uint64_t HashWords(const uint8_t* p, size_t n, uint64_t h = HASH_WORDS_SEED) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) h = HashWord(h, GetU64(p + i));
+    if (i < n) {
+        // 不足 8 字节的尾巴：剩下的字节数记在最高字节里
+        uint64_t w = (uint64_t)(n - i) << 56;
+        for (size_t k = 0; i + k < n; k++) w |= (uint64_t)p[i + k] << (8 * k);
+        h = HashWord(h, w);
+    }
+    return h;
+}
+
+// 整个文件一次写出：先写 strFile.tmp 再改名，写到一半被打断也不会留下半个文件或弄坏旧文件
+// 失败时 pError (可为空) 给出原因
+bool WriteFileAtomic(const std::string& strFile, const std::vector<uint8_t>& v, std::string* pError);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef _CHECKS_H_
+#define _CHECKS_H_
+
+// 命令行自检、基准和工具：每个模块的放在模块旁边的 <模块>Check.cpp 里，main 只按第一个参数分发
+// 入口都是 int Run...(argc, argv)，argv[1] 是模式名本身，返回值就是进程的退出码 (0 为通过)
+
+// EvalKernelCheck.cpp
+int RunEvalCheck(int argc, char* argv[]);        // --check-eval
+
+// ForbiddenMapCheck.cpp
+int RunForbiddenCheck(int argc, char* argv[]);   // --check-forbidden
+
+// ThreatIndexCheck.cpp
+int RunThreatCheck(int argc, char* argv[]);      // --check-threats
+
+// ArenaCheck.cpp
+int RunAllocCheck(int argc, char* argv[]);       // --check-alloc
+
+// BatchPlayoutCheck.cpp
+int RunPlayoutCheck(int argc, char* argv[]);     // --check-playouts
+int RunPlayoutBench(int argc, char* argv[]);     // --bench-playouts
+
+// SparseBoardCheck.cpp
+int RunSparseCheck(int argc, char* argv[]);      // --check-sparse
+int RunSparseBench(int argc, char* argv[]);      // --bench-sparse
+
+// NNUECheck.cpp
+int RunNNUECheck(int argc, char* argv[]);        // --check-nnue
+int RunNNUEInit(int argc, char* argv[]);         // --nnue-init
+
+// MCTSCheck.cpp
+int RunMCTSBench(int argc, char* argv[]);        // --bench-mcts
+
+// LogCheck.cpp
+int RunLogBench(int argc, char* argv[]);         // --bench-log
+
+// AlphaBetaCheck.cpp
+int RunSearchBench(int argc, char* argv[]);      // --bench-search
+int RunMultiPVBench(int argc, char* argv[]);     // --bench-multipv
+
+// GameSessionCheck.cpp
+int RunSnapshotBench(int argc, char* argv[]);    // --bench-snapshot
+
+// TacticSuiteCheck.cpp
+int RunAnalyze(int argc, char* argv[]);          // --analyze
+int RunSuite(int argc, char* argv[]);            // --suite
+
+// GameAuditCheck.cpp
+int RunAudit(int argc, char* argv[]);            // --audit
+int RunAuditGen(int argc, char* argv[]);         // --audit-gen
+
+// SmallSolverCheck.cpp
+int RunSmallSolveCheck(int argc, char* argv[]);  // --check-small
+int RunSmallSolve(int argc, char* argv[]);       // --solve-small
+
+// SearchSchedulerCheck.cpp
+int RunBudgetCheck(int argc, char* argv[]);      // --check-budget
+
+// TraceCheck.cpp
+int RunTraceCheck(int argc, char* argv[]);       // --check-trace
+
+// ProofSolverCheck.cpp
+int RunSolve(int argc, char* argv[]);            // --solve
+
+#endif
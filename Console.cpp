@@ -1,22 +1,75 @@
 #include "Console.h"
+#include "Trace.h"
 #include <iostream>
+#include <cstdio>
 
-void CConsole::SetCursorPos(int x, int y) {
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+void CConsole::Init() {
+#ifdef _WIN32
+    // 代替原来的 system("chcp 65001")
+    SetConsoleOutputCP(CP_UTF8);
     HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD dwMode = 0;
+    if (GetConsoleMode(hOut, &dwMode)) {
+        SetConsoleMode(hOut, dwMode | 0x0004); // ENABLE_VIRTUAL_TERMINAL_PROCESSING
+    }
+#endif
+}
+
+void CConsole::SetCursorPos(int x, int y) {
     // x * 2 因为中文字符（棋盘符号）在控制台占2个单位宽度
-    COORD pos = { (SHORT)(x * 2), (SHORT)y }; 
-    SetConsoleCursorPosition(hOut, pos);
+    Write(MoveTo(y + 1, x * 2 + 1));
 }
 
 void CConsole::HideCursor() {
-    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    CONSOLE_CURSOR_INFO cursorInfo;
-    GetConsoleCursorInfo(hOut, &cursorInfo);
-    cursorInfo.bVisible = false;
-    SetConsoleCursorInfo(hOut, &cursorInfo);
+    Write("\x1b[?25l");
 }
 
 void CConsole::SetColor(int colorID) {
-    // 0=黑, 7=白, 12=红(高亮), 8=灰
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), colorID);
-}
\ No newline at end of file
+    Write(ColorCode(colorID));
+}
+
+const char* CConsole::ColorCode(int colorID) {
+    // 0=黑, 7=白, 12=红(高亮), 8=灰；其余按 Windows 调色板对应到 ANSI 前景色
+    static const char* const arrCodes[16] = {
+        "\x1b[30m", "\x1b[34m", "\x1b[32m", "\x1b[36m", "\x1b[31m", "\x1b[35m", "\x1b[33m", "\x1b[0m",
+        "\x1b[90m", "\x1b[94m", "\x1b[92m", "\x1b[96m", "\x1b[91m", "\x1b[95m", "\x1b[93m", "\x1b[97m"
+    };
+    if (colorID < 0 || colorID > 15) return "\x1b[0m";
+    return arrCodes[colorID];
+}
+
+string CConsole::MoveTo(int iRow, int iCol) {
+    return "\x1b[" + to_string(iRow) + ";" + to_string(iCol) + "H";
+}
+
+void CConsole::Write(const string& strText) {
+    WZQ_TRACE_SCOPE("console.write", "render");
+    // 先把 cout 里排队的内容送出去，保证先后顺序
+    cout.flush();
+    fflush(stdout);
+#ifdef _WIN32
+    DWORD dwWritten = 0;
+    WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), strText.data(), (DWORD)strText.size(), &dwWritten, NULL);
+#else
+    const char* p = strText.data();
+    size_t iLeft = strText.size();
+    while (iLeft > 0) {
+        ssize_t n = ::write(STDOUT_FILENO, p, iLeft);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        p += n;
+        iLeft -= (size_t)n;
+    }
+#endif
+}
@@ -1,18 +1,33 @@
 #ifndef _CONSOLE_H_
 #define _CONSOLE_H_
 
-#include <windows.h>
+#include <string>
 
+// 终端控制：统一用 ANSI 转义序列，Linux/macOS 终端和 Windows 10+ 控制台都适用
+// 不再包含 <windows.h>，Windows 相关的初始化只在 Console.cpp 里
 class CConsole {
 public:
+    // 程序开头调用一次：Windows 下切到 UTF-8 并打开虚拟终端 (ANSI) 支持，其他平台什么都不做
+    static void Init();
+
     // 设置光标位置 (x, y)
     static void SetCursorPos(int x, int y);
     
     // 隐藏光标 (让界面更美观)
     static void HideCursor();
     
-    // 设置颜色 (0-15)
+    // 设置颜色 (0-15，沿用 Windows 控制台的调色板编号)
     static void SetColor(int colorID);
+
+    // 把一整块文本一次性写到标准输出 (一次系统调用，不会半帧半帧地闪)
+    static void Write(const std::string& strText);
+
+    // 生成转义序列，供渲染器拼进帧缓冲
+    static const char* ColorCode(int colorID);           // 设置颜色
+    static std::string MoveTo(int iRow, int iCol);       // 光标移到第 iRow 行第 iCol 列 (从 1 开始)
+    static const char* ClearScreen() { return "\x1b[2J\x1b[H"; }
+    static const char* ClearToLineEnd() { return "\x1b[K"; }
+    static const char* ClearBelow() { return "\x1b[J"; }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,119 @@
+#include "EvalKernel.h"
+#include "EvalKernelImpl.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 标量版：一次一个格子，但算法与 SIMD 版完全相同 (按行推进的动态规划)
+struct SEvalOpsScalar {
+    typedef int8_t V8;
+    typedef int32_t V32;
+    static const int WIDTH8 = 1;
+    static const int WIDTH32 = 1;
+
+    static V8 Load8(const int8_t* p) { return *p; }
+    static void Store8(int8_t* p, V8 v) { *p = v; }
+    static V8 Set8(int8_t v) { return v; }
+    static V8 CmpEq8(V8 a, V8 b) { return a == b ? -1 : 0; }
+    static V8 And8(V8 a, V8 b) { return (int8_t)(a & b); }
+    static V8 Add8(V8 a, V8 b) { return (int8_t)(a + b); }
+    static V8 Sub8(V8 a, V8 b) { return (int8_t)(a - b); }
+    static V8 Blend8(V8 a, V8 b, V8 m) { return m ? b : a; }
+
+    static V32 Widen(const int8_t* p) { return *p; }
+    static V32 Load32(const int32_t* p) { return *p; }
+    static void Store32(int32_t* p, V32 v) { *p = v; }
+    static V32 Set32(int32_t v) { return v; }
+    static V32 CmpEq32(V32 a, V32 b) { return a == b ? -1 : 0; }
+    static V32 CmpGt32(V32 a, V32 b) { return a > b ? -1 : 0; }
+    static V32 And32(V32 a, V32 b) { return a & b; }
+    static V32 Add32(V32 a, V32 b) { return a + b; }
+    static V32 Blend32(V32 a, V32 b, V32 m) { return m ? b : a; }
+    static V32 MulTrunc(V32 v, float f) { return (int32_t)((float)v * f); }
+};
+
+void EvalScoreMapScalar(const SEvalInput& in, int* pOut) {
+    EvalScoreMapImpl<SEvalOpsScalar>(in, pOut);
+}
+
+void EvalLineSumsScalar(const SEvalInput& in, int* pMy, int* pEnemy) {
+    EvalLineSumsOut<SEvalOpsScalar>(in, pMy, pEnemy);
+}
+
+void SEvalInput::Clear(int iBoardSize) {
+    iSize = iBoardSize;
+    for (int i = 0; i < EVAL_BUF_ROWS; i++) {
+        for (int c = 0; c < EVAL_STRIDE; c++) {
+            arrGrid[i][c] = EVAL_BORDER;
+            arrGridT[i][c] = EVAL_BORDER;
+        }
+    }
+}
+
+// 是否 x86 (只有 x86 才编译 SSE4/AVX2 版本)
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define WZQ_X86 1
+#endif
+
+static bool DetectKernel(EEvalKernel eKernel) {
+    if (eKernel == EVAL_KERNEL_SCALAR) return true;
+#if defined(WZQ_X86) && (defined(__GNUC__) || defined(__clang__))
+    // __builtin_cpu_supports 已经顺带检查了操作系统是否保存 YMM 寄存器
+    __builtin_cpu_init();
+    if (eKernel == EVAL_KERNEL_SSE4) return __builtin_cpu_supports("sse4.1") != 0;
+    if (eKernel == EVAL_KERNEL_AVX2) return __builtin_cpu_supports("avx2") != 0;
+#elif defined(WZQ_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool bSSE41 = (info[2] & (1 << 19)) != 0;
+    bool bOSXSAVE = (info[2] & (1 << 27)) != 0;
+    bool bAVX = (info[2] & (1 << 28)) != 0;
+    if (eKernel == EVAL_KERNEL_SSE4) return bSSE41;
+    if (!bOSXSAVE || !bAVX) return false;
+    if ((_xgetbv(0) & 6) != 6) return false; // 操作系统没打开 YMM 状态保存
+    __cpuidex(info, 7, 0);
+    if (eKernel == EVAL_KERNEL_AVX2) return (info[1] & (1 << 5)) != 0;
+#endif
+    return false;
+}
+
+bool CEvalKernel::IsSupported(EEvalKernel eKernel) {
+    static const bool bSSE4 = DetectKernel(EVAL_KERNEL_SSE4);
+    static const bool bAVX2 = DetectKernel(EVAL_KERNEL_AVX2);
+    if (eKernel == EVAL_KERNEL_SSE4) return bSSE4;
+    if (eKernel == EVAL_KERNEL_AVX2) return bAVX2;
+    return true;
+}
+
+EEvalKernel CEvalKernel::GetBest() {
+    static const EEvalKernel eBest =
+        IsSupported(EVAL_KERNEL_AVX2) ? EVAL_KERNEL_AVX2 :
+        IsSupported(EVAL_KERNEL_SSE4) ? EVAL_KERNEL_SSE4 : EVAL_KERNEL_SCALAR;
+    return eBest;
+}
+
+const char* CEvalKernel::GetName(EEvalKernel eKernel) {
+    switch (eKernel) {
+    case EVAL_KERNEL_AVX2: return "avx2";
+    case EVAL_KERNEL_SSE4: return "sse4.1";
+    default:               return "scalar";
+    }
+}
+
+void CEvalKernel::ScoreMap(const SEvalInput& in, int* pOut, EEvalKernel eKernel) {
+    if (!IsSupported(eKernel)) eKernel = EVAL_KERNEL_SCALAR;
+    switch (eKernel) {
+    case EVAL_KERNEL_AVX2: EvalScoreMapAVX2(in, pOut); break;
+    case EVAL_KERNEL_SSE4: EvalScoreMapSSE4(in, pOut); break;
+    default:               EvalScoreMapScalar(in, pOut); break;
+    }
+}
+
+void CEvalKernel::LineSums(const SEvalInput& in, int* pMy, int* pEnemy) {
+    switch (GetBest()) {
+    case EVAL_KERNEL_AVX2: EvalLineSumsAVX2(in, pMy, pEnemy); break;
+    case EVAL_KERNEL_SSE4: EvalLineSumsSSE4(in, pMy, pEnemy); break;
+    default:               EvalLineSumsScalar(in, pMy, pEnemy); break;
+    }
+}
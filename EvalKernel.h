@@ -0,0 +1,80 @@
+#ifndef _EVALKERNEL_H_
+#define _EVALKERNEL_H_
+
+#include "Global.h"
+#include <cstdint>
+
+// 全盘评分内核：一次算出所有格子的 EvaluatePoint 分数 (评分图)
+// 与 CAIPlayerT::EvaluatePoint 的逐格射线扫描结果逐位一致，只是按行/列/斜线整条并行计算
+
+// 填充后的棋盘：每行 32 格 (正好一个 AVX2 寄存器)，坐标 (x, y) 存在 [y + 1][x + 1]
+// 四周和多余的列都填 EVAL_BORDER；上下各多留一行，让 ±1 列偏移的非对齐读取不越界
+const int EVAL_STRIDE = 32;
+const int EVAL_ROWS = MAX_BOARD_SIZE + 2;      // 0 与 N+1 为边界行
+const int EVAL_BUF_ROWS = EVAL_ROWS + 2;       // 再加前后各一行的读取余量
+const int8_t EVAL_BORDER = 3;
+
+// 评分参数 (来自 AIWeights 和规则)
+struct SEvalParams {
+    int32_t iWin5;
+    int32_t iLive4;
+    int32_t iDash4;
+    int32_t iLive3;
+    int32_t iLive2;
+    float fAttackFactor;
+    float fDefenseFactor;
+    bool bMyExactFive;     // 己方是否必须正好五连 (长连记 0 分)
+    bool bEnemyExactFive;
+};
+
+// 内核输入：两份填充棋盘 (正常和转置，转置的那份让横向也变成按行推进)
+struct SEvalInput {
+    int iSize;
+    int8_t iMyColor;
+    int8_t iEnemyColor;
+    SEvalParams stParams;
+    alignas(32) int8_t arrGrid[EVAL_BUF_ROWS][EVAL_STRIDE];
+    alignas(32) int8_t arrGridT[EVAL_BUF_ROWS][EVAL_STRIDE];
+
+    // 清空为全边界，之后用 SetCell 填 N*N 个格子
+    void Clear(int iBoardSize);
+    void SetCell(int x, int y, int8_t iPiece) {
+        arrGrid[y + 2][x + 1] = iPiece;   // +1 是前置余量行，+1 是边界行
+        arrGridT[x + 2][y + 1] = iPiece;
+    }
+};
+
+enum EEvalKernel {
+    EVAL_KERNEL_SCALAR = 0,  // 可移植的按行推进版本
+    EVAL_KERNEL_SSE4,        // SSE4.1，每行 2×16 字节
+    EVAL_KERNEL_AVX2         // AVX2，每行 1×32 字节
+};
+
+class CEvalKernel {
+public:
+    // 运行时检测 CPU，返回可用的最快内核 (只检测一次)
+    static EEvalKernel GetBest();
+
+    // 该内核在这台机器上能否运行
+    static bool IsSupported(EEvalKernel eKernel);
+
+    static const char* GetName(EEvalKernel eKernel);
+
+    // 计算评分图：pOut[y * N + x]；非空格子的值没有意义
+    static void ScoreMap(const SEvalInput& in, int* pOut, EEvalKernel eKernel);
+    static void ScoreMap(const SEvalInput& in, int* pOut) { ScoreMap(in, pOut, GetBest()); }
+
+    // 只算双方的棋型分之和 (四个方向相加，不乘性格系数、不加天元分)
+    // pMy/pEnemy[y * N + x]：假设该空位落己方/对方子时的进攻潜力，供搜索的局面评估使用
+    static void LineSums(const SEvalInput& in, int* pMy, int* pEnemy);
+};
+
+// 各指令集的实现 (EvalKernelSSE4.cpp / EvalKernelAVX2.cpp 单独带指令集编译选项)
+void EvalScoreMapScalar(const SEvalInput& in, int* pOut);
+void EvalScoreMapSSE4(const SEvalInput& in, int* pOut);
+void EvalScoreMapAVX2(const SEvalInput& in, int* pOut);
+void EvalLineSumsScalar(const SEvalInput& in, int* pMy, int* pEnemy);
+void EvalLineSumsSSE4(const SEvalInput& in, int* pMy, int* pEnemy);
+void EvalLineSumsAVX2(const SEvalInput& in, int* pMy, int* pEnemy);
+
+#endif
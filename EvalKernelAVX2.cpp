@@ -0,0 +1,100 @@
+// 本文件单独以 AVX2 选项编译 (见 CMakeLists.txt)，只有 CPU 支持时才会被调用
+#include "EvalKernel.h"
+#include "NNUE.h"
+
+#if defined(__AVX2__)
+#include "EvalKernelImpl.h"
+#include <immintrin.h>
+
+// AVX2：32 个 int8 (正好一行) 或 8 个 int32 一组
+struct SEvalOpsAVX2 {
+    typedef __m256i V8;
+    typedef __m256i V32;
+    static const int WIDTH8 = 32;
+    static const int WIDTH32 = 8;
+
+    static V8 Load8(const int8_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static void Store8(int8_t* p, V8 v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static V8 Set8(int8_t v) { return _mm256_set1_epi8(v); }
+    static V8 CmpEq8(V8 a, V8 b) { return _mm256_cmpeq_epi8(a, b); }
+    static V8 And8(V8 a, V8 b) { return _mm256_and_si256(a, b); }
+    static V8 Add8(V8 a, V8 b) { return _mm256_add_epi8(a, b); }
+    static V8 Sub8(V8 a, V8 b) { return _mm256_sub_epi8(a, b); }
+    static V8 Blend8(V8 a, V8 b, V8 m) { return _mm256_blendv_epi8(a, b, m); }
+
+    static V32 Widen(const int8_t* p) {
+        return _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)p));
+    }
+    static V32 Load32(const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static void Store32(int32_t* p, V32 v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static V32 Set32(int32_t v) { return _mm256_set1_epi32(v); }
+    static V32 CmpEq32(V32 a, V32 b) { return _mm256_cmpeq_epi32(a, b); }
+    static V32 CmpGt32(V32 a, V32 b) { return _mm256_cmpgt_epi32(a, b); }
+    static V32 And32(V32 a, V32 b) { return _mm256_and_si256(a, b); }
+    static V32 Add32(V32 a, V32 b) { return _mm256_add_epi32(a, b); }
+    static V32 Blend32(V32 a, V32 b, V32 m) { return _mm256_blendv_epi8(a, b, m); }
+    static V32 MulTrunc(V32 v, float f) {
+        return _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(f)));
+    }
+};
+
+void EvalScoreMapAVX2(const SEvalInput& in, int* pOut) {
+    EvalScoreMapImpl<SEvalOpsAVX2>(in, pOut);
+}
+
+void EvalLineSumsAVX2(const SEvalInput& in, int* pMy, int* pEnemy) {
+    EvalLineSumsOut<SEvalOpsAVX2>(in, pMy, pEnemy);
+}
+
+
+// NNUE：uint8 x int8 内积用 maddubs (相邻两对乘积相加成 int16，127*127*2 不会饱和)，再用 madd 扩成 int32
+static int32_t HorizontalSumAVX2(__m256i v) {
+    // 8 个 int32 横向求和
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+}
+
+void NNUEAffineAVX2(const uint8_t* pIn, int iIn, const int8_t* pW, const int32_t* pBias, int iOut, int32_t* pOut) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    for (int j = 0; j < iOut; j++) {
+        const int8_t* pRow = pW + (size_t)j * iIn;
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < iIn; i += 32) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(pIn + i));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(pRow + i));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+        }
+        pOut[j] = pBias[j] + HorizontalSumAVX2(sum);
+    }
+}
+
+void NNUEAccUpdateAVX2(int16_t* pAcc, const int16_t* pRow, int iCount, int iSign) {
+    for (int i = 0; i < iCount; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(pAcc + i));
+        __m256i r = _mm256_loadu_si256((const __m256i*)(pRow + i));
+        _mm256_storeu_si256((__m256i*)(pAcc + i), iSign > 0 ? _mm256_add_epi16(a, r) : _mm256_sub_epi16(a, r));
+    }
+}
+
+#else
+
+// 编译器没开 AVX2 或非 x86 平台：不会被选中，退回标量版
+void EvalScoreMapAVX2(const SEvalInput& in, int* pOut) {
+    EvalScoreMapScalar(in, pOut);
+}
+
+void EvalLineSumsAVX2(const SEvalInput& in, int* pMy, int* pEnemy) {
+    EvalLineSumsScalar(in, pMy, pEnemy);
+}
+
+void NNUEAffineAVX2(const uint8_t* pIn, int iIn, const int8_t* pW, const int32_t* pBias, int iOut, int32_t* pOut) {
+    NNUEAffineScalar(pIn, iIn, pW, pBias, iOut, pOut);
+}
+
+void NNUEAccUpdateAVX2(int16_t* pAcc, const int16_t* pRow, int iCount, int iSign) {
+    NNUEAccUpdateScalar(pAcc, pRow, iCount, iSign);
+}
+
+#endif
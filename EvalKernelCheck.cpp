@@ -0,0 +1,92 @@
+#include "EvalKernel.h"
+#include "Checks.h"
+#include "AIPlayer.h"
+#include "Board.h"
+#include "Rules.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+
+using namespace std;
+
+// 评分内核差分校验：WuZiQiDemo --check-eval [每种组合的局面数]
+// 随机局面上把每个可用的 SIMD 内核与逐格 EvaluatePoint 比对，必须逐位一致
+template <int N, class TRule>
+static int CheckEvalKernels(int iPositions, minstd_rand& rng) {
+    static const float arrFactors[] = { 1.0f, 1.05f, 0.55f, 1.35f, 2.5f, 0.5f, 1.15f, 0.95f };
+    const int iFactorCount = sizeof(arrFactors) / sizeof(arrFactors[0]);
+    const EEvalKernel arrKernels[] = { EVAL_KERNEL_SCALAR, EVAL_KERNEL_SSE4, EVAL_KERNEL_AVX2 };
+
+    int iMismatches = 0;
+    for (int i = 0; i < iPositions; i++) {
+        // 随机性格系数，覆盖浮点乘法截断的各种情况
+        shared_ptr<AIWeights> pWeights = make_shared<AIWeights>();
+        pWeights->fAttackFactor = arrFactors[rng() % iFactorCount];
+        pWeights->fDefenseFactor = arrFactors[rng() % iFactorCount];
+
+        // 随机密度铺子，再随机画几条长线 (覆盖活四、长连)
+        CBoardT<N> board;
+        int iDensity = (int)(rng() % 70);
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                if ((int)(rng() % 100) < iDensity) board.PlacePiece(x, y, (rng() % 2) ? BLACK : WHITE);
+            }
+        }
+        int iLines = (int)(rng() % 4);
+        for (int k = 0; k < iLines; k++) {
+            int x = (int)(rng() % N), y = (int)(rng() % N), len = 3 + (int)(rng() % 5);
+            int dx = (int)(rng() % 3) - 1, dy = (int)(rng() % 2);
+            if (dx == 0 && dy == 0) dx = 1;
+            int color = (rng() % 2) ? BLACK : WHITE;
+            for (int step = 0; step < len; step++) board.PlacePiece(x + dx * step, y + dy * step, color);
+        }
+
+        for (int color = BLACK; color <= WHITE; color++) {
+            CAIPlayerT<N, TRule> ai(color, pWeights);
+            for (int k = 0; k < 3; k++) {
+                if (!CEvalKernel::IsSupported(arrKernels[k])) continue;
+                int iBad = ai.CheckScoreMap(board, arrKernels[k]);
+                if (iBad > 0) {
+                    cout << " [不一致] " << N << "x" << N << " " << TRule::Name()
+                         << " 内核=" << CEvalKernel::GetName(arrKernels[k])
+                         << " 局面#" << i << " 格子数=" << iBad << endl;
+                }
+                iMismatches += iBad;
+            }
+        }
+    }
+    return iMismatches;
+}
+
+struct SEvalChecker {
+    typedef int ResultType;
+    int iPositions;
+    minstd_rand* pRng;
+
+    template <int N, class TRule>
+    int Run() { return CheckEvalKernels<N, TRule>(iPositions, *pRng); }
+};
+
+int RunEvalCheck(int argc, char* argv[]) {
+    int iPositions = (argc > 2) ? atoi(argv[2]) : 200;
+    minstd_rand rng(12345);
+
+    cout << "评分内核: 当前选用 " << CEvalKernel::GetName(CEvalKernel::GetBest())
+         << " (sse4.1 " << (CEvalKernel::IsSupported(EVAL_KERNEL_SSE4) ? "可用" : "不可用")
+         << ", avx2 " << (CEvalKernel::IsSupported(EVAL_KERNEL_AVX2) ? "可用" : "不可用") << ")" << endl;
+
+    const int arrSizes[] = { 15, 19, 20 };
+    const int arrRules[] = { RULE_RENJU, RULE_STANDARD, RULE_FREESTYLE };
+    int iMismatches = 0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            SEvalChecker checker = { iPositions, &rng };
+            iMismatches += DispatchGame(arrSizes[i], arrRules[j], checker);
+        }
+    }
+
+    cout << (iMismatches == 0 ? "[通过]" : "[失败]") << " 9 种组合 x " << iPositions
+         << " 个局面, 不一致格子数: " << iMismatches << endl;
+    return iMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+#ifndef _EVALKERNELIMPL_H_
+#define _EVALKERNELIMPL_H_
+
+// 评分内核的通用框架，只给 EvalKernel*.cpp 包含
+// TOps 提供一套向量操作 (标量/SSE4/AVX2 各一套)，同一份算法按不同宽度实例化
+// 注意：这里不要用标准库模板，带指令集选项编译的实例可能被链接器拿去给标量路径用
+
+#include "EvalKernel.h"
+
+// 行内推进的四个方向：(相邻行偏移, 相邻列偏移, 是否用转置棋盘)
+// 横向在转置棋盘上就是"下一行同一列"
+struct SEvalDir {
+    int iRowStep;
+    int iColOff;
+    bool bTransposed;
+};
+
+static const SEvalDir EVAL_DIRS[4] = {
+    { 1,  0, true  },  // 横 (1, 0)
+    { 1,  0, false },  // 竖 (0, 1)
+    { 1,  1, false },  // 斜 (1, 1)
+    { -1, 1, false }   // 反斜 (1, -1)
+};
+
+// 一次评分要用的缓冲区 (都按 [EVAL_BUF_ROWS][EVAL_STRIDE] 排列，指针指向第 0 行即边界行)
+struct SEvalWork {
+    alignas(32) int8_t arrRunF[EVAL_BUF_ROWS][EVAL_STRIDE];   // 正方向连子数
+    alignas(32) int8_t arrNextF[EVAL_BUF_ROWS][EVAL_STRIDE];  // 正方向连子后的第一个格子
+    alignas(32) int8_t arrRunB[EVAL_BUF_ROWS][EVAL_STRIDE];
+    alignas(32) int8_t arrNextB[EVAL_BUF_ROWS][EVAL_STRIDE];
+    alignas(32) int8_t arrCount[EVAL_BUF_ROWS][EVAL_STRIDE];  // 含自己的连子数
+    alignas(32) int8_t arrEnds[EVAL_BUF_ROWS][EVAL_STRIDE];   // 两头空位数
+    alignas(32) int32_t arrLine[EVAL_BUF_ROWS][EVAL_STRIDE];  // 单方向得分 (横向时是转置的)
+    alignas(32) int32_t arrSum[2][EVAL_BUF_ROWS][EVAL_STRIDE]; // 双方四个方向的得分和
+    alignas(32) int32_t arrTotal[EVAL_BUF_ROWS][EVAL_STRIDE];
+};
+
+#define EVAL_ROW(arr, r) (&(arr)[(r) + 1][0])
+
+// 沿一个方向做动态规划：run[r] = (S[邻格] == color) ? run[邻格] + 1 : 0
+// 从离邻格远的那一端推进，整行一次算完
+template <class TOps>
+static void EvalRuns(const int8_t (*pGrid)[EVAL_STRIDE], int iSize, int iRowStep, int iColOff,
+                     int8_t color, int8_t (*pRun)[EVAL_STRIDE], int8_t (*pNext)[EVAL_STRIDE]) {
+    typedef typename TOps::V8 V8;
+    const V8 vColor = TOps::Set8(color);
+    const V8 vOne = TOps::Set8(1);
+
+    for (int i = 0; i < EVAL_BUF_ROWS; i++) {
+        for (int c = 0; c < EVAL_STRIDE; c++) {
+            pRun[i][c] = 0;
+            pNext[i][c] = EVAL_BORDER;
+        }
+    }
+
+    int rBegin = (iRowStep > 0) ? iSize : 1;
+    int rEnd = (iRowStep > 0) ? 0 : iSize + 1;
+    for (int r = rBegin; r != rEnd; r -= iRowStep) {
+        int nb = r + iRowStep;
+        const int8_t* pS = EVAL_ROW(pGrid, nb) + iColOff;
+        const int8_t* pR = EVAL_ROW(pRun, nb) + iColOff;
+        const int8_t* pN = EVAL_ROW(pNext, nb) + iColOff;
+        int8_t* pOutR = EVAL_ROW(pRun, r);
+        int8_t* pOutN = EVAL_ROW(pNext, r);
+
+        for (int c0 = 0; c0 < EVAL_STRIDE; c0 += TOps::WIDTH8) {
+            V8 s = TOps::Load8(pS + c0);
+            V8 m = TOps::CmpEq8(s, vColor);
+            TOps::Store8(pOutR + c0, TOps::And8(m, TOps::Add8(TOps::Load8(pR + c0), vOne)));
+            TOps::Store8(pOutN + c0, TOps::Blend8(s, TOps::Load8(pN + c0), m));
+        }
+    }
+}
+
+// 由两头的连子数和端点算出 count / 空端数，再按 GetLineScore 的规则映射成分数
+template <class TOps>
+static void EvalLineScore(SEvalWork& w, int iSize, const SEvalParams& p, bool bExactFive) {
+    typedef typename TOps::V8 V8;
+    typedef typename TOps::V32 V32;
+    const V8 vOne8 = TOps::Set8(1);
+    const V8 vZero8 = TOps::Set8(0);
+
+    for (int r = 1; r <= iSize; r++) {
+        for (int c0 = 0; c0 < EVAL_STRIDE; c0 += TOps::WIDTH8) {
+            V8 cnt = TOps::Add8(vOne8, TOps::Add8(TOps::Load8(EVAL_ROW(w.arrRunF, r) + c0),
+                                                  TOps::Load8(EVAL_ROW(w.arrRunB, r) + c0)));
+            // 比较结果是 -1，所以用减法累加
+            V8 eF = TOps::CmpEq8(TOps::Load8(EVAL_ROW(w.arrNextF, r) + c0), vZero8);
+            V8 eB = TOps::CmpEq8(TOps::Load8(EVAL_ROW(w.arrNextB, r) + c0), vZero8);
+            TOps::Store8(EVAL_ROW(w.arrCount, r) + c0, cnt);
+            TOps::Store8(EVAL_ROW(w.arrEnds, r) + c0, TOps::Sub8(TOps::Sub8(vZero8, eF), eB));
+        }
+    }
+
+    const V32 v1 = TOps::Set32(1), v2 = TOps::Set32(2), v3 = TOps::Set32(3);
+    const V32 v4 = TOps::Set32(4), v5 = TOps::Set32(5), vZero = TOps::Set32(0);
+    const V32 vWin5 = TOps::Set32(p.iWin5), vLive4 = TOps::Set32(p.iLive4);
+    const V32 vDash4 = TOps::Set32(p.iDash4), vLive3 = TOps::Set32(p.iLive3);
+    const V32 vLive2 = TOps::Set32(p.iLive2);
+
+    for (int r = 1; r <= iSize; r++) {
+        for (int c0 = 0; c0 < EVAL_STRIDE; c0 += TOps::WIDTH32) {
+            V32 cnt = TOps::Widen(EVAL_ROW(w.arrCount, r) + c0);
+            V32 ends = TOps::Widen(EVAL_ROW(w.arrEnds, r) + c0);
+            V32 e1 = TOps::CmpEq32(ends, v1);
+            V32 e2 = TOps::CmpEq32(ends, v2);
+            V32 c2 = TOps::CmpEq32(cnt, v2);
+            V32 c3 = TOps::CmpEq32(cnt, v3);
+            V32 c4 = TOps::CmpEq32(cnt, v4);
+
+            // 各条件互斥，顺序无关；都不满足时返回 count 本身
+            V32 s = cnt;
+            s = TOps::Blend32(s, vLive2, TOps::And32(c2, e2));
+            s = TOps::Blend32(s, vLive2, TOps::And32(c3, e1)); // 眠三近似活二
+            s = TOps::Blend32(s, vLive3, TOps::And32(c3, e2));
+            s = TOps::Blend32(s, vDash4, TOps::And32(c4, e1));
+            s = TOps::Blend32(s, vLive4, TOps::And32(c4, e2));
+            s = TOps::Blend32(s, vWin5, TOps::CmpGt32(cnt, v4));
+            if (bExactFive) s = TOps::Blend32(s, vZero, TOps::CmpGt32(cnt, v5));
+            TOps::Store32(EVAL_ROW(w.arrLine, r) + c0, s);
+        }
+    }
+}
+
+template <class TOps>
+static void EvalAccumulate(SEvalWork& w, int iSize, int iSide, bool bTransposed) {
+    typedef typename TOps::V32 V32;
+    if (bTransposed) {
+        // 横向是在转置棋盘上算的，转回来再加
+        for (int y = 1; y <= iSize; y++) {
+            for (int x = 1; x <= iSize; x++) {
+                EVAL_ROW(w.arrSum[iSide], y)[x] += EVAL_ROW(w.arrLine, x)[y];
+            }
+        }
+        return;
+    }
+    for (int r = 1; r <= iSize; r++) {
+        int32_t* pSum = EVAL_ROW(w.arrSum[iSide], r);
+        const int32_t* pLine = EVAL_ROW(w.arrLine, r);
+        for (int c0 = 0; c0 < EVAL_STRIDE; c0 += TOps::WIDTH32) {
+            V32 v = TOps::Add32(TOps::Load32(pSum + c0), TOps::Load32(pLine + c0));
+            TOps::Store32(pSum + c0, v);
+        }
+    }
+}
+
+// 双方四个方向的棋型分之和 (未乘性格系数)，结果留在 w.arrSum[0] (己方) / w.arrSum[1] (对方)
+template <class TOps>
+static void EvalLineSumsImpl(const SEvalInput& in, SEvalWork& w) {
+    const int n = in.iSize;
+    const SEvalParams& p = in.stParams;
+
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < EVAL_BUF_ROWS; i++) {
+            for (int c = 0; c < EVAL_STRIDE; c++) w.arrSum[side][i][c] = 0;
+        }
+    }
+
+    for (int side = 0; side < 2; side++) {
+        int8_t color = (side == 0) ? in.iMyColor : in.iEnemyColor;
+        bool bExact = (side == 0) ? p.bMyExactFive : p.bEnemyExactFive;
+
+        for (int d = 0; d < 4; d++) {
+            const SEvalDir& dir = EVAL_DIRS[d];
+            const int8_t (*pGrid)[EVAL_STRIDE] = dir.bTransposed ? in.arrGridT : in.arrGrid;
+            EvalRuns<TOps>(pGrid, n, dir.iRowStep, dir.iColOff, color, w.arrRunF, w.arrNextF);
+            EvalRuns<TOps>(pGrid, n, -dir.iRowStep, -dir.iColOff, color, w.arrRunB, w.arrNextB);
+            EvalLineScore<TOps>(w, n, p, bExact);
+            EvalAccumulate<TOps>(w, n, side, dir.bTransposed);
+        }
+    }
+}
+
+template <class TOps>
+static void EvalScoreMapImpl(const SEvalInput& in, int* pOut) {
+    typedef typename TOps::V32 V32;
+    SEvalWork w;
+    const int n = in.iSize;
+    const SEvalParams& p = in.stParams;
+    EvalLineSumsImpl<TOps>(in, w);
+
+    // 乘性格系数后截断，与标量版 (int)(score * factor) 相同的单精度运算
+    for (int r = 1; r <= n; r++) {
+        const int32_t* pMy = EVAL_ROW(w.arrSum[0], r);
+        const int32_t* pEnemy = EVAL_ROW(w.arrSum[1], r);
+        int32_t* pTotal = EVAL_ROW(w.arrTotal, r);
+        for (int c0 = 0; c0 < EVAL_STRIDE; c0 += TOps::WIDTH32) {
+            V32 a = TOps::MulTrunc(TOps::Load32(pMy + c0), p.fAttackFactor);
+            V32 b = TOps::MulTrunc(TOps::Load32(pEnemy + c0), p.fDefenseFactor);
+            TOps::Store32(pTotal + c0, TOps::Add32(a, b));
+        }
+    }
+
+    // 天元附近 5x5 的小加分
+    const int c = n / 2;
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            int dx = x - c, dy = y - c;
+            bool bCenter = dx >= -2 && dx <= 2 && dy >= -2 && dy <= 2;
+            pOut[y * n + x] = EVAL_ROW(w.arrTotal, y + 1)[x + 1] + (bCenter ? 10 : 0);
+        }
+    }
+}
+
+template <class TOps>
+static void EvalLineSumsOut(const SEvalInput& in, int* pMy, int* pEnemy) {
+    SEvalWork w;
+    EvalLineSumsImpl<TOps>(in, w);
+    const int n = in.iSize;
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            pMy[y * n + x] = EVAL_ROW(w.arrSum[0], y + 1)[x + 1];
+            pEnemy[y * n + x] = EVAL_ROW(w.arrSum[1], y + 1)[x + 1];
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,102 @@
+// 本文件单独以 SSE4.1 选项编译 (见 CMakeLists.txt)，只有 CPU 支持时才会被调用
+#include "EvalKernel.h"
+#include "NNUE.h"
+
+#if defined(__SSE4_1__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#include "EvalKernelImpl.h"
+#include <smmintrin.h>
+#include <cstring>
+
+// SSE4.1：16 个 int8 或 4 个 int32 一组，一行 32 格分两次
+struct SEvalOpsSSE4 {
+    typedef __m128i V8;
+    typedef __m128i V32;
+    static const int WIDTH8 = 16;
+    static const int WIDTH32 = 4;
+
+    static V8 Load8(const int8_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static void Store8(int8_t* p, V8 v) { _mm_storeu_si128((__m128i*)p, v); }
+    static V8 Set8(int8_t v) { return _mm_set1_epi8(v); }
+    static V8 CmpEq8(V8 a, V8 b) { return _mm_cmpeq_epi8(a, b); }
+    static V8 And8(V8 a, V8 b) { return _mm_and_si128(a, b); }
+    static V8 Add8(V8 a, V8 b) { return _mm_add_epi8(a, b); }
+    static V8 Sub8(V8 a, V8 b) { return _mm_sub_epi8(a, b); }
+    static V8 Blend8(V8 a, V8 b, V8 m) { return _mm_blendv_epi8(a, b, m); }
+
+    static V32 Widen(const int8_t* p) {
+        int32_t i;
+        memcpy(&i, p, sizeof(i));
+        return _mm_cvtepi8_epi32(_mm_cvtsi32_si128(i));
+    }
+    static V32 Load32(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static void Store32(int32_t* p, V32 v) { _mm_storeu_si128((__m128i*)p, v); }
+    static V32 Set32(int32_t v) { return _mm_set1_epi32(v); }
+    static V32 CmpEq32(V32 a, V32 b) { return _mm_cmpeq_epi32(a, b); }
+    static V32 CmpGt32(V32 a, V32 b) { return _mm_cmpgt_epi32(a, b); }
+    static V32 And32(V32 a, V32 b) { return _mm_and_si128(a, b); }
+    static V32 Add32(V32 a, V32 b) { return _mm_add_epi32(a, b); }
+    static V32 Blend32(V32 a, V32 b, V32 m) { return _mm_blendv_epi8(a, b, m); }
+    static V32 MulTrunc(V32 v, float f) {
+        return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(f)));
+    }
+};
+
+void EvalScoreMapSSE4(const SEvalInput& in, int* pOut) {
+    EvalScoreMapImpl<SEvalOpsSSE4>(in, pOut);
+}
+
+void EvalLineSumsSSE4(const SEvalInput& in, int* pMy, int* pEnemy) {
+    EvalLineSumsOut<SEvalOpsSSE4>(in, pMy, pEnemy);
+}
+
+
+// NNUE：uint8 x int8 内积用 maddubs (相邻两对乘积相加成 int16，127*127*2 不会饱和)，再用 madd 扩成 int32
+static int32_t HorizontalSumSSE4(__m128i v) {
+    // 4 个 int32 横向求和
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0xB1));
+    return _mm_cvtsi128_si32(v);
+}
+
+void NNUEAffineSSE4(const uint8_t* pIn, int iIn, const int8_t* pW, const int32_t* pBias, int iOut, int32_t* pOut) {
+    const __m128i ones = _mm_set1_epi16(1);
+    for (int j = 0; j < iOut; j++) {
+        const int8_t* pRow = pW + (size_t)j * iIn;
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < iIn; i += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(pIn + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(pRow + i));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(a, b), ones));
+        }
+        pOut[j] = pBias[j] + HorizontalSumSSE4(sum);
+    }
+}
+
+void NNUEAccUpdateSSE4(int16_t* pAcc, const int16_t* pRow, int iCount, int iSign) {
+    for (int i = 0; i < iCount; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(pAcc + i));
+        __m128i r = _mm_loadu_si128((const __m128i*)(pRow + i));
+        _mm_storeu_si128((__m128i*)(pAcc + i), iSign > 0 ? _mm_add_epi16(a, r) : _mm_sub_epi16(a, r));
+    }
+}
+
+#else
+
+// 非 x86 平台：不会被选中，退回标量版
+void EvalScoreMapSSE4(const SEvalInput& in, int* pOut) {
+    EvalScoreMapScalar(in, pOut);
+}
+
+void EvalLineSumsSSE4(const SEvalInput& in, int* pMy, int* pEnemy) {
+    EvalLineSumsScalar(in, pMy, pEnemy);
+}
+
+void NNUEAffineSSE4(const uint8_t* pIn, int iIn, const int8_t* pW, const int32_t* pBias, int iOut, int32_t* pOut) {
+    NNUEAffineScalar(pIn, iIn, pW, pBias, iOut, pOut);
+}
+
+void NNUEAccUpdateSSE4(int16_t* pAcc, const int16_t* pRow, int iCount, int iSign) {
+    NNUEAccUpdateScalar(pAcc, pRow, iCount, iSign);
+}
+
+#endif
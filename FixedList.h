@@ -0,0 +1,58 @@
+#ifndef _FIXEDLIST_H_
+#define _FIXEDLIST_H_
+
+#include <cassert>
+
+// 定长列表：容量在编译期定死，元素就地存放 (放在栈上或对象里)，从不分配堆内存
+// 接口取 std::vector 的一个子集，搜索热路径上的候选走法、主变例之类都用它
+// 超出容量是调用方的错误 (assert)，容量按 N * N 给足时不会发生
+template <class T, int CAPACITY>
+class CFixedList {
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    CFixedList() : m_iSize(0) {}
+
+    void push_back(const T& item) {
+        assert(m_iSize < CAPACITY);
+        m_arrItems[m_iSize++] = item;
+    }
+    void pop_back() {
+        assert(m_iSize > 0);
+        m_iSize--;
+    }
+    void clear() { m_iSize = 0; }
+    // 只能缩短，或者在容量内加长 (新元素不初始化)
+    void resize(int iSize) {
+        assert(iSize >= 0 && iSize <= CAPACITY);
+        m_iSize = iSize;
+    }
+
+    int size() const { return m_iSize; }
+    bool empty() const { return m_iSize == 0; }
+    static int capacity() { return CAPACITY; }
+
+    T& operator[](int i) { return m_arrItems[i]; }
+    const T& operator[](int i) const { return m_arrItems[i]; }
+    T& back() { return m_arrItems[m_iSize - 1]; }
+    const T& back() const { return m_arrItems[m_iSize - 1]; }
+
+    T* data() { return m_arrItems; }
+    const T* data() const { return m_arrItems; }
+    iterator begin() { return m_arrItems; }
+    iterator end() { return m_arrItems + m_iSize; }
+    const_iterator begin() const { return m_arrItems; }
+    const_iterator end() const { return m_arrItems + m_iSize; }
+
+private:
+    T m_arrItems[CAPACITY];
+    int m_iSize;
+};
+
+// 候选走法列表 (格子编号 y * N + x)：一个棋盘最多 N * N 个空位
+template <int N>
+using CMoveListT = CFixedList<int, N * N>;
+
+#endif
@@ -0,0 +1,87 @@
+#include "ForbiddenMap.h"
+#include "Referee.h"
+
+using namespace std;
+
+template <int N, class TRule>
+CForbiddenMapT<N, TRule>::CForbiddenMapT() {
+    Reset();
+}
+
+template <int N, class TRule>
+void CForbiddenMapT<N, TRule>::Reset() {
+    m_board.Reset();
+    for (int y = 0; y < N; y++) m_arrRows[y] = 0;
+    m_llRecomputes = 0;
+}
+
+template <int N, class TRule>
+void CForbiddenMapT<N, TRule>::Rebuild(const Board& board) {
+    m_board = board;
+    for (int y = 0; y < N; y++) {
+        m_arrRows[y] = 0;
+        if (!TRule::HAS_FORBIDDEN) continue;
+        for (int x = 0; x < N; x++) Recompute(x, y);
+    }
+}
+
+template <int N, class TRule>
+void CForbiddenMapT<N, TRule>::Sync(const Board& board) {
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int piece = board.GetPiece(x, y);
+            int old = m_board.GetPiece(x, y);
+            if (piece == old) continue;
+            if (old != EMPTY) Undo(x, y);
+            if (piece != EMPTY) Place(x, y, piece);
+        }
+    }
+}
+
+template <int N, class TRule>
+void CForbiddenMapT<N, TRule>::Place(int x, int y, int color) {
+    m_board.PlacePiece(x, y, color);
+    if (TRule::HAS_FORBIDDEN) Refresh(x, y);
+}
+
+template <int N, class TRule>
+void CForbiddenMapT<N, TRule>::Undo(int x, int y) {
+    m_board.UndoPiece(x, y);
+    if (TRule::HAS_FORBIDDEN) Refresh(x, y);
+}
+
+// (x, y) 变了：重算它自己，以及 8 个方向上越过连续黑子后的第一个空位
+template <int N, class TRule>
+void CForbiddenMapT<N, TRule>::Refresh(int x, int y) {
+    Recompute(x, y);
+
+    int dx[] = { 1, 0, 1, 1 };
+    int dy[] = { 0, 1, 1, -1 };
+    for (int i = 0; i < 4; i++) {
+        for (int sign = -1; sign <= 1; sign += 2) {
+            int nx = x + dx[i] * sign, ny = y + dy[i] * sign;
+            while (m_board.IsValid(nx, ny) && m_board.GetPiece(nx, ny) == BLACK) {
+                nx += dx[i] * sign;
+                ny += dy[i] * sign;
+            }
+            if (m_board.IsEmpty(nx, ny)) Recompute(nx, ny);
+        }
+    }
+}
+
+template <int N, class TRule>
+void CForbiddenMapT<N, TRule>::Recompute(int x, int y) {
+    uint32_t bit = 1u << x;
+    m_arrRows[y] &= ~bit;
+    if (!m_board.IsEmpty(x, y)) return;
+
+    m_llRecomputes++;
+    m_board.PlacePiece(x, y, BLACK);
+    bool bForbidden = !CRefereeT<N, TRule>::CheckWin(m_board, x, y) &&
+                      CRefereeT<N, TRule>::CheckForbidden(m_board, x, y);
+    m_board.UndoPiece(x, y);
+    if (bForbidden) m_arrRows[y] |= bit;
+}
+
+#define INSTANTIATE_FORBIDDEN(N, TRule) template class CForbiddenMapT<N, TRule>;
+WZQ_FOR_EACH_GAME(INSTANTIATE_FORBIDDEN)
@@ -0,0 +1,54 @@
+#ifndef _FORBIDDENMAP_H_
+#define _FORBIDDENMAP_H_
+
+#include "Board.h"
+#include "Rules.h"
+#include "Global.h"
+#include <cstdint>
+
+// 黑棋禁手点图：每个空位“黑棋落在这里是否犯规”，按行存位图，查询 O(1)
+// 五连优先于禁手，所以成五的点不算禁手点 (与主循环先 CheckWin 再 CheckForbidden 一致)
+//
+// 增量维护：某格落子/提子后，只有经过它的 4 条线上、与它之间隔着的全是黑子的第一个空位
+// 才可能改变 (CheckForbidden 只看连续黑子和两端外的一格)，每次最多重算 9 个格子
+// 没有禁手的规则下所有操作都是空的 (编译期常量)
+template <int N, class TRule>
+class CForbiddenMapT {
+public:
+    typedef CBoardT<N> Board;
+
+    CForbiddenMapT();
+
+    // 回到空棋盘 (空棋盘上没有禁手点)
+    void Reset();
+
+    // 按 board 全部重算
+    void Rebuild(const Board& board);
+
+    // 与 board 对齐：只对和上次不同的格子做增量更新，适合每手调用一次
+    void Sync(const Board& board);
+
+    // 落子/提子，并更新受影响的格子
+    void Place(int x, int y, int color);
+    void Undo(int x, int y);
+
+    bool IsForbidden(int x, int y) const {
+        return TRule::HAS_FORBIDDEN && ((m_arrRows[y] >> x) & 1u) != 0;
+    }
+
+    // 累计重算过的格子数 (衡量增量维护的开销)
+    long long GetRecomputeCount() const { return m_llRecomputes; }
+
+private:
+    Board m_board;             // 自己的一份棋盘，重算时要在上面试落黑子
+    uint32_t m_arrRows[N];     // 第 y 行的禁手位图，第 x 位对应 (x, y)
+    long long m_llRecomputes;
+
+    void Recompute(int x, int y);
+    void Refresh(int x, int y);
+};
+
+// 默认：15x15 连珠规则
+typedef CForbiddenMapT<BOARD_SIZE, CRenjuRule> CForbiddenMap;
+
+#endif
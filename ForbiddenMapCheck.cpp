@@ -0,0 +1,98 @@
+#include "ForbiddenMap.h"
+#include "Checks.h"
+#include "Board.h"
+#include "GameSession.h"
+#include "Referee.h"
+#include "Rules.h"
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// 禁手图校验：WuZiQiDemo --check-forbidden [局数]
+// 随机落子/悔棋，每一步都把增量维护的禁手图与逐格 CheckWin + CheckForbidden 全量比对
+template <int N, class TRule>
+static int CheckForbiddenMap(int iGames, minstd_rand& rng, long long* pRecomputes, long long* pSteps) {
+    int iMismatches = 0;
+    for (int g = 0; g < iGames; g++) {
+        CBoardT<N> board;
+        CForbiddenMapT<N, TRule> forbidden;
+        vector<Point> vecMoves;
+        int iSteps = N * N / 2 + (int)(rng() % (N * N / 2));
+        for (int k = 0; k < iSteps; k++) {
+            if (!vecMoves.empty() && rng() % 5 == 0) {
+                // 悔一步
+                Point p = vecMoves.back();
+                vecMoves.pop_back();
+                board.UndoPiece(p.iX, p.iY);
+                forbidden.Undo(p.iX, p.iY);
+            } else {
+                // 黑子多一些，并且靠近已有棋子，才容易出现三三/四四/长连
+                int x = (int)(rng() % N), y = (int)(rng() % N);
+                if (!vecMoves.empty() && rng() % 4 != 0) {
+                    Point q = vecMoves[rng() % vecMoves.size()];
+                    x = q.iX + (int)(rng() % 5) - 2;
+                    y = q.iY + (int)(rng() % 5) - 2;
+                }
+                if (!board.IsEmpty(x, y)) continue;
+                int color = (rng() % 3 == 0) ? WHITE : BLACK;
+                board.PlacePiece(x, y, color);
+                forbidden.Place(x, y, color);
+                vecMoves.push_back({x, y});
+            }
+            (*pSteps)++;
+
+            for (int y = 0; y < N; y++) {
+                for (int x = 0; x < N; x++) {
+                    bool bExpected = false;
+                    if (board.IsEmpty(x, y)) {
+                        board.PlacePiece(x, y, BLACK);
+                        bExpected = !CRefereeT<N, TRule>::CheckWin(board, x, y) &&
+                                    CRefereeT<N, TRule>::CheckForbidden(board, x, y);
+                        board.UndoPiece(x, y);
+                    }
+                    if (forbidden.IsForbidden(x, y) != bExpected) {
+                        if (iMismatches == 0) {
+                            cout << " [不一致] " << N << "x" << N << " 第 " << g << " 局 第 " << k
+                                 << " 步 格子 " << PointToString({x, y}) << endl;
+                        }
+                        iMismatches++;
+                    }
+                }
+            }
+        }
+        *pRecomputes += forbidden.GetRecomputeCount();
+    }
+    return iMismatches;
+}
+
+struct SForbiddenChecker {
+    typedef int ResultType;
+    int iGames;
+    minstd_rand* pRng;
+    long long* pRecomputes;
+    long long* pSteps;
+
+    template <int N, class TRule>
+    int Run() { return CheckForbiddenMap<N, TRule>(iGames, *pRng, pRecomputes, pSteps); }
+};
+
+int RunForbiddenCheck(int argc, char* argv[]) {
+    int iGames = (argc > 2) ? atoi(argv[2]) : 20;
+    minstd_rand rng(2024);
+    long long llRecomputes = 0, llSteps = 0;
+
+    const int arrSizes[] = { 15, 19, 20 };
+    int iMismatches = 0;
+    for (int i = 0; i < 3; i++) {
+        SForbiddenChecker checker = { iGames, &rng, &llRecomputes, &llSteps };
+        iMismatches += DispatchGame(arrSizes[i], RULE_RENJU, checker);
+    }
+
+    cout << (iMismatches == 0 ? "[通过]" : "[失败]") << " 3 种棋盘 x " << iGames << " 局, "
+         << llSteps << " 步, 平均每步重算 " << (llSteps ? (double)llRecomputes / llSteps : 0.0)
+         << " 格, 不一致格子数: " << iMismatches << endl;
+    return iMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,452 @@
+#include "GameAudit.h"
+#include "AIPlayer.h"
+#include "GameSession.h"
+#include "Referee.h"
+#include "Rules.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace std;
+
+static const int AUDIT_BATCH_LINES = 4096;
+
+// 结束方式
+enum {
+    AUDIT_END_NONE = 0,
+    AUDIT_END_FIVE,
+    AUDIT_END_FORBIDDEN,
+    AUDIT_END_RESIGN,
+    AUDIT_END_TIMEOUT
+};
+
+static const char* s_arrEndNames[] = { "none", "five", "forbidden", "resign", "timeout" };
+
+const char* GetAuditVerdictName(int iVerdict) {
+    static const char* s_arrNames[AUDIT_VERDICT_COUNT] = { "合法", "格式错误", "非法着法", "终局后仍有着法", "结果不符" };
+    return (iVerdict >= 0 && iVerdict < AUDIT_VERDICT_COUNT) ? s_arrNames[iVerdict] : "?";
+}
+
+// 读好的一行：字符串都指向原行，不复制
+struct SAuditRecord {
+    const char* pId;
+    int iIdLen;
+    int iSize;
+    int iRule;
+    vector<Point> vecMoves;
+    int iClaimed;  // EMPTY 为和棋，-1 为 open
+    int iEnd;      // 写明的结束方式，AUDIT_END_NONE 表示没写
+};
+
+struct SAuditOutcome {
+    int iVerdict;
+    string strDetail;  // 只有出问题时才填
+};
+
+static const char* SkipSpaces(const char* p, const char* pEnd) {
+    while (p < pEnd && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p;
+}
+
+static const char* TokenEnd(const char* p, const char* pEnd) {
+    while (p < pEnd && *p != ' ' && *p != '\t' && *p != '\r') p++;
+    return p;
+}
+
+static bool TokenIs(const char* p, const char* pEnd, const char* pWord) {
+    size_t iLen = strlen(pWord);
+    return (size_t)(pEnd - p) == iLen && memcmp(p, pWord, iLen) == 0;
+}
+
+// 与 StringToPoint 相同的写法 (列字母 + 从 1 起的行号)，不经过 string
+static bool ParseMoveList(const char* p, const char* pEnd, vector<Point>& vecOut) {
+    vecOut.clear();
+    if (TokenIs(p, pEnd, "-")) return true;
+    while (p < pEnd) {
+        char c = *p++;
+        if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+        if (c < 'A' || c > 'Z' || p >= pEnd || *p < '0' || *p > '9') return false;
+        int y = 0;
+        while (p < pEnd && *p >= '0' && *p <= '9') {
+            y = y * 10 + (*p++ - '0');
+            if (y > 1000) return false;
+        }
+        Point pt;
+        pt.iX = c - 'A';
+        pt.iY = y - 1;
+        vecOut.push_back(pt);
+        if (p < pEnd && *p++ != ',') return false;
+    }
+    return true;
+}
+
+// 读一行；空行/注释行返回 false 且 strError 为空
+static bool ParseRecord(const string& strLine, SAuditRecord& rec, string& strError) {
+    strError.clear();
+    const char* p = strLine.c_str();
+    const char* pEnd = p + strLine.size();
+    const char* pSemi = (const char*)memchr(p, ';', strLine.size());
+    if (pSemi != nullptr) pEnd = pSemi;
+
+    const char* arrTok[7];
+    const char* arrTokEnd[7];
+    int iTokens = 0;
+    for (p = SkipSpaces(p, pEnd); p < pEnd && iTokens < 7; p = SkipSpaces(p, pEnd)) {
+        arrTok[iTokens] = p;
+        p = TokenEnd(p, pEnd);
+        arrTokEnd[iTokens++] = p;
+    }
+    if (iTokens == 0 || *arrTok[0] == '#') return false;
+
+    rec.pId = arrTok[0];
+    rec.iIdLen = (int)(arrTokEnd[0] - arrTok[0]);
+    if (iTokens < 5 || iTokens > 6 || p < pEnd) {
+        strError = "应为 编号 大小 规则 着法 结果 [结束方式]";
+        return false;
+    }
+
+    rec.iSize = atoi(string(arrTok[1], arrTokEnd[1]).c_str());
+    if (!IsSupportedBoardSize(rec.iSize)) {
+        strError = "不支持的棋盘大小";
+        return false;
+    }
+    if (TokenIs(arrTok[2], arrTokEnd[2], "renju")) rec.iRule = RULE_RENJU;
+    else if (TokenIs(arrTok[2], arrTokEnd[2], "standard")) rec.iRule = RULE_STANDARD;
+    else if (TokenIs(arrTok[2], arrTokEnd[2], "freestyle")) rec.iRule = RULE_FREESTYLE;
+    else {
+        strError = "未知规则";
+        return false;
+    }
+    if (!ParseMoveList(arrTok[3], arrTokEnd[3], rec.vecMoves)) {
+        strError = "无效着法";
+        return false;
+    }
+
+    if (TokenIs(arrTok[4], arrTokEnd[4], "black")) rec.iClaimed = BLACK;
+    else if (TokenIs(arrTok[4], arrTokEnd[4], "white")) rec.iClaimed = WHITE;
+    else if (TokenIs(arrTok[4], arrTokEnd[4], "draw")) rec.iClaimed = EMPTY;
+    else if (TokenIs(arrTok[4], arrTokEnd[4], "open")) rec.iClaimed = -1;
+    else {
+        strError = "未知结果";
+        return false;
+    }
+
+    rec.iEnd = AUDIT_END_NONE;
+    if (iTokens == 6) {
+        for (int e = AUDIT_END_FIVE; e <= AUDIT_END_TIMEOUT; e++) {
+            if (TokenIs(arrTok[5], arrTokEnd[5], s_arrEndNames[e])) rec.iEnd = e;
+        }
+        if (rec.iEnd == AUDIT_END_NONE) {
+            strError = "未知结束方式";
+            return false;
+        }
+    }
+    return true;
+}
+
+static const char* ColorName(int color) {
+    return color == BLACK ? "black" : (color == WHITE ? "white" : (color == EMPTY ? "draw" : "open"));
+}
+
+// 在编译期确定的大小/规则下复盘一局
+struct SAuditReplay {
+    typedef int ResultType;
+    const SAuditRecord* pRec;
+    SAuditOutcome* pOut;
+    const AIWeights* pWeights;  // 不为空时标注评分
+    string* pNotes;
+
+    template <int N, class TRule>
+    int Run() {
+        const SAuditRecord& rec = *pRec;
+        SAuditOutcome& out = *pOut;
+        out.iVerdict = AUDIT_OK;
+
+        CBoardT<N> board;
+        unique_ptr<CAIPlayerT<N, TRule>> arrAI[2];
+        int arrScores[N * N];
+        if (pWeights != nullptr) {
+            shared_ptr<const AIWeights> pShared = make_shared<AIWeights>(*pWeights);
+            arrAI[0].reset(new CAIPlayerT<N, TRule>(BLACK, pShared));
+            arrAI[1].reset(new CAIPlayerT<N, TRule>(WHITE, pShared));
+            pNotes->append(rec.pId, rec.iIdLen);
+            *pNotes += ' ';
+        }
+
+        int color = BLACK, winner = EMPTY, iEnd = AUDIT_END_NONE;
+        int iMoves = (int)rec.vecMoves.size();
+        for (int k = 0; k < iMoves; k++) {
+            Point p = rec.vecMoves[k];
+            if (iEnd != AUDIT_END_NONE) {
+                out.iVerdict = AUDIT_MOVES_AFTER_END;
+                out.strDetail = "第 " + to_string(k + 1) + " 手 " + PointToString(p) + " 之前已经 " + s_arrEndNames[iEnd];
+                break;
+            }
+            if (p.iX < 0 || p.iX >= N || p.iY < 0 || p.iY >= N || !board.IsEmpty(p.iX, p.iY)) {
+                out.iVerdict = AUDIT_ILLEGAL_MOVE;
+                out.strDetail = "第 " + to_string(k + 1) + " 手 " + PointToString(p) + (board.IsValid(p.iX, p.iY) ? " 已有子" : " 越界");
+                break;
+            }
+
+            if (pWeights != nullptr) {
+                arrAI[color - 1]->ScoreMap(board, arrScores);
+                int iBest = INT_MIN;
+                for (int i = 0; i < N * N; i++) {
+                    if (board.IsEmpty(i % N, i / N) && arrScores[i] > iBest) iBest = arrScores[i];
+                }
+                if (k > 0) *pNotes += ',';
+                *pNotes += PointToString(p) + ":" + to_string(arrScores[p.iY * N + p.iX]) + ":" + to_string(iBest);
+            }
+
+            board.PlacePiece(p.iX, p.iY, color);
+            if (CRefereeT<N, TRule>::CheckWin(board, p.iX, p.iY)) {
+                winner = color;
+                iEnd = AUDIT_END_FIVE;
+            } else if (TRule::HAS_FORBIDDEN && color == BLACK && CRefereeT<N, TRule>::CheckForbidden(board, p.iX, p.iY)) {
+                winner = WHITE;
+                iEnd = AUDIT_END_FORBIDDEN;
+            }
+            color = (color == BLACK) ? WHITE : BLACK;
+        }
+        if (pWeights != nullptr) *pNotes += '\n';
+        if (out.iVerdict != AUDIT_OK) return 0;
+
+        // 对照记录的结果
+        bool bFull = iMoves == N * N;
+        bool bOk;
+        if (iEnd != AUDIT_END_NONE) {
+            bOk = rec.iClaimed == winner && (rec.iEnd == AUDIT_END_NONE || rec.iEnd == iEnd);
+        } else if (rec.iClaimed == -1) {
+            bOk = !bFull && rec.iEnd == AUDIT_END_NONE;
+        } else if (rec.iClaimed == EMPTY) {
+            bOk = rec.iEnd == AUDIT_END_NONE;
+        } else {
+            bOk = rec.iEnd == AUDIT_END_RESIGN || rec.iEnd == AUDIT_END_TIMEOUT;
+        }
+        if (!bOk) {
+            out.iVerdict = AUDIT_WRONG_RESULT;
+            out.strDetail = string("记录 ") + ColorName(rec.iClaimed) + (rec.iEnd ? string(" ") + s_arrEndNames[rec.iEnd] : "") +
+                            ", 复盘 " + (iEnd != AUDIT_END_NONE ? string(ColorName(winner)) + " " + s_arrEndNames[iEnd]
+                                                                 : string(bFull ? "满盘和棋" : "未分胜负"));
+        }
+        return 0;
+    }
+};
+
+// 一批行：工作线程复盘，主线程按顺序输出
+struct SAuditBatch {
+    vector<string> vecLines;
+    long long llFirstLine;
+    vector<string> vecReports;
+    string strNotes;
+    long long llGames;
+    long long llMoves;
+    long long arrVerdicts[AUDIT_VERDICT_COUNT];
+    bool bDone;
+
+    SAuditBatch() : llFirstLine(0), llGames(0), llMoves(0), arrVerdicts(), bDone(false) {}
+};
+
+static void AuditBatch(SAuditBatch& batch, const AIWeights* pWeights) {
+    SAuditRecord rec;
+    SAuditOutcome out;
+    string strError;
+    for (size_t i = 0; i < batch.vecLines.size(); i++) {
+        const string& strLine = batch.vecLines[i];
+        if (ParseRecord(strLine, rec, strError)) {
+            SAuditReplay replay = { &rec, &out, pWeights, &batch.strNotes };
+            DispatchGame(rec.iSize, rec.iRule, replay);
+            batch.llMoves += (long long)rec.vecMoves.size();
+        } else if (strError.empty()) {
+            continue;
+        } else {
+            out.iVerdict = AUDIT_BAD_FORMAT;
+            out.strDetail = strError;
+        }
+        batch.llGames++;
+        batch.arrVerdicts[out.iVerdict]++;
+        if (out.iVerdict != AUDIT_OK) {
+            size_t iIdEnd = strLine.find_first_of(" \t");
+            batch.vecReports.push_back("第 " + to_string(batch.llFirstLine + (long long)i) + " 行 [" +
+                                       strLine.substr(0, iIdEnd) + "] " + GetAuditVerdictName(out.iVerdict) +
+                                       ": " + out.strDetail);
+        }
+    }
+}
+
+SAuditSummary AuditGameRecords(istream& in, ostream& out, const SAuditOptions& opt) {
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    SAuditSummary summary;
+    AIWeights stWeights; // 标注用默认权重
+    const AIWeights* pWeights = opt.bEval ? &stWeights : nullptr;
+    int iThreads = opt.iThreads > 0 ? opt.iThreads : max(1, (int)thread::hardware_concurrency());
+    size_t iMaxInFlight = (size_t)iThreads * 2 + 1;
+    int iReports = 0;
+
+    CThreadPool pool(iThreads);
+    mutex mtx;
+    condition_variable cv;
+    deque<unique_ptr<SAuditBatch>> queBatches;
+
+    // 输出队首已经做完的批 (按读入顺序)
+    auto fnEmit = [&](bool bWait) {
+        while (!queBatches.empty()) {
+            SAuditBatch& batch = *queBatches.front();
+            {
+                unique_lock<mutex> lock(mtx);
+                if (!batch.bDone && !bWait) return;
+                cv.wait(lock, [&batch] { return batch.bDone; });
+            }
+            for (size_t i = 0; i < batch.vecReports.size(); i++) {
+                if (iReports++ < opt.iMaxReports) out << batch.vecReports[i] << "\n";
+            }
+            if (opt.pNotes != nullptr) *opt.pNotes << batch.strNotes;
+            summary.llGames += batch.llGames;
+            summary.llMoves += batch.llMoves;
+            for (int v = 0; v < AUDIT_VERDICT_COUNT; v++) summary.arrVerdicts[v] += batch.arrVerdicts[v];
+            queBatches.pop_front();
+            if (bWait) return;
+        }
+    };
+
+    long long llLine = 1;
+    while (in) {
+        unique_ptr<SAuditBatch> pBatch(new SAuditBatch());
+        pBatch->llFirstLine = llLine;
+        pBatch->vecLines.resize(AUDIT_BATCH_LINES);
+        int iCount = 0;
+        while (iCount < AUDIT_BATCH_LINES && getline(in, pBatch->vecLines[iCount])) iCount++;
+        pBatch->vecLines.resize(iCount);
+        llLine += iCount;
+        if (iCount == 0) break;
+
+        SAuditBatch* pRaw = pBatch.get();
+        queBatches.push_back(std::move(pBatch));
+        pool.Submit([pRaw, pWeights, &mtx, &cv] {
+            AuditBatch(*pRaw, pWeights);
+            lock_guard<mutex> lock(mtx);
+            pRaw->bDone = true;
+            cv.notify_all();
+        });
+
+        // 在途的批太多时等队首做完，读文件不会跑到复盘前面太远
+        fnEmit(false);
+        while (queBatches.size() >= iMaxInFlight) fnEmit(true);
+    }
+    while (!queBatches.empty()) fnEmit(true);
+    if (iReports > opt.iMaxReports) out << " ... 另有 " << (iReports - opt.iMaxReports) << " 局有问题未列出\n";
+
+    summary.dSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return summary;
+}
+
+// 随机下一局 (与 MCTS 模拟同样的走法)，写成一行记录
+struct SRecordWriter {
+    typedef int ResultType;
+    long long llIndex;
+    int iCorruptPercent;
+    minstd_rand* pRng;
+    string* pLine;
+
+    template <int N, class TRule>
+    int Run() {
+        minstd_rand& rng = *pRng;
+        CBoardT<N> board;
+        vector<Point> vecMoves;
+        bool arrInSet[N * N] = {};
+        int arrCells[N * N];
+        int iCount = 1;
+        arrCells[0] = (N / 2) * N + N / 2;
+        arrInSet[arrCells[0]] = true;
+        int color = BLACK, winner = EMPTY, iEnd = AUDIT_END_NONE;
+
+        // 有一半的对局中途停下，记为 open 或认输
+        int iStop = (rng() % 2 == 0) ? (int)(rng() % (N * N)) : N * N;
+        while (iCount > 0 && (int)vecMoves.size() < iStop) {
+            int k = (int)(rng() % iCount);
+            int iCell = arrCells[k];
+            arrCells[k] = arrCells[--iCount];
+            int x = iCell % N, y = iCell / N;
+            board.PlacePiece(x, y, color);
+            vecMoves.push_back({ x, y });
+            if (CRefereeT<N, TRule>::CheckWin(board, x, y)) {
+                winner = color;
+                iEnd = AUDIT_END_FIVE;
+                break;
+            }
+            if (color == BLACK && CRefereeT<N, TRule>::CheckForbidden(board, x, y)) {
+                winner = WHITE;
+                iEnd = AUDIT_END_FORBIDDEN;
+                break;
+            }
+            for (int ny = max(0, y - 1); ny <= min(N - 1, y + 1); ny++) {
+                for (int nx = max(0, x - 1); nx <= min(N - 1, x + 1); nx++) {
+                    int c = ny * N + nx;
+                    if (!arrInSet[c] && board.IsEmpty(nx, ny)) { arrInSet[c] = true; arrCells[iCount++] = c; }
+                }
+            }
+            color = (color == BLACK) ? WHITE : BLACK;
+        }
+        int iClaimed = winner;
+        if (iEnd == AUDIT_END_NONE && iCount > 0) {
+            iClaimed = (rng() % 2 == 0) ? -1 : (int)(BLACK + rng() % 2);
+            if (iClaimed != -1) iEnd = AUDIT_END_RESIGN;
+        }
+
+        // 故意改坏：结果写反 / 插入一手重复着法 / 终局后多下一手
+        bool bCorrupt = (int)(rng() % 100) < iCorruptPercent;
+        if (bCorrupt) {
+            int iKind = (int)(rng() % 3);
+            if (iKind == 2 && iEnd != AUDIT_END_FIVE && iEnd != AUDIT_END_FORBIDDEN) iKind = 0;
+            if (iKind == 1 && vecMoves.size() < 2) iKind = 0;
+            if (iKind == 0) {
+                iClaimed = (iClaimed == BLACK) ? WHITE : BLACK;
+                if (iEnd == AUDIT_END_RESIGN) iEnd = AUDIT_END_NONE;
+            } else if (iKind == 1) {
+                size_t iAt = 1 + rng() % (vecMoves.size() - 1);
+                vecMoves.insert(vecMoves.begin() + iAt, vecMoves[rng() % iAt]);
+            } else {
+                for (int i = 0; i < N * N; i++) {
+                    if (board.IsEmpty(i % N, i / N)) {
+                        vecMoves.push_back({ i % N, i / N });
+                        break;
+                    }
+                }
+            }
+        }
+
+        string& strLine = *pLine;
+        strLine = "g" + to_string(llIndex) + " " + to_string(N) + " " + TRule::Name() + " ";
+        if (vecMoves.empty()) strLine += "-";
+        for (size_t i = 0; i < vecMoves.size(); i++) {
+            if (i > 0) strLine += ',';
+            strLine += PointToString(vecMoves[i]);
+        }
+        strLine += string(" ") + ColorName(iClaimed);
+        if (iEnd != AUDIT_END_NONE) strLine += string(" ") + s_arrEndNames[iEnd];
+        strLine += '\n';
+        return bCorrupt ? 1 : 0;
+    }
+};
+
+long long WriteRandomGameRecords(ostream& out, long long llGames, int iCorruptPercent, unsigned uSeed) {
+    static const int arrSizes[] = { 15, 19, 20 };
+    static const int arrRules[] = { RULE_RENJU, RULE_STANDARD, RULE_FREESTYLE };
+    minstd_rand rng(uSeed);
+    string strLine;
+    long long llCorrupt = 0;
+    out << "# 随机生成的对局记录：编号 大小 规则 着法 结果 [结束方式]\n";
+    for (long long g = 0; g < llGames; g++) {
+        SRecordWriter writer = { g, iCorruptPercent, &rng, &strLine };
+        llCorrupt += DispatchGame(arrSizes[g % 3], arrRules[(g / 3) % 3], writer);
+        out << strLine;
+    }
+    return llCorrupt;
+}
@@ -0,0 +1,56 @@
+#ifndef _GAMEAUDIT_H_
+#define _GAMEAUDIT_H_
+
+#include "Global.h"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 对局记录文件：每行一局  编号 棋盘大小 规则 着法 结果 [结束方式] [; 说明]
+//   着法与战术题库相同：从空棋盘起黑白交替，逗号分隔，空棋盘写 "-"；规则为 renju / standard / freestyle
+//   结果：black / white / draw / open (还没下完)
+//   结束方式可选：five (成五) / forbidden (黑棋禁手判负) / resign / timeout
+//   棋盘上没分出胜负却判了胜负的，必须写 resign 或 timeout
+// 以 # 开头的行和空行忽略
+
+// 一局的审核结论
+enum EAuditVerdict {
+    AUDIT_OK = 0,
+    AUDIT_BAD_FORMAT,       // 这一行读不懂
+    AUDIT_ILLEGAL_MOVE,     // 落在棋盘外或已有子的格子上
+    AUDIT_MOVES_AFTER_END,  // 已经成五 / 禁手判负之后还有着法
+    AUDIT_WRONG_RESULT,     // 记录的结果 / 结束方式与 CReferee 复盘不符
+    AUDIT_VERDICT_COUNT
+};
+
+const char* GetAuditVerdictName(int iVerdict);
+
+struct SAuditOptions {
+    int iThreads;
+    bool bEval;            // 给每一手标注评分 (慢很多)
+    std::ostream* pNotes;  // 标注输出，bEval 时才用
+    int iMaxReports;       // 最多打印多少局有问题的对局
+};
+
+struct SAuditSummary {
+    long long llGames;
+    long long llMoves;
+    long long arrVerdicts[AUDIT_VERDICT_COUNT];
+    double dSeconds;
+
+    SAuditSummary() : llGames(0), llMoves(0), arrVerdicts(), dSeconds(0) {}
+};
+
+// 流式审核：主线程按批读行，各批交给线程池并行复盘，按原顺序输出
+// 同时在途的批数有上限，内存占用与文件大小无关
+// 复盘只在棋盘上落子，每手只用 CReferee::CheckWin / CheckForbidden 查落子点所在的几条线，不重扫全盘
+// 有问题的对局打印到 out：第几行、编号、结论和细节
+// 标注 (bEval)：每一手写成 着法:评分:全盘最高分，评分是落子方视角的棋型分 (与贪心 AI 同一套)
+SAuditSummary AuditGameRecords(std::istream& in, std::ostream& out, const SAuditOptions& opt);
+
+// 生成随机对局记录 (九种大小/规则混合)，按 iCorruptPercent 的比例故意改坏，用来测吞吐和检查审核结果
+// 返回改坏的局数
+long long WriteRandomGameRecords(std::ostream& out, long long llGames, int iCorruptPercent, unsigned uSeed);
+
+#endif
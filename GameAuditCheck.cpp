@@ -0,0 +1,70 @@
+#include "GameAudit.h"
+#include "Checks.h"
+#include "Referee.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// 对局记录审核：WuZiQiDemo --audit <记录文件|-> [线程数] [标注文件]
+// 用 CReferee 复盘每一局，找出着法非法、终局后还有着法、结果或禁手判定记错的对局；给了标注文件就把每手的评分写进去
+int RunAudit(int argc, char* argv[]) {
+    if (argc < 3) {
+        cout << "用法: --audit <记录文件|-> [线程数] [标注文件]" << endl;
+        return 1;
+    }
+    string strFile = argv[2];
+    SAuditOptions opt;
+    opt.iThreads = (argc > 3) ? atoi(argv[3]) : 0;
+    opt.bEval = argc > 4;
+    opt.pNotes = nullptr;
+    opt.iMaxReports = 50;
+
+    ifstream file;
+    if (strFile != "-") {
+        file.open(strFile);
+        if (!file.is_open()) {
+            cout << "无法打开 " << strFile << endl;
+            return 1;
+        }
+    }
+    ofstream notes;
+    if (opt.bEval) {
+        notes.open(argv[4]);
+        if (!notes.is_open()) {
+            cout << "无法写入 " << argv[4] << endl;
+            return 1;
+        }
+        opt.pNotes = &notes;
+    }
+
+    SAuditSummary sum = AuditGameRecords(strFile == "-" ? cin : file, cout, opt);
+    long long llBad = sum.llGames - sum.arrVerdicts[AUDIT_OK];
+    cout << (llBad == 0 ? "[通过]" : "[有问题]") << " " << sum.llGames << " 局, " << sum.llMoves << " 手, 用时 "
+         << sum.dSeconds << "s (" << (long long)(sum.dSeconds > 0 ? sum.llMoves / sum.dSeconds : 0) << " 手/秒)" << endl;
+    for (int v = AUDIT_OK + 1; v < AUDIT_VERDICT_COUNT; v++) {
+        if (sum.arrVerdicts[v] > 0) cout << " " << GetAuditVerdictName(v) << ": " << sum.arrVerdicts[v] << " 局" << endl;
+    }
+    return llBad == 0 ? 0 : 2;
+}
+
+// 生成测试用的对局记录：WuZiQiDemo --audit-gen <文件> [局数] [改坏的百分比] [种子]
+int RunAuditGen(int argc, char* argv[]) {
+    if (argc < 3) {
+        cout << "用法: --audit-gen <文件> [局数] [改坏的百分比] [种子]" << endl;
+        return 1;
+    }
+    long long llGames = (argc > 3) ? atoll(argv[3]) : 100000;
+    int iCorrupt = (argc > 4) ? atoi(argv[4]) : 1;
+    unsigned uSeed = (argc > 5) ? (unsigned)atoi(argv[5]) : 43;
+    ofstream file(argv[2]);
+    if (!file.is_open()) {
+        cout << "无法写入 " << argv[2] << endl;
+        return 1;
+    }
+    long long llBad = WriteRandomGameRecords(file, llGames, iCorrupt, uSeed);
+    cout << "已写出 " << llGames << " 局到 " << argv[2] << ", 其中故意改坏 " << llBad << " 局" << endl;
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include "GameServer.h"
+#include "Trace.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+// AI 必须在本手截止前这么多毫秒交出结果
+static const int AI_DEADLINE_MARGIN_MS = 500;
+
+static const char* RuleName(int iRule) {
+    if (iRule == RULE_STANDARD) return CStandardRule::Name();
+    if (iRule == RULE_FREESTYLE) return CFreestyleRule::Name();
+    return CRenjuRule::Name();
+}
+
+static const char* ColorTag(int color) {
+    return color == BLACK ? "B" : "W";
+}
+
+CGameServer::CGameServer(int iThreads, shared_ptr<const AIWeights> pWeights)
+    : m_scheduler(iThreads), m_pWeights(pWeights), m_iNextId(1), m_pOut(&cout) {}
+
+CGameServer::~CGameServer() {
+    // 先停调度器，保证没有工作线程再访问 m_pOut
+    m_scheduler.Shutdown();
+}
+
+void CGameServer::Run(istream& in, ostream& out) {
+    m_pOut = &out;
+    string strLine;
+    while (getline(in, strLine)) {
+        if (strLine == "QUIT") break;
+        HandleLine(strLine);
+    }
+    m_scheduler.Shutdown();
+}
+
+void CGameServer::HandleLine(const string& strLine) {
+    istringstream iss(strLine);
+    string strCmd;
+    iss >> strCmd;
+    if (strCmd.empty()) return;
+
+    if (strCmd == "NEW") {
+        int mode = MODE_PVP;
+        int iSize = BOARD_SIZE;
+        string strRule = "renju";
+        int iDepth = 0;
+        iss >> mode >> iSize >> strRule >> iDepth;
+        if (mode < MODE_PVP || mode > MODE_AI_VS_AI) mode = MODE_PVP;
+        if (!IsSupportedBoardSize(iSize)) iSize = BOARD_SIZE;
+        int iRule = RULE_RENJU;
+        if (strRule == "standard") iRule = RULE_STANDARD;
+        else if (strRule == "freestyle") iRule = RULE_FREESTYLE;
+        iDepth = max(0, min(iDepth, SEARCH_MAX_PLY - 1));
+
+        shared_ptr<CGameSession> pSession;
+        {
+            lock_guard<mutex> lock(m_mtxSessions);
+            int iId = m_iNextId++;
+            pSession = CGameSession::Create(iId, mode, iSize, iRule, m_pWeights);
+            if (iDepth > 0) pSession->SetAISearch(iDepth, AI_TT_ENTRIES);
+            m_mapSessions[iId] = pSession;
+        }
+        Emit("NEW " + to_string(pSession->GetId()) + " " + to_string(iSize) + " " + RuleName(iRule));
+
+        lock_guard<mutex> lock(pSession->GetMutex());
+        ScheduleAI(pSession); // AI 执黑时立即开始思考
+        return;
+    }
+
+    if (strCmd == "RESTORE") {
+        // 快照里的旧编号可能已被占用，恢复出来的对局一律用新编号
+        string strFile;
+        iss >> strFile;
+        int iId;
+        {
+            lock_guard<mutex> lock(m_mtxSessions);
+            iId = m_iNextId++;
+        }
+        string strError;
+        shared_ptr<CGameSession> pSession = CGameSession::LoadSnapshot(strFile, iId, m_pWeights, &strError);
+        if (!pSession) {
+            // 编号已经分出去了，报错也用它；原因放在行尾 (文件打不开、版本不对、校验和不对等)
+            Emit("ERR " + to_string(iId) + " restore_failed " + strFile + " " + strError);
+            return;
+        }
+        {
+            lock_guard<mutex> lock(m_mtxSessions);
+            m_mapSessions[iId] = pSession;
+        }
+        Emit("RESTORED " + to_string(iId) + " " + to_string(pSession->GetBoardSize()) + " " +
+             RuleName(pSession->GetRule()));
+
+        lock_guard<mutex> lock(pSession->GetMutex());
+        ScheduleAI(pSession); // 快照时轮到 AI 的话接着思考
+        return;
+    }
+
+    if (strCmd == "STATS") {
+        EmitStats();
+        return;
+    }
+
+    if (strCmd == "TRACE") {
+        // 把到目前为止的时间线写出去 (需要用 --trace 启动)
+        string strFile = "wzq_trace.json";
+        iss >> strFile;
+        if (!CTrace::IsEnabled()) Emit("ERR 0 trace_disabled");
+        else if (!CTrace::Flush(strFile)) Emit("ERR 0 trace_write_failed " + strFile);
+        else Emit("TRACE " + strFile);
+        return;
+    }
+
+    int iId = 0;
+    iss >> iId;
+    shared_ptr<CGameSession> pSession = FindSession(iId);
+    if (!pSession) {
+        Emit("ERR " + to_string(iId) + " no_such_game");
+        return;
+    }
+
+    if (strCmd == "PLAY") {
+        string strPoint;
+        iss >> strPoint;
+        Point p;
+        if (!StringToPoint(strPoint, &p)) {
+            Emit("ERR " + to_string(iId) + " bad_point " + strPoint);
+            return;
+        }
+
+        lock_guard<mutex> lock(pSession->GetMutex());
+        if (pSession->GetState() != SESSION_WAIT_HUMAN) {
+            Emit("ERR " + to_string(iId) + " not_your_turn");
+            return;
+        }
+        int color = pSession->GetTurnColor();
+        ReportMove(*pSession, color, p, pSession->ApplyMove(p));
+        ScheduleAI(pSession);
+    } else if (strCmd == "BOARD") {
+        lock_guard<mutex> lock(pSession->GetMutex());
+        Emit("BOARD " + to_string(iId) + " " + pSession->GetBoardString());
+    } else if (strCmd == "SAVE") {
+        string strFile;
+        iss >> strFile;
+        if (strFile.empty()) {
+            Emit("ERR " + to_string(iId) + " missing_file");
+            return;
+        }
+        string strError;
+        lock_guard<mutex> lock(pSession->GetMutex());
+        if (!pSession->SaveSnapshot(strFile, &strError)) {
+            Emit("ERR " + to_string(iId) + " save_failed " + strFile + " " + strError);
+            return;
+        }
+        Emit("SAVED " + to_string(iId) + " " + strFile);
+    } else if (strCmd == "CLOSE") {
+        // 工作线程里可能还拿着 shared_ptr，等它做完这一手自然释放
+        lock_guard<mutex> lock(m_mtxSessions);
+        m_mapSessions.erase(iId);
+        Emit("CLOSED " + to_string(iId));
+    } else {
+        Emit("ERR " + to_string(iId) + " unknown_command " + strCmd);
+    }
+}
+
+shared_ptr<CGameSession> CGameServer::FindSession(int iId) {
+    lock_guard<mutex> lock(m_mtxSessions);
+    map<int, shared_ptr<CGameSession>>::iterator it = m_mapSessions.find(iId);
+    if (it == m_mapSessions.end()) return shared_ptr<CGameSession>();
+    return it->second;
+}
+
+void CGameServer::ScheduleAI(const shared_ptr<CGameSession>& pSession) {
+    // 搜索用棋盘快照，期间 BOARD / STATS 不会被挡住
+    shared_ptr<CSearchTask> pTask = pSession->CreateAITask();
+    if (!pTask) return;
+    pSession->SetThinking();
+
+    // 留出落子和输出的余量，别卡着 15 秒线交
+    CSearchScheduler::Clock::time_point tpDeadline =
+        pSession->GetTurnDeadline() - chrono::milliseconds(AI_DEADLINE_MARGIN_MS);
+
+    // 开了搜索深度的对局按节点预算搜，排队变长时调度器收紧预算，搜不完的那层丢掉用上一层的结果
+    m_scheduler.Submit(tpDeadline, pSession->GetAINodeBudget(),
+        [pTask](CSearchControl& ctl) { pTask->Run(ctl); },
+        [this, pSession, pTask](CSearchControl&) { FinishAITurn(pSession, pTask); });
+}
+
+void CGameServer::FinishAITurn(shared_ptr<CGameSession> pSession, shared_ptr<CSearchTask> pTask) {
+    lock_guard<mutex> lock(pSession->GetMutex());
+    if (pSession->GetState() != SESSION_AI_THINKING) return;
+
+    int color = pSession->GetTurnColor();
+    Point p = pTask->Finish();
+    ReportMove(*pSession, color, p, pSession->ApplyAIMove(p));
+
+    // 电脑对电脑时重新排队，而不是在这里连下，保证各对局轮流使用线程
+    ScheduleAI(pSession);
+}
+
+void CGameServer::ReportMove(CGameSession& session, int color, Point p, EMoveResult eResult) {
+    string strId = to_string(session.GetId());
+    string strPoint = PointToString(p);
+
+    switch (eResult) {
+    case MOVE_OK:
+        Emit("MOVE " + strId + " " + ColorTag(color) + " " + strPoint);
+        if (session.GetState() == SESSION_FINISHED) {
+            Emit("WIN " + strId + " DRAW full");
+        }
+        break;
+    case MOVE_WIN:
+        Emit("MOVE " + strId + " " + ColorTag(color) + " " + strPoint);
+        Emit("WIN " + strId + " " + ColorTag(color) + " five");
+        break;
+    case MOVE_FORBIDDEN:
+        Emit("FORBIDDEN " + strId + " " + strPoint);
+        break;
+    case MOVE_TIMEOUT_LOSS:
+        Emit("WIN " + strId + " " + ColorTag(session.GetWinner()) + " timeout");
+        break;
+    case MOVE_INVALID:
+        if (session.GetState() == SESSION_FINISHED) {
+            Emit("WIN " + strId + " DRAW full");
+        } else {
+            Emit("ERR " + strId + " invalid " + strPoint);
+        }
+        break;
+    default:
+        Emit("ERR " + strId + " not_your_turn");
+        break;
+    }
+}
+
+void CGameServer::Emit(const string& strLine) {
+    lock_guard<mutex> lock(m_mtxOut);
+    // 管道另一端按行读取，每行都要刷出去
+    *m_pOut << strLine << '\n' << flush;
+}
+
+void CGameServer::EmitStats() {
+    int iSessions = 0, iThinking = 0, iFinished = 0;
+    size_t totalBytes = 0;
+    {
+        lock_guard<mutex> lock(m_mtxSessions);
+        map<int, shared_ptr<CGameSession>>::iterator it;
+        for (it = m_mapSessions.begin(); it != m_mapSessions.end(); ++it) {
+            lock_guard<mutex> lockSession(it->second->GetMutex());
+            iSessions++;
+            if (it->second->GetState() == SESSION_AI_THINKING) iThinking++;
+            if (it->second->GetState() == SESSION_FINISHED) iFinished++;
+            totalBytes += it->second->GetFootprint();
+        }
+    }
+
+    SSchedulerStats stSched = m_scheduler.GetStats();
+
+    ostringstream oss;
+    oss << "STATS sessions=" << iSessions
+        << " thinking=" << iThinking
+        << " finished=" << iFinished
+        << " threads=" << m_scheduler.GetThreadCount()
+        << " queued=" << stSched.iQueueDepth
+        << " max_queued=" << stSched.iMaxQueueDepth
+        << " running=" << stSched.iRunning
+        << " searches=" << stSched.llCompleted
+        << " deadline_misses=" << stSched.llDeadlineMisses
+        << " max_late_ms=" << stSched.dMaxLatenessMs
+        << " avg_wait_ms=" << stSched.dAvgWaitMs
+        << " budget_shrinks=" << stSched.llBudgetShrinks
+        << " threads_shed=" << stSched.llThreadsShed
+        << " ns_per_node=" << stSched.dNsPerNode
+        << " bytes_total=" << totalBytes
+        << " bytes_per_session=" << (iSessions > 0 ? totalBytes / iSessions : 0)
+        << " shared_weights_bytes=" << sizeof(AIWeights);
+    Emit(oss.str());
+}
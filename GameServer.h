@@ -0,0 +1,68 @@
+#ifndef _GAMESERVER_H_
+#define _GAMESERVER_H_
+
+#include "GameSession.h"
+#include "SearchScheduler.h"
+#include "AIPlayer.h"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// 多局对弈服务器：一个进程托管大量对局，通过标准输入/输出 (管道) 收发文本协议
+//
+// 请求 (每行一条)：
+//   NEW <模式1-4> [大小15/19/20] [规则renju/standard/freestyle] [搜索深度]
+//                        创建对局       -> NEW <id> <大小> <规则>
+//                        (搜索深度默认 0 为一层贪心，>0 时 AI 用 Alpha-Beta，每手预算 AI_SEARCH_NODES 个节点)
+//   PLAY <id> <坐标>     人类落子       -> MOVE / FORBIDDEN / WIN / ERR
+//   BOARD <id>           查询棋盘       -> BOARD <id> <大小*大小个字符>
+//   CLOSE <id>           关闭对局       -> CLOSED <id>
+//   SAVE <id> <文件>     保存快照       -> SAVED <id> <文件> (AI 思考中也可以存)
+//                                          失败 -> ERR <id> save_failed <文件> <原因>
+//   RESTORE <文件>       从快照恢复     -> RESTORED <新id> <大小> <规则> (轮到 AI 时接着思考)
+//                                          失败 -> ERR <新id> restore_failed <文件> <原因>
+//   STATS                统计信息       -> STATS key=value ... (含调度器排队深度、超时次数)
+//   TRACE [文件]         导出时间线     -> TRACE <文件> (需要以 --trace 启动)
+//   QUIT                 退出
+// 异步事件 (AI 落子后由工作线程发出)：
+//   MOVE <id> <B|W> <坐标>
+//   WIN <id> <B|W|DRAW> <five|timeout|full>
+class CGameServer {
+public:
+    CGameServer(int iThreads, std::shared_ptr<const AIWeights> pWeights);
+    ~CGameServer();
+
+    // 阻塞读取请求直到 QUIT 或输入结束
+    void Run(std::istream& in, std::ostream& out);
+
+    // 处理一行请求 (线程安全)
+    void HandleLine(const std::string& strLine);
+
+private:
+    CSearchScheduler m_scheduler;    // AI 落子请求按截止时间调度
+    std::shared_ptr<const AIWeights> m_pWeights; // 所有对局共享的只读权重
+    std::map<int, std::shared_ptr<CGameSession>> m_mapSessions;
+    std::mutex m_mtxSessions;
+    int m_iNextId;
+
+    std::ostream* m_pOut;
+    std::mutex m_mtxOut; // 多个工作线程会同时输出，按行加锁
+
+    std::shared_ptr<CGameSession> FindSession(int iId);
+
+    // 如果轮到 AI，就把这一手提交给调度器 (调用时必须持有对局锁)
+    void ScheduleAI(const std::shared_ptr<CGameSession>& pSession);
+
+    // 搜索结束后由调度器的工作线程调用
+    void FinishAITurn(std::shared_ptr<CGameSession> pSession, std::shared_ptr<CSearchTask> pTask);
+
+    // 把落子结果翻译成协议输出
+    void ReportMove(CGameSession& session, int color, Point p, EMoveResult eResult);
+
+    void Emit(const std::string& strLine);
+    void EmitStats();
+};
+
+#endif
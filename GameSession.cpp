@@ -0,0 +1,348 @@
+#include "GameSession.h"
+#include "Board.h"
+#include "Referee.h"
+#include "ByteIO.h"
+#include "MappedFile.h"
+#include <cctype>
+#include <cstring>
+
+using namespace std;
+
+string PointToString(Point p) {
+    string s = "";
+    s += (char)('A' + p.iX);
+    s += to_string(p.iY + 1);
+    return s;
+}
+
+bool StringToPoint(const string& str, Point* pOut) {
+    if (str.length() < 2) return false;
+
+    char colChar = toupper(str[0]);
+    if (colChar < 'A' || colChar > 'Z') return false;
+
+    int y = -1;
+    try {
+        y = stoi(str.substr(1)) - 1;
+    } catch (...) {
+        return false;
+    }
+    pOut->iX = colChar - 'A';
+    pOut->iY = y;
+    return true;
+}
+
+// ============================================================================
+// CGameSession：通用部分
+// ============================================================================
+CGameSession::CGameSession(int iId, int iMode, int iBoardSize, int iRule)
+    : m_iId(iId), m_iMode(iMode), m_iBoardSize(iBoardSize), m_iRule(iRule),
+      m_eState(SESSION_WAIT_HUMAN),
+      m_bBlackIsAI(iMode == MODE_HUMAN_WHITE || iMode == MODE_AI_VS_AI),
+      m_bWhiteIsAI(iMode == MODE_HUMAN_BLACK || iMode == MODE_AI_VS_AI),
+      m_bIsBlackTurn(true), m_iRound(1),
+      m_iBlackWarnings(0), m_iWhiteWarnings(0), m_iWinner(EMPTY) {
+    m_tpTurnStart = chrono::steady_clock::now();
+}
+
+int CGameSession::GetTurnColor() const {
+    return m_bIsBlackTurn ? BLACK : WHITE;
+}
+
+bool CGameSession::IsAITurn() const {
+    if (m_eState == SESSION_FINISHED) return false;
+    return m_bIsBlackTurn ? m_bBlackIsAI : m_bWhiteIsAI;
+}
+
+int CGameSession::GetWarnings(int color) const {
+    return color == BLACK ? m_iBlackWarnings : m_iWhiteWarnings;
+}
+
+chrono::steady_clock::time_point CGameSession::GetTurnDeadline() const {
+    return m_tpTurnStart + chrono::milliseconds(MOVE_TIME_LIMIT_MS);
+}
+
+bool CGameSession::ChargeTimeout() {
+    // 规则：每手不超过15秒，重下不重置计时器
+    if (chrono::steady_clock::now() <= GetTurnDeadline()) return false;
+
+    int& warnings = m_bIsBlackTurn ? m_iBlackWarnings : m_iWhiteWarnings;
+    warnings++;
+    if (warnings < 3) return false;
+
+    m_iWinner = m_bIsBlackTurn ? WHITE : BLACK;
+    m_eState = SESSION_FINISHED;
+    return true;
+}
+
+void CGameSession::RecordMove(Point p) {
+    m_vecHistory.push_back((m_bIsBlackTurn ? "黑: " : "白: ") + PointToString(p));
+
+    m_bIsBlackTurn = !m_bIsBlackTurn;
+    m_iRound++;
+    m_tpTurnStart = chrono::steady_clock::now();
+
+    if (m_iRound > m_iBoardSize * m_iBoardSize) {
+        m_eState = SESSION_FINISHED; // 下满了，和棋
+    } else {
+        m_eState = SESSION_WAIT_HUMAN; // AI 的回合由服务器改成 SESSION_AI_THINKING
+    }
+}
+
+EMoveResult CGameSession::ApplyAIMove(Point p) {
+    EMoveResult eResult = ApplyMove(p);
+    if (eResult == MOVE_INVALID || eResult == MOVE_FORBIDDEN) {
+        // AI 自己会避开禁手；真走到这里说明棋盘已满，按和棋处理
+        m_eState = SESSION_FINISHED;
+    }
+    return eResult;
+}
+
+size_t CGameSession::GetBaseFootprint() const {
+    size_t bytes = m_vecHistory.capacity() * sizeof(string);
+    for (size_t i = 0; i < m_vecHistory.size(); i++) {
+        // 短字符串存在 string 对象内部，超出部分才在堆上
+        if (m_vecHistory[i].capacity() > 15) bytes += m_vecHistory[i].capacity() + 1;
+    }
+    return bytes;
+}
+
+// ============================================================================
+// CGameSessionT：按棋盘大小和规则特化的部分
+// ============================================================================
+template <int N, class TRule>
+class CGameSessionT : public CGameSession {
+public:
+    typedef CRefereeT<N, TRule> Referee;
+    typedef CAIPlayerT<N, TRule> AIPlayer;
+
+    CGameSessionT(int iId, int iMode, int iRule, shared_ptr<const AIWeights> pWeights)
+        : CGameSession(iId, iMode, N, iRule) {
+        if (m_bBlackIsAI) m_pBlackAI.reset(new AIPlayer(BLACK, pWeights));
+        if (m_bWhiteIsAI) m_pWhiteAI.reset(new AIPlayer(WHITE, pWeights));
+    }
+
+    virtual EMoveResult ApplyMove(Point p) override {
+        if (m_eState == SESSION_FINISHED) return MOVE_NOT_YOUR_TURN;
+        if (!m_board.IsValid(p.iX, p.iY) || !m_board.IsEmpty(p.iX, p.iY)) return MOVE_INVALID;
+
+        if (ChargeTimeout()) return MOVE_TIMEOUT_LOSS;
+
+        int color = GetTurnColor();
+        m_board.PlacePiece(p.iX, p.iY, color);
+
+        // A. 检查胜利
+        if (Referee::CheckWin(m_board, p.iX, p.iY)) {
+            m_iWinner = color;
+            m_eState = SESSION_FINISHED;
+            return MOVE_WIN;
+        }
+
+        // B. 检查禁手
+        if (m_bIsBlackTurn && Referee::CheckForbidden(m_board, p.iX, p.iY)) {
+            m_board.UndoPiece(p.iX, p.iY);
+            return MOVE_FORBIDDEN;
+        }
+
+        RecordMove(p);
+        return MOVE_OK;
+    }
+
+    virtual shared_ptr<CSearchTask> CreateAITask() override {
+        if (!IsAITurn()) return shared_ptr<CSearchTask>();
+        AIPlayer& ai = m_bIsBlackTurn ? *m_pBlackAI : *m_pWhiteAI;
+        return make_shared<CAISearchTaskT<N, TRule>>(ai, m_board);
+    }
+
+    virtual long long GetAINodeBudget() const override {
+        const AIPlayer* pAI = m_bIsBlackTurn ? m_pBlackAI.get() : m_pWhiteAI.get();
+        if (pAI && pAI->GetSearchDepth() > 0) return AI_SEARCH_NODES;
+        return (long long)N * N;
+    }
+
+    virtual string GetBoardString() const override {
+        string s;
+        s.reserve(N * N);
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                int iPiece = m_board.GetPiece(x, y);
+                s += (iPiece == BLACK) ? 'X' : (iPiece == WHITE) ? 'O' : '.';
+            }
+        }
+        return s;
+    }
+
+    virtual size_t GetFootprint() const override {
+        size_t bytes = sizeof(*this) + GetBaseFootprint();
+        if (m_pBlackAI) bytes += sizeof(AIPlayer);
+        if (m_pWhiteAI) bytes += sizeof(AIPlayer);
+        return bytes;
+    }
+
+    virtual void SetAISearch(int iDepth, size_t iTTEntries) override {
+        AIPlayer* arrAI[2] = { m_pBlackAI.get(), m_pWhiteAI.get() };
+        for (int i = 0; i < 2; i++) {
+            if (!arrAI[i]) continue;
+            arrAI[i]->SetSearchDepth(iDepth);
+            arrAI[i]->SetTTEntries(iTTEntries);
+        }
+    }
+
+protected:
+    // 棋盘 N*N 字节 (0 空 / 1 黑 / 2 白) 和它的校验和，然后是执黑、执白 AI 的状态 (人类一方没有)
+    virtual void WriteEngineState(vector<uint8_t>& v) const override {
+        size_t iStart = v.size();
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) v.push_back((uint8_t)m_board.GetPiece(x, y));
+        }
+        PutU64(v, HashWords(&v[iStart], N * N));
+        if (m_pBlackAI) m_pBlackAI->SaveState(v);
+        if (m_pWhiteAI) m_pWhiteAI->SaveState(v);
+    }
+
+    virtual bool ReadEngineState(const uint8_t* p, size_t iBytes) override {
+        if (iBytes < (size_t)(N * N + 8) || HashWords(p, N * N) != GetU64(p + N * N)) return false;
+        m_board.Reset();
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                uint8_t uPiece = p[y * N + x];
+                if (uPiece > WHITE) return false;
+                if (uPiece != EMPTY) m_board.PlacePiece(x, y, uPiece);
+            }
+        }
+        size_t iAt = N * N + 8;
+        AIPlayer* arrAI[2] = { m_pBlackAI.get(), m_pWhiteAI.get() };
+        for (int i = 0; i < 2; i++) {
+            if (!arrAI[i]) continue;
+            size_t iUsed = arrAI[i]->LoadState(p + iAt, iBytes - iAt);
+            if (iUsed == 0) return false;
+            iAt += iUsed;
+        }
+        return iAt == iBytes;
+    }
+
+private:
+    CBoardT<N> m_board;
+    unique_ptr<AIPlayer> m_pBlackAI; // 为空表示该方是人类
+    unique_ptr<AIPlayer> m_pWhiteAI;
+};
+
+// 开局时的唯一一次运行时分发
+struct SSessionFactory {
+    typedef shared_ptr<CGameSession> ResultType;
+
+    int iId;
+    int iMode;
+    int iRule;
+    shared_ptr<const AIWeights> pWeights;
+
+    template <int N, class TRule>
+    ResultType Run() {
+        return make_shared<CGameSessionT<N, TRule>>(iId, iMode, iRule, pWeights);
+    }
+};
+
+shared_ptr<CGameSession> CGameSession::Create(int iId, int iMode, int iBoardSize, int iRule,
+                                              shared_ptr<const AIWeights> pWeights) {
+    SSessionFactory factory = { iId, iMode, iRule, pWeights };
+    return DispatchGame(iBoardSize, iRule, factory);
+}
+
+// ============================================================================
+// 快照
+// ============================================================================
+// "WZQG" 版本 棋盘大小 规则 模式 编号 状态 是否黑方走 轮次 黑警告 白警告 胜者 (各 4 字节)
+// 着法记录条数，每条 4 字节长度 + 文本，以上部分的 HashWords (8 字节)；然后是 WriteEngineState 的内容
+// 不再整个文件算一遍校验和：置换表占了文件的绝大部分，由 AI 在拷出映射时顺带校验
+static const size_t SNAPSHOT_HEADER_BYTES = 52;
+
+bool CGameSession::SaveSnapshot(const string& strFile, string* pError) const {
+    vector<uint8_t> v;
+    v.push_back('W'); v.push_back('Z'); v.push_back('Q'); v.push_back('G');
+    PutU32(v, SNAPSHOT_FILE_VERSION);
+    PutU32(v, (uint32_t)m_iBoardSize);
+    PutU32(v, (uint32_t)m_iRule);
+    PutU32(v, (uint32_t)m_iMode);
+    PutU32(v, (uint32_t)m_iId);
+    PutU32(v, (uint32_t)m_eState);
+    PutU32(v, m_bIsBlackTurn ? 1u : 0u);
+    PutU32(v, (uint32_t)m_iRound);
+    PutU32(v, (uint32_t)m_iBlackWarnings);
+    PutU32(v, (uint32_t)m_iWhiteWarnings);
+    PutU32(v, (uint32_t)m_iWinner);
+    PutU32(v, (uint32_t)m_vecHistory.size());
+    for (size_t i = 0; i < m_vecHistory.size(); i++) {
+        PutU32(v, (uint32_t)m_vecHistory[i].size());
+        v.insert(v.end(), m_vecHistory[i].begin(), m_vecHistory[i].end());
+    }
+    PutU64(v, HashWords(v.data(), v.size()));
+    WriteEngineState(v);
+    return WriteFileAtomic(strFile, v, pError);
+}
+
+shared_ptr<CGameSession> CGameSession::LoadSnapshot(const string& strFile, int iId,
+                                                    shared_ptr<const AIWeights> pWeights, string* pError) {
+    CMappedFile file;
+    if (!file.Open(strFile, pError)) return shared_ptr<CGameSession>();
+    const uint8_t* p = file.GetData();
+    size_t iSize = file.GetSize();
+
+    if (iSize < SNAPSHOT_HEADER_BYTES || memcmp(p, "WZQG", 4) != 0) {
+        if (pError) *pError = "不是对局快照";
+        return shared_ptr<CGameSession>();
+    }
+    if (GetU32(p + 4) != SNAPSHOT_FILE_VERSION) {
+        if (pError) *pError = "快照版本不匹配";
+        return shared_ptr<CGameSession>();
+    }
+
+    // 先找到对局段的结尾，核对校验和之后再相信里面的字段
+    uint32_t uHistory = GetU32(p + 48);
+    size_t iAt = SNAPSHOT_HEADER_BYTES;
+    for (uint32_t i = 0; i < uHistory; i++) {
+        if (iSize - iAt < 4 || iSize - iAt - 4 < GetU32(p + iAt)) {
+            if (pError) *pError = "着法记录被截断";
+            return shared_ptr<CGameSession>();
+        }
+        iAt += 4 + GetU32(p + iAt);
+    }
+    if (iSize - iAt < 8 || HashWords(p, iAt) != GetU64(p + iAt)) {
+        if (pError) *pError = "校验和不对，快照已损坏";
+        return shared_ptr<CGameSession>();
+    }
+
+    int iBoardSize = (int)GetU32(p + 8);
+    int iRule = (int)GetU32(p + 12);
+    int iMode = (int)GetU32(p + 16);
+    int iState = (int)GetU32(p + 24);
+    int iWinner = (int)GetU32(p + 44);
+    if (!IsSupportedBoardSize(iBoardSize) || iRule < RULE_RENJU || iRule > RULE_FREESTYLE ||
+        iMode < MODE_PVP || iMode > MODE_AI_VS_AI || iState < SESSION_WAIT_HUMAN || iState > SESSION_FINISHED ||
+        iWinner < EMPTY || iWinner > WHITE) {
+        if (pError) *pError = "快照头部的字段不合法";
+        return shared_ptr<CGameSession>();
+    }
+
+    shared_ptr<CGameSession> pSession = Create(iId, iMode, iBoardSize, iRule, pWeights);
+    CGameSession& s = *pSession;
+    s.m_eState = (iState == SESSION_AI_THINKING) ? SESSION_WAIT_HUMAN : (ESessionState)iState;
+    s.m_bIsBlackTurn = GetU32(p + 28) != 0;
+    s.m_iRound = (int)GetU32(p + 32);
+    s.m_iBlackWarnings = (int)GetU32(p + 36);
+    s.m_iWhiteWarnings = (int)GetU32(p + 40);
+    s.m_iWinner = iWinner;
+    s.m_tpTurnStart = chrono::steady_clock::now();
+
+    s.m_vecHistory.reserve(uHistory);
+    for (size_t iRead = SNAPSHOT_HEADER_BYTES; iRead < iAt;) {
+        size_t iLen = GetU32(p + iRead);
+        s.m_vecHistory.push_back(string((const char*)p + iRead + 4, iLen));
+        iRead += 4 + iLen;
+    }
+    iAt += 8;
+    if (!s.ReadEngineState(p + iAt, iSize - iAt)) {
+        if (pError) *pError = "棋盘或 AI 状态不完整，或校验和不对";
+        return shared_ptr<CGameSession>();
+    }
+    return pSession;
+}
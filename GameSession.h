@@ -0,0 +1,153 @@
+#ifndef _GAMESESSION_H_
+#define _GAMESESSION_H_
+
+#include "AIPlayer.h"
+#include "SearchControl.h"
+#include "Rules.h"
+#include "Global.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+// 对局状态机：一个对局只是一份数据，没有自己的线程
+enum ESessionState {
+    SESSION_WAIT_HUMAN = 0,  // 等待人类 (协议端) 落子
+    SESSION_AI_THINKING,     // 已提交给调度器，等待 AI 落子
+    SESSION_FINISHED         // 对局结束
+};
+
+// 一次落子的结果
+enum EMoveResult {
+    MOVE_OK = 0,        // 落子成功，轮到对方
+    MOVE_INVALID,       // 越界或已有子
+    MOVE_FORBIDDEN,     // 黑棋禁手，需重下
+    MOVE_WIN,           // 落子方获胜
+    MOVE_TIMEOUT_LOSS,  // 落子方超时满 3 次判负
+    MOVE_NOT_YOUR_TURN  // 当前不是人类落子阶段
+};
+
+// 对局快照文件格式版本
+const uint32_t SNAPSHOT_FILE_VERSION = 2;
+
+// 每手限时 (毫秒)
+const int MOVE_TIME_LIMIT_MS = 15000;
+
+// 对局模式 (与 main 的菜单一致，另加一个电脑对电脑)
+enum ESessionMode {
+    MODE_PVP = 1,       // 人人对战
+    MODE_HUMAN_BLACK,   // 人执黑，AI执白
+    MODE_HUMAN_WHITE,   // AI执黑，人执白
+    MODE_AI_VS_AI       // 电脑对电脑 (压测用)
+};
+
+// 对局基类：与棋盘大小/规则无关的部分
+// 具体的棋盘、裁判和 AI 在 GameSession.cpp 的 CGameSessionT<N, TRule> 里，
+// 只在 Create 时根据大小和规则分发一次
+class CGameSession {
+public:
+    virtual ~CGameSession() {}
+
+    // 创建对局：iBoardSize 为 15/19/20，iRule 见 ERuleType
+    static std::shared_ptr<CGameSession> Create(int iId, int iMode, int iBoardSize, int iRule,
+                                                std::shared_ptr<const AIWeights> pWeights);
+
+    int GetId() const { return m_iId; }
+    ESessionState GetState() const { return m_eState; }
+    int GetBoardSize() const { return m_iBoardSize; }
+    int GetRule() const { return m_iRule; }
+
+    // 当前执子颜色
+    int GetTurnColor() const;
+
+    // 当前这一手是否由 AI 下
+    bool IsAITurn() const;
+
+    // 标记已提交 AI 任务 (由服务器在持有锁时调用)
+    void SetThinking() { m_eState = SESSION_AI_THINKING; }
+
+    // 落子并裁决，规则与 main 的主循环完全一致
+    virtual EMoveResult ApplyMove(Point p) = 0;
+
+    // 为当前执子的 AI 创建一次搜索 (用棋盘快照)，人类回合返回空
+    virtual std::shared_ptr<CSearchTask> CreateAITask() = 0;
+
+    // 这一手搜索的节点预算：贪心一次评完全盘，记 N*N；开了搜索深度时为 AI_SEARCH_NODES
+    virtual long long GetAINodeBudget() const = 0;
+
+    // 本手的截止时间 (超过就记一次超时警告)
+    std::chrono::steady_clock::time_point GetTurnDeadline() const;
+
+    // AI 思考完毕后落子；AI 无子可下时按和棋结束
+    EMoveResult ApplyAIMove(Point p);
+
+    // 胜者颜色 (未结束时为 EMPTY)
+    int GetWinner() const { return m_iWinner; }
+
+    int GetWarnings(int color) const;
+
+    // 棋盘快照：N*N 个字符，. 空 / X 黑 / O 白
+    virtual std::string GetBoardString() const = 0;
+
+    // 估算本对局占用的内存 (不含共享的只读权重)
+    virtual size_t GetFootprint() const = 0;
+
+    // 对局里 AI 的搜索设置 (默认一层贪心)：iDepth > 0 时用 Alpha-Beta，置换表 iTTEntries 条
+    virtual void SetAISearch(int iDepth, size_t iTTEntries) = 0;
+
+    // 快照：对局 (棋盘、着法记录、轮次、双方警告、胜负) 和双方 AI 的状态 (搜索设置、随机数、整张置换表) 写进一个文件
+    // 调用方要持有对局锁；AI 思考中也可以存 (置换表槽位是原子的，搜索期间不动 AI 的其他状态)；先写临时文件再改名
+    bool SaveSnapshot(const std::string& strFile, std::string* pError) const;
+
+    // 从快照恢复对局：文件映射进内存，核对版本后逐段校验并直接从映射里还原，AI 接着用快照里的置换表
+    // 每段 (对局、棋盘、每个 AI) 各带一个按 8 字节算的校验和，置换表在拷出映射的同一遍里校验
+    // 本手计时从恢复时算起；快照时 AI 正在思考的对局恢复成等待状态，由服务器重新提交
+    // iId 是恢复后的对局编号 (服务器分配新的，快照里的旧编号可能已被占用)
+    static std::shared_ptr<CGameSession> LoadSnapshot(const std::string& strFile, int iId,
+                                                      std::shared_ptr<const AIWeights> pWeights, std::string* pError);
+
+    // 对局锁：服务器和工作线程操作同一对局时必须持有
+    std::mutex& GetMutex() { return m_mtx; }
+
+protected:
+    CGameSession(int iId, int iMode, int iBoardSize, int iRule);
+
+    int m_iId;
+    int m_iMode;
+    int m_iBoardSize;
+    int m_iRule;
+    ESessionState m_eState;
+    std::vector<std::string> m_vecHistory;
+    bool m_bBlackIsAI;
+    bool m_bWhiteIsAI;
+    bool m_bIsBlackTurn;
+    int m_iRound;
+    int m_iBlackWarnings;
+    int m_iWhiteWarnings;
+    int m_iWinner;
+    std::chrono::steady_clock::time_point m_tpTurnStart; // 本手开始时间
+    std::mutex m_mtx;
+
+    // 快照里按大小/规则特化的部分：棋盘和双方 AI，各自带校验和；读的时候必须正好用完 iBytes
+    virtual void WriteEngineState(std::vector<uint8_t>& v) const = 0;
+    virtual bool ReadEngineState(const uint8_t* p, size_t iBytes) = 0;
+
+    // 超时记一次警告，满 3 次判负并返回 true
+    bool ChargeTimeout();
+
+    // 记录这一手并切换到下一手
+    void RecordMove(Point p);
+
+    // 不含棋盘和 AI 的那部分内存
+    size_t GetBaseFootprint() const;
+};
+
+// 坐标转字符串 (如 H8)，与 main 的历史记录格式一致
+std::string PointToString(Point p);
+
+// 字符串转坐标，失败返回 false (是否越界由棋盘判断)
+bool StringToPoint(const std::string& str, Point* pOut);
+
+#endif
@@ -0,0 +1,90 @@
+#include "GameSession.h"
+#include "Checks.h"
+#include "AIPlayer.h"
+#include "Rules.h"
+#include "SearchControl.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+// 快照的保存 / 恢复延迟：WuZiQiDemo --bench-snapshot [深度] [手数] [文件]
+// 置换表从 2^16 到 2^22 条，每种大小下电脑对电脑先下几手把置换表填热，再各存、取 5 次取平均
+// 恢复的对局再存一次必须与原文件逐字节相同；改掉开头、中间或最后的一个字节都必须被校验和拒绝
+int RunSnapshotBench(int argc, char* argv[]) {
+    int iDepth = (argc > 2) ? atoi(argv[2]) : 3;
+    int iPlies = (argc > 3) ? atoi(argv[3]) : 6;
+    string strFile = (argc > 4) ? argv[4] : "bench_snapshot.bin";
+    string strCopy = strFile + ".copy";
+    shared_ptr<const AIWeights> pWeights = make_shared<AIWeights>();
+    const int REPEATS = 5;
+
+    auto ReadAll = [](const string& strName) {
+        ifstream file(strName, ios::binary);
+        return string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    };
+
+    int iFailures = 0;
+    cout << "深度 " << iDepth << ", 先下 " << iPlies << " 手" << endl;
+    for (int iShift = 16; iShift <= 22; iShift += 2) {
+        size_t iEntries = (size_t)1 << iShift;
+        shared_ptr<CGameSession> pSession = CGameSession::Create(1, MODE_AI_VS_AI, 15, RULE_RENJU, pWeights);
+        pSession->SetAISearch(iDepth, iEntries);
+        for (int i = 0; i < iPlies && pSession->IsAITurn(); i++) {
+            shared_ptr<CSearchTask> pTask = pSession->CreateAITask();
+            CSearchControl ctl = CSearchControl::Unlimited();
+            pTask->Run(ctl);
+            pSession->ApplyAIMove(pTask->Finish());
+        }
+
+        string strError;
+        auto tpStart = chrono::steady_clock::now();
+        bool bOk = true;
+        for (int k = 0; k < REPEATS && bOk; k++) bOk = pSession->SaveSnapshot(strFile, &strError);
+        double dSaveMs = chrono::duration<double, milli>(chrono::steady_clock::now() - tpStart).count() / REPEATS;
+
+        shared_ptr<CGameSession> pRestored;
+        tpStart = chrono::steady_clock::now();
+        for (int k = 0; k < REPEATS && bOk; k++) {
+            pRestored = CGameSession::LoadSnapshot(strFile, pSession->GetId(), pWeights, &strError);
+            bOk = pRestored != nullptr;
+        }
+        double dLoadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - tpStart).count() / REPEATS;
+        if (!bOk) {
+            cout << "置换表 2^" << iShift << ": 失败: " << strError << endl;
+            iFailures++;
+            continue;
+        }
+
+        string strOriginal = ReadAll(strFile);
+        bool bSame = pRestored->SaveSnapshot(strCopy, &strError) && ReadAll(strCopy) == strOriginal &&
+                     pRestored->GetBoardString() == pSession->GetBoardString();
+
+        // 分别改掉对局段 (编号)、置换表中间和最后一个字节，每处都必须被发现
+        bool bRejected = true;
+        size_t arrOffsets[3] = { 20, strOriginal.size() / 2, strOriginal.size() - 1 };
+        for (int k = 0; k < 3; k++) {
+            string strBroken = strOriginal;
+            strBroken[arrOffsets[k]] ^= 0x5a;
+            {
+                ofstream file(strCopy, ios::binary);
+                file.write(strBroken.data(), (streamsize)strBroken.size());
+            }
+            if (CGameSession::LoadSnapshot(strCopy, pSession->GetId(), pWeights, &strError) != nullptr) bRejected = false;
+        }
+
+        cout << "置换表 2^" << iShift << ": 文件 " << strOriginal.size() / 1024 << " KB"
+             << "  保存 " << dSaveMs << " ms  恢复 " << dLoadMs << " ms"
+             << "  往返" << (bSame ? "一致" : "不一致") << "  损坏" << (bRejected ? "已拒绝" : "未发现") << endl;
+        if (!bSame || !bRejected) iFailures++;
+    }
+    remove(strFile.c_str());
+    remove(strCopy.c_str());
+    return iFailures == 0 ? 0 : 1;
+}
@@ -2,9 +2,12 @@
 #ifndef _GLOBAL_H_
 #define _GLOBAL_H_
 
-// 棋盘大小
+// 默认棋盘大小 (其他大小见 Rules.h 中的 WZQ_FOR_EACH_SIZE)
 const int BOARD_SIZE = 15;
 
+// 支持的最大棋盘 (20x20 比赛棋盘)，用于按最大值预留的缓冲区
+const int MAX_BOARD_SIZE = 20;
+
 // 棋子类型枚举
 enum PieceType {
     EMPTY = 0,  // 空位
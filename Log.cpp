@@ -0,0 +1,303 @@
+#include "Log.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+atomic<int> CLog::s_atLevel(LOG_INFO);
+atomic<int> CLog::s_atCategories(LOG_CAT_ALL);
+
+namespace {
+
+const int LOG_MAX_THREADS = 256;  // 超出的线程不再分配缓冲区，记录直接算丢弃
+const int LOG_DRAIN_MS = 20;      // 后台线程多久取一次
+
+// 一个线程的环形缓冲区：所属线程写 atHead，输出方写 atTail，两边都不加锁
+struct SLogRing {
+    int iTid;
+    atomic<uint64_t> atHead;   // 写入的总数
+    atomic<uint64_t> atTail;   // 已输出的总数
+    atomic<long long> atDropped;
+    SLogRecord arrRecords[LOG_RING_SIZE];
+};
+
+struct SLogState {
+    mutex mtxRegister;                     // 只在线程第一次写日志时用
+    SLogRing* arrRings[LOG_MAX_THREADS];
+    atomic<int> atRingCount;
+    atomic<long long> atOverflow;          // 没分到缓冲区的线程丢掉的记录
+
+    mutex mtxDrain;                        // 同一时间只有一方在取记录、写输出
+    bool bConsole;
+    FILE* pFile;
+
+    mutex mtxWake;
+    condition_variable cvWake;
+    atomic<bool> atWakeRequested;          // 有缓冲区过了水位线，已经通知过还没取
+    bool bStop;
+    thread drainer;
+
+    SLogState() : atRingCount(0), atOverflow(0), bConsole(true), pFile(nullptr), atWakeRequested(false), bStop(false) {}
+    ~SLogState();
+};
+
+SLogState& GetState() {
+    static SLogState s_state;
+    return s_state;
+}
+
+chrono::steady_clock::time_point GetEpoch() {
+    static const chrono::steady_clock::time_point s_tpEpoch = chrono::steady_clock::now();
+    return s_tpEpoch;
+}
+
+const char* CategoryName(int iCategory) {
+    if (iCategory & LOG_CAT_AI) return "ai";
+    if (iCategory & LOG_CAT_SEARCH) return "search";
+    if (iCategory & LOG_CAT_LEARN) return "learn";
+    if (iCategory & LOG_CAT_IO) return "io";
+    if (iCategory & LOG_CAT_SERVER) return "server";
+    return "misc";
+}
+
+const char* LevelName(int iLevel) {
+    static const char* s_arrNames[] = { "debug", "info", "warn", "error" };
+    return (iLevel >= LOG_DEBUG && iLevel <= LOG_ERROR) ? s_arrNames[iLevel] : "info";
+}
+
+void AppendJsonString(string& strOut, const char* pText) {
+    strOut += '"';
+    for (const char* p = pText; *p; p++) {
+        if (*p == '"' || *p == '\\') strOut += '\\';
+        if ((unsigned char)*p < 0x20) strOut += ' ';
+        else strOut += *p;
+    }
+    strOut += '"';
+}
+
+void AppendValue(string& strOut, const SLogField& field, bool bJson) {
+    char szBuf[64];
+    if (field.iType == LOG_FIELD_INT) {
+        snprintf(szBuf, sizeof(szBuf), "%lld", field.llValue);
+        strOut += szBuf;
+    } else if (field.iType == LOG_FIELD_REAL) {
+        snprintf(szBuf, sizeof(szBuf), "%g", field.dValue);
+        strOut += szBuf;
+    } else if (bJson) {
+        AppendJsonString(strOut, field.szText);
+    } else {
+        strOut += field.szText;
+    }
+}
+
+// 控制台：[分类] 消息  键=值 键=值
+void FormatConsole(const SLogRecord& rec, string& strOut) {
+    if (rec.iLevel == LOG_WARN) strOut += "[警告] ";
+    else if (rec.iLevel == LOG_ERROR) strOut += "[错误] ";
+    strOut += '[';
+    strOut += CategoryName(rec.iCategory);
+    strOut += "] ";
+    strOut += rec.pMessage;
+    for (int i = 0; i < rec.iFieldCount; i++) {
+        strOut += i == 0 ? "  " : " ";
+        strOut += rec.arrFields[i].pKey;
+        strOut += '=';
+        AppendValue(strOut, rec.arrFields[i], false);
+    }
+    strOut += '\n';
+}
+
+// 文件：一条记录一行 JSON，键值对平铺在顶层
+void FormatJson(const SLogRecord& rec, int iTid, string& strOut) {
+    char szBuf[128];
+    snprintf(szBuf, sizeof(szBuf), "{\"ts_ms\":%.3f,\"tid\":%d,\"level\":\"%s\",\"cat\":\"%s\",\"msg\":",
+             rec.llTimeNs / 1e6, iTid, LevelName(rec.iLevel), CategoryName(rec.iCategory));
+    strOut += szBuf;
+    AppendJsonString(strOut, rec.pMessage);
+    for (int i = 0; i < rec.iFieldCount; i++) {
+        strOut += ",\"";
+        strOut += rec.arrFields[i].pKey;
+        strOut += "\":";
+        AppendValue(strOut, rec.arrFields[i], true);
+    }
+    strOut += "}\n";
+}
+
+// 取出所有线程已写入的记录，按线程依次输出 (同一线程内保持顺序)
+void DrainAll(SLogState& st) {
+    lock_guard<mutex> lock(st.mtxDrain);
+    string strConsole, strFile;
+    int iCount = st.atRingCount.load(memory_order_acquire);
+    for (int i = 0; i < iCount; i++) {
+        SLogRing& ring = *st.arrRings[i];
+        uint64_t ullTail = ring.atTail.load(memory_order_relaxed);
+        uint64_t ullHead = ring.atHead.load(memory_order_acquire);
+        for (; ullTail < ullHead; ullTail++) {
+            const SLogRecord& rec = ring.arrRecords[ullTail % LOG_RING_SIZE];
+            if (st.bConsole) FormatConsole(rec, strConsole);
+            if (st.pFile != nullptr) FormatJson(rec, ring.iTid, strFile);
+        }
+        ring.atTail.store(ullTail, memory_order_release);
+    }
+    if (!strConsole.empty()) cout << strConsole << flush;
+    if (!strFile.empty()) {
+        fputs(strFile.c_str(), st.pFile);
+        fflush(st.pFile);
+    }
+}
+
+void DrainLoop(SLogState* pState) {
+    unique_lock<mutex> lock(pState->mtxWake);
+    while (!pState->bStop) {
+        pState->cvWake.wait_for(lock, chrono::milliseconds(LOG_DRAIN_MS),
+                                [pState] { return pState->bStop || pState->atWakeRequested.load(); });
+        pState->atWakeRequested.store(false);
+        lock.unlock();
+        DrainAll(*pState);
+        lock.lock();
+    }
+}
+
+SLogState::~SLogState() {
+    if (drainer.joinable()) {
+        {
+            lock_guard<mutex> lock(mtxWake);
+            bStop = true;
+        }
+        cvWake.notify_one();
+        drainer.join();
+    }
+    DrainAll(*this);
+    if (pFile != nullptr) fclose(pFile);
+    int iCount = atRingCount.load();
+    for (int i = 0; i < iCount; i++) delete arrRings[i];
+}
+
+thread_local SLogRing* t_pRing = nullptr;
+thread_local bool t_bNoRing = false;
+
+// 线程第一次写日志时登记缓冲区，第一个登记的线程顺便启动后台线程
+SLogRing* GetRing() {
+    if (t_pRing != nullptr || t_bNoRing) return t_pRing;
+    SLogState& st = GetState();
+    lock_guard<mutex> lock(st.mtxRegister);
+    int iCount = st.atRingCount.load(memory_order_relaxed);
+    if (iCount >= LOG_MAX_THREADS) {
+        t_bNoRing = true;
+        return nullptr;
+    }
+    SLogRing* pRing = new SLogRing();
+    pRing->iTid = iCount + 1;
+    pRing->atHead = 0;
+    pRing->atTail = 0;
+    pRing->atDropped = 0;
+    st.arrRings[iCount] = pRing;
+    st.atRingCount.store(iCount + 1, memory_order_release);
+    if (!st.drainer.joinable()) st.drainer = thread(DrainLoop, &st);
+    t_pRing = pRing;
+    return pRing;
+}
+
+} // namespace
+
+void CLog::SetLevel(int iLevel) {
+    s_atLevel.store(iLevel);
+}
+
+void CLog::SetCategories(int iMask) {
+    s_atCategories.store(iMask);
+}
+
+void CLog::SetConsole(bool bEnabled) {
+    SLogState& st = GetState();
+    lock_guard<mutex> lock(st.mtxDrain);
+    st.bConsole = bEnabled;
+}
+
+bool CLog::OpenFile(const string& strFile) {
+    SLogState& st = GetState();
+    lock_guard<mutex> lock(st.mtxDrain);
+    if (st.pFile != nullptr) fclose(st.pFile);
+    st.pFile = nullptr;
+    if (strFile.empty()) return true;
+    st.pFile = fopen(strFile.c_str(), "a");
+    return st.pFile != nullptr;
+}
+
+void CLog::Flush() {
+    DrainAll(GetState());
+}
+
+void CLog::Submit(const SLogRecord& record) {
+    SLogRing* pRing = GetRing();
+    if (pRing == nullptr) {
+        GetState().atOverflow.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+    uint64_t ullHead = pRing->atHead.load(memory_order_relaxed);
+    if (ullHead - pRing->atTail.load(memory_order_acquire) >= (uint64_t)LOG_RING_SIZE) {
+        pRing->atDropped.store(pRing->atDropped.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        return;
+    }
+    pRing->arrRecords[ullHead % LOG_RING_SIZE] = record;
+    pRing->atHead.store(ullHead + 1, memory_order_release);
+
+    // 积压过了水位线：通知后台线程提前来取；已经有人通知过就不再碰共享的标志和条件变量
+    if (ullHead + 1 - pRing->atTail.load(memory_order_relaxed) >= (uint64_t)LOG_RING_WAKE) {
+        SLogState& st = GetState();
+        if (!st.atWakeRequested.load(memory_order_relaxed) && !st.atWakeRequested.exchange(true)) {
+            st.cvWake.notify_one();
+        }
+    }
+}
+
+long long CLog::GetDroppedCount() {
+    SLogState& st = GetState();
+    long long llTotal = st.atOverflow.load(memory_order_relaxed);
+    int iCount = st.atRingCount.load(memory_order_acquire);
+    for (int i = 0; i < iCount; i++) llTotal += st.arrRings[i]->atDropped.load(memory_order_relaxed);
+    return llTotal;
+}
+
+CLogLine::CLogLine(int iLevel, int iCategory, const char* pMessage) {
+    m_stRecord.llTimeNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - GetEpoch()).count();
+    m_stRecord.pMessage = pMessage;
+    m_stRecord.iLevel = iLevel;
+    m_stRecord.iCategory = iCategory;
+    m_stRecord.iFieldCount = 0;
+}
+
+// 超过 LOG_MAX_FIELDS 个的键值对丢掉
+SLogField* CLogLine::AddField(const char* pKey, int iType) {
+    if (m_stRecord.iFieldCount >= LOG_MAX_FIELDS) return nullptr;
+    SLogField* pField = &m_stRecord.arrFields[m_stRecord.iFieldCount++];
+    pField->pKey = pKey;
+    pField->iType = iType;
+    return pField;
+}
+
+CLogLine& CLogLine::Int(const char* pKey, long long llValue) {
+    SLogField* pField = AddField(pKey, LOG_FIELD_INT);
+    if (pField != nullptr) pField->llValue = llValue;
+    return *this;
+}
+
+CLogLine& CLogLine::Real(const char* pKey, double dValue) {
+    SLogField* pField = AddField(pKey, LOG_FIELD_REAL);
+    if (pField != nullptr) pField->dValue = dValue;
+    return *this;
+}
+
+CLogLine& CLogLine::Text(const char* pKey, const char* pValue) {
+    SLogField* pField = AddField(pKey, LOG_FIELD_TEXT);
+    if (pField != nullptr) {
+        strncpy(pField->szText, pValue, LOG_TEXT_CHARS - 1);
+        pField->szText[LOG_TEXT_CHARS - 1] = '\0';
+    }
+    return *this;
+}
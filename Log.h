@@ -0,0 +1,126 @@
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 级别
+enum ELogLevel {
+    LOG_DEBUG = 0,
+    LOG_INFO,
+    LOG_WARN,
+    LOG_ERROR,
+    LOG_NONE
+};
+
+// 分类 (按位，可组合成过滤掩码)
+enum ELogCategory {
+    LOG_CAT_AI = 1 << 0,      // 落子、思考过程
+    LOG_CAT_SEARCH = 1 << 1,  // 搜索统计
+    LOG_CAT_LEARN = 1 << 2,   // 对局后调整权重
+    LOG_CAT_IO = 1 << 3,      // 读写文件
+    LOG_CAT_SERVER = 1 << 4,
+    LOG_CAT_ALL = 0xFF
+};
+
+// 编译期过滤：低于 WZQ_LOG_MIN_LEVEL 的级别、不在 WZQ_LOG_CATEGORIES 里的分类整条语句被编译器删掉
+// 例如 -DWZQ_LOG_MIN_LEVEL=2 只保留警告和错误
+#ifndef WZQ_LOG_MIN_LEVEL
+#define WZQ_LOG_MIN_LEVEL 0
+#endif
+#ifndef WZQ_LOG_CATEGORIES
+#define WZQ_LOG_CATEGORIES 0xFF
+#endif
+
+const int LOG_RING_SIZE = 256;   // 每个线程缓冲的记录数，写满时丢弃新记录 (不等待)
+const int LOG_RING_WAKE = LOG_RING_SIZE / 2; // 积压到这么多条就提前叫醒后台线程，不等定时
+const int LOG_MAX_FIELDS = 6;
+const int LOG_TEXT_CHARS = 48;   // 文本值复制进记录，超长截断
+
+enum ELogFieldType {
+    LOG_FIELD_INT = 0,
+    LOG_FIELD_REAL,
+    LOG_FIELD_TEXT
+};
+
+// 一个键值对：键必须是字符串常量 (只存指针)
+struct SLogField {
+    const char* pKey;
+    int iType;
+    union {
+        long long llValue;
+        double dValue;
+        char szText[LOG_TEXT_CHARS];
+    };
+};
+
+// 一条记录：定长，写进环形缓冲区时整块复制，不分配内存；消息也必须是字符串常量
+struct SLogRecord {
+    int64_t llTimeNs;
+    const char* pMessage;
+    int iLevel;
+    int iCategory;
+    int iFieldCount;
+    SLogField arrFields[LOG_MAX_FIELDS];
+};
+
+// 异步日志：各线程把记录写进自己的环形缓冲区 (单写单读，无锁)，后台线程定时取出来格式化、写控制台和文件
+// 写日志的线程只做几次定长复制和原子操作，从不碰 I/O，缓冲区满了就丢弃并计数
+// 后台线程每 20ms 取一次；某个缓冲区积压过半时写入方发一次通知 (不加锁、不等待) 让它提前取
+// 控制台按“[分类] 消息  键=值”输出；OpenFile 之后每条记录再按 JSON 一行写进文件
+class CLog {
+public:
+    // 运行期过滤 (编译期没删掉的语句才会走到这里)
+    static void SetLevel(int iLevel);
+    static void SetCategories(int iMask);
+    static bool IsEnabled(int iLevel, int iCategory) {
+        return iLevel >= s_atLevel.load(std::memory_order_relaxed) &&
+               (iCategory & s_atCategories.load(std::memory_order_relaxed)) != 0;
+    }
+
+    static void SetConsole(bool bEnabled);
+    // 追加写 JSON 行；空文件名关闭文件；返回是否打开成功
+    static bool OpenFile(const std::string& strFile);
+
+    // 把所有线程已写入的记录立刻输出 (在调用线程上)，界面重画前调用，保证文字顺序
+    static void Flush();
+
+    static void Submit(const SLogRecord& record);
+
+    // 因缓冲区写满被丢弃的记录数 (所有线程合计)
+    static long long GetDroppedCount();
+
+private:
+    static std::atomic<int> s_atLevel;
+    static std::atomic<int> s_atCategories;
+};
+
+// 用法：WZQ_LOG(LOG_INFO, LOG_CAT_SEARCH, "搜索完成").Int("depth", iDepth).Real("rate", dRate);
+// 语句结束时提交。被过滤掉时后面的参数都不求值
+class CLogLine {
+public:
+    CLogLine(int iLevel, int iCategory, const char* pMessage);
+    ~CLogLine() { CLog::Submit(m_stRecord); }
+
+    CLogLine& Int(const char* pKey, long long llValue);
+    CLogLine& Real(const char* pKey, double dValue);
+    CLogLine& Text(const char* pKey, const char* pValue);
+    CLogLine& Text(const char* pKey, const std::string& strValue) { return Text(pKey, strValue.c_str()); }
+
+private:
+    SLogRecord m_stRecord;
+
+    SLogField* AddField(const char* pKey, int iType);
+
+    CLogLine(const CLogLine&);
+    CLogLine& operator=(const CLogLine&);
+};
+
+#define WZQ_LOG(level, category, message)                                                                       \
+    if (!((level) >= WZQ_LOG_MIN_LEVEL && ((category) & WZQ_LOG_CATEGORIES) != 0 && CLog::IsEnabled(level, category))) \
+        ;                                                                                                       \
+    else                                                                                                        \
+        CLogLine(level, category, message)
+
+#endif
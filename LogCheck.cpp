@@ -0,0 +1,116 @@
+#include "Log.h"
+#include "Checks.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// 日志开销：WuZiQiDemo --bench-log [每线程条数] [线程数] [文件] [间隔微秒]
+// 多个线程同时写带 4 个键值对的记录，对比同步 fprintf + fflush (原来 cout << endl 的做法) 与异步日志的每条耗时
+// 异步日志的缓冲区写满时丢弃而不等待，所以按真正写进文件的条数 (逐行数出来) 折算，计时一直算到全部写进文件为止
+// 跑两遍：连续不停地写 (最坏情况)，和每条之间先空转若干微秒 (模拟搜索中间穿插写日志)
+struct SLogBenchResult {
+    long long llDelivered;
+    long long llDropped;
+    double dWriteSeconds;  // 写入线程全部返回
+    double dTotalSeconds;  // 全部写进文件
+};
+
+static SLogBenchResult RunAsyncLogBench(int iRecords, int iThreads, const string& strFile, int iGapUs) {
+    remove(strFile.c_str()); // OpenFile 是追加写
+    CLog::SetConsole(false);
+    CLog::OpenFile(strFile);
+    long long llDroppedBefore = CLog::GetDroppedCount();
+    vector<thread> vecThreads;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int t = 0; t < iThreads; t++) {
+        vecThreads.push_back(thread([=]() {
+            for (int k = 0; k < iRecords; k++) {
+                if (iGapUs > 0) {
+                    chrono::steady_clock::time_point tpUntil = chrono::steady_clock::now() + chrono::microseconds(iGapUs);
+                    while (chrono::steady_clock::now() < tpUntil) {}
+                }
+                WZQ_LOG(LOG_INFO, LOG_CAT_SEARCH, "搜索完成")
+                    .Int("thread", t).Int("depth", k % 20).Int("nodes", k * 37).Int("score", k % 1000);
+            }
+        }));
+    }
+    for (size_t t = 0; t < vecThreads.size(); t++) vecThreads[t].join();
+
+    SLogBenchResult stResult;
+    stResult.dWriteSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    CLog::Flush();
+    stResult.dTotalSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    stResult.llDropped = CLog::GetDroppedCount() - llDroppedBefore;
+    CLog::OpenFile("");
+    CLog::SetConsole(true);
+
+    stResult.llDelivered = 0;
+    {
+        ifstream file(strFile);
+        string strLine;
+        while (getline(file, strLine)) stResult.llDelivered++;
+    }
+    remove(strFile.c_str());
+    return stResult;
+}
+
+int RunLogBench(int argc, char* argv[]) {
+    int iRecords = (argc > 2) ? atoi(argv[2]) : 20000;
+    int iThreads = (argc > 3) ? atoi(argv[3]) : 4;
+    string strFile = (argc > 4) ? argv[4] : "bench_log.jsonl";
+    int iGapUs = (argc > 5) ? atoi(argv[5]) : 5;
+    if (iThreads < 1) iThreads = 1;
+
+    // 同步：所有线程共用一个文件，每条都刷新
+    FILE* pFile = fopen(strFile.c_str(), "w");
+    if (pFile == nullptr) {
+        cout << "无法打开 " << strFile << endl;
+        return 1;
+    }
+    mutex mtxFile;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    vector<thread> vecThreads;
+    for (int t = 0; t < iThreads; t++) {
+        vecThreads.push_back(thread([&, t]() {
+            for (int k = 0; k < iRecords; k++) {
+                lock_guard<mutex> lock(mtxFile);
+                fprintf(pFile, "搜索完成 thread=%d depth=%d nodes=%d score=%d\n", t, k % 20, k * 37, k % 1000);
+                fflush(pFile);
+            }
+        }));
+    }
+    for (size_t t = 0; t < vecThreads.size(); t++) vecThreads[t].join();
+    double dSync = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    fclose(pFile);
+
+    long long llTotal = (long long)iRecords * iThreads;
+    cout << iThreads << " 个线程 x " << iRecords << " 条" << endl;
+    cout << " 同步 fprintf+fflush: 每条 " << dSync * 1e9 / llTotal << " ns" << endl;
+
+    bool bOk = true;
+    for (int pass = 0; pass < 2; pass++) {
+        int iGap = (pass == 0) ? 0 : iGapUs;
+        SLogBenchResult st = RunAsyncLogBench(iRecords, iThreads, strFile, iGap);
+        if (pass == 0) {
+            cout << " 异步, 连续写: 写入方每次调用 " << st.dWriteSeconds * 1e9 / llTotal << " ns";
+        } else {
+            cout << " 异步, 每条间隔 " << iGap << " us:";
+        }
+        cout << " 送达 " << st.llDelivered << " 条 (" << 100.0 * st.llDelivered / llTotal << "%), 丢弃 "
+             << st.llDropped << " 条";
+        if (pass == 0 && st.llDelivered > 0) {
+            cout << ", 写完到进文件每条送达 " << st.dTotalSeconds * 1e9 / st.llDelivered << " ns";
+        }
+        cout << endl;
+        if (st.llDelivered + st.llDropped != llTotal) bOk = false;
+    }
+    return bOk ? 0 : 1;
+}
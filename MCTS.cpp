@@ -0,0 +1,281 @@
+#include "MCTS.h"
+#include "AIPlayer.h"
+#include "Referee.h"
+#include "EvalKernel.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+using namespace std;
+
+template <int N, class TRule>
+CMCTST<N, TRule>::CMCTST(const AIWeights& weights, EMCTSMode eMode, unsigned uSeed)
+    : m_weights(weights), m_eMode(eMode), m_rng(uSeed), m_pArena(nullptr), m_iNodeCount(0),
+      m_iBatch(1), m_pBatch(nullptr) {}
+
+template <int N, class TRule>
+void CMCTST<N, TRule>::SetBatch(int iLanes) {
+    if (iLanes < 1) iLanes = 1;
+    if (iLanes > CBatchPlayoutT<N, TRule>::MAX_LANES) iLanes = CBatchPlayoutT<N, TRule>::MAX_LANES;
+    m_iBatch = iLanes;
+}
+
+template <int N, class TRule>
+SMCTSStats CMCTST<N, TRule>::Search(const Board& board, int color, int iPlayouts, CSearchControl& ctl) {
+    WZQ_TRACE_SCOPE("mcts.search", "search");
+    m_pArena = &CArena::ForThread();
+    CArenaScope scope(*m_pArena); // 整棵树在返回时作废
+    SNode root = { -1, nullptr, 0, 0, 0.0f, 1.0f, (int8_t)(color == BLACK ? WHITE : BLACK), (int8_t)EMPTY };
+    m_iNodeCount = 1;
+    if (m_iBatch > 1) {
+        void* pMem = m_pArena->Allocate(sizeof(CBatchPlayoutT<N, TRule>), alignof(CBatchPlayoutT<N, TRule>));
+        m_pBatch = new (pMem) CBatchPlayoutT<N, TRule>(); // 成员都是数组，不需要析构
+    }
+
+    SMCTSStats stats;
+    CFixedList<SNode*, N * N + 1> vecPath;
+    int8_t arrWinners[CBatchPlayoutT<N, TRule>::MAX_LANES];
+    for (int k = 0; k < iPlayouts; k++) {
+        if (!ctl.CountNode()) break;
+        // 这一轮模拟几盘：每盘仍记一个节点，预算或时间用完就少下几盘
+        int iLanes = 1;
+        while (iLanes < m_iBatch && k + iLanes < iPlayouts && ctl.CountNode()) iLanes++;
+
+        // 1. 选择：沿树往下走到一个没展开的节点或终局
+        Board work = board;
+        SNode* pNode = &root;
+        int toMove = color;
+        vecPath.clear();
+        vecPath.push_back(pNode);
+        while (pNode->iWinner == EMPTY) {
+            // 2. 展开：根总是展开；其他节点第二次经过时展开 (只走过一次的叶子直接模拟)
+            if (pNode->pChildren == nullptr) {
+                if (pNode != &root && pNode->iVisits == 0) break;
+                Expand(*pNode, work, toMove);
+                if (pNode->iChildCount == 0) break; // 无处可下
+            }
+            pNode = SelectChild(*pNode);
+            work.PlacePiece(pNode->iMove % N, pNode->iMove / N, toMove);
+            toMove = (toMove == BLACK) ? WHITE : BLACK;
+            vecPath.push_back(pNode);
+        }
+
+        // 3. 模拟
+        // 展开过却没有合法走法的节点按和棋，不再模拟
+        int winner = pNode->iWinner;
+        bool bDeadEnd = pNode->pChildren != nullptr && pNode->iChildCount == 0;
+        bool bSimulate = winner == EMPTY && !bDeadEnd;
+        int arrResults[3] = { 0, 0, 0 }; // 和棋 / 黑胜 / 白胜 的盘数
+        if (bSimulate && iLanes > 1) {
+            m_pBatch->Run(work, toMove, iLanes, m_rng, arrWinners);
+            for (int j = 0; j < iLanes; j++) arrResults[arrWinners[j]]++;
+        } else {
+            if (bSimulate) winner = Simulate(work, toMove);
+            arrResults[winner] = iLanes;
+        }
+
+        // 4. 回传：每个节点按“走这一步的一方”记分
+        float fDrawScore = 0.5f * arrResults[EMPTY];
+        for (int i = 0; i < vecPath.size(); i++) {
+            SNode& node = *vecPath[i];
+            node.iVisits += iLanes;
+            node.fWins += arrResults[node.iMover] + fDrawScore;
+        }
+        stats.iPlayouts += iLanes;
+        k += iLanes - 1;
+    }
+
+    // 选访问次数最多的根子节点 (比胜率更稳)
+    const SNode* pBest = nullptr;
+    for (int i = 0; i < root.iChildCount; i++) {
+        const SNode& c = root.pChildren[i];
+        if (pBest == nullptr || c.iVisits > pBest->iVisits) pBest = &c;
+    }
+    stats.iTreeNodes = m_iNodeCount;
+    if (pBest != nullptr && stats.iPlayouts > 0) {
+        stats.stMove.iX = pBest->iMove % N;
+        stats.stMove.iY = pBest->iMove / N;
+        stats.iBestVisits = pBest->iVisits;
+        stats.dBestWinRate = pBest->iVisits > 0 ? pBest->fWins / pBest->iVisits : 0.0;
+    }
+    m_pArena = nullptr;
+    m_pBatch = nullptr;
+    return stats;
+}
+
+// 候选：棋子周围两格内的空位 (空棋盘只有天元)，去掉黑棋禁手；成五的子节点直接标成终局
+template <int N, class TRule>
+void CMCTST<N, TRule>::Expand(SNode& node, Board& board, int color) {
+    CMoveListT<N> vecMoves;
+    bool arrNear[N * N] = {};
+    bool bAny = false;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            if (board.IsEmpty(x, y)) continue;
+            bAny = true;
+            for (int ny = max(0, y - 2); ny <= min(N - 1, y + 2); ny++) {
+                for (int nx = max(0, x - 2); nx <= min(N - 1, x + 2); nx++) arrNear[ny * N + nx] = true;
+            }
+        }
+    }
+    if (!bAny) arrNear[(N / 2) * N + N / 2] = true;
+
+    int8_t arrWinner[N * N];
+    for (int i = 0; i < N * N; i++) {
+        int x = i % N, y = i / N;
+        if (!arrNear[i] || !board.IsEmpty(x, y)) continue;
+        board.PlacePiece(x, y, color);
+        bool bWin = CRefereeT<N, TRule>::CheckWin(board, x, y);
+        bool bForbidden = !bWin && color == BLACK && CRefereeT<N, TRule>::CheckForbidden(board, x, y);
+        board.UndoPiece(x, y);
+        if (bForbidden) continue;
+        arrWinner[vecMoves.size()] = (int8_t)(bWin ? color : EMPTY);
+        vecMoves.push_back(i);
+    }
+
+    CFixedList<float, N * N> vecPriors;
+    ComputePriors(board, color, vecMoves, vecPriors);
+
+    // 按先验从高到低排好，渐进加宽只需要看前 k 个；UCB1 模式打乱顺序，未试过的随机先试
+    // 先验相同的按生成顺序 (等价于稳定排序，std::sort 不像 stable_sort 那样要临时缓冲)
+    int iCount = vecMoves.size();
+    int arrOrder[N * N];
+    for (int i = 0; i < iCount; i++) arrOrder[i] = i;
+    if (m_eMode == MCTS_PUCT) {
+        sort(arrOrder, arrOrder + iCount, [&](int a, int b) {
+            return vecPriors[a] > vecPriors[b] || (vecPriors[a] == vecPriors[b] && a < b);
+        });
+    } else {
+        shuffle(arrOrder, arrOrder + iCount, m_rng);
+    }
+
+    SNode* arrChildren = m_pArena->AllocateArray<SNode>(iCount);
+    for (int i = 0; i < iCount; i++) {
+        int j = arrOrder[i];
+        SNode child = { vecMoves[j], nullptr, 0, 0, 0.0f, vecPriors[j], (int8_t)color, arrWinner[j] };
+        arrChildren[i] = child;
+    }
+    node.pChildren = arrChildren;
+    node.iChildCount = iCount;
+    m_iNodeCount += iCount;
+}
+
+// 先验：该点对走棋方的 EvaluatePoint 分 (攻守两项之和)，归一化成概率
+// 成五的点分数是其他点的上百倍，几乎独占先验
+template <int N, class TRule>
+void CMCTST<N, TRule>::ComputePriors(const Board& board, int color, const CMoveListT<N>& vecMoves, CFixedList<float, N * N>& vecPriors) {
+    vecPriors.resize(vecMoves.size());
+    fill(vecPriors.begin(), vecPriors.end(), 1.0f / max(1, vecMoves.size()));
+    if (m_eMode != MCTS_PUCT || vecMoves.empty()) return;
+
+    int enemy = (color == BLACK) ? WHITE : BLACK;
+    SEvalInput in;
+    in.Clear(N);
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) in.SetCell(x, y, (int8_t)board.GetPiece(x, y));
+    }
+    in.iMyColor = (int8_t)color;
+    in.iEnemyColor = (int8_t)enemy;
+    in.stParams.iWin5 = m_weights.iWin5;
+    in.stParams.iLive4 = m_weights.iLive4;
+    in.stParams.iDash4 = m_weights.iDash4;
+    in.stParams.iLive3 = m_weights.iLive3;
+    in.stParams.iLive2 = m_weights.iLive2;
+    in.stParams.fAttackFactor = m_weights.fAttackFactor;
+    in.stParams.fDefenseFactor = m_weights.fDefenseFactor;
+    in.stParams.bMyExactFive = (color == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+    in.stParams.bEnemyExactFive = (enemy == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+
+    int arrScores[N * N];
+    CEvalKernel::ScoreMap(in, arrScores);
+
+    double dSum = 0;
+    for (int i = 0; i < vecMoves.size(); i++) {
+        vecPriors[i] = (float)max(1, arrScores[vecMoves[i]]);
+        dSum += vecPriors[i];
+    }
+    for (int i = 0; i < vecPriors.size(); i++) vecPriors[i] = (float)(vecPriors[i] / dSum);
+}
+
+template <int N, class TRule>
+int CMCTST<N, TRule>::GetWidenedCount(const SNode& node) const {
+    if (m_eMode != MCTS_PUCT) return node.iChildCount;
+    int k = (int)ceil(MCTS_WIDEN_BASE * pow(node.iVisits + 1.0, MCTS_WIDEN_EXPONENT));
+    return min(k, node.iChildCount);
+}
+
+template <int N, class TRule>
+typename CMCTST<N, TRule>::SNode* CMCTST<N, TRule>::SelectChild(SNode& parent) {
+    int iCount = GetWidenedCount(parent);
+    SNode* pBest = parent.pChildren;
+    double dBest = -1e300;
+
+    if (m_eMode == MCTS_UCB1) {
+        double dLogN = log((double)max(1, parent.iVisits));
+        for (int i = 0; i < iCount; i++) {
+            SNode& c = parent.pChildren[i];
+            if (c.iVisits == 0) return &c; // 未试过的先试
+            double dScore = c.fWins / c.iVisits + MCTS_UCB_CONSTANT * sqrt(dLogN / c.iVisits);
+            if (dScore > dBest) { dBest = dScore; pBest = &c; }
+        }
+        return pBest;
+    }
+
+    // PUCT：Q + c * P * sqrt(N) / (1 + n)；没访问过的子节点 Q 取父节点对走棋方的平均值
+    double dSqrtN = sqrt((double)max(1, parent.iVisits));
+    double dFpu = parent.iVisits > 0 ? 1.0 - parent.fWins / parent.iVisits : 0.5;
+    for (int i = 0; i < iCount; i++) {
+        SNode& c = parent.pChildren[i];
+        double dQ = c.iVisits > 0 ? c.fWins / c.iVisits : dFpu;
+        double dScore = dQ + MCTS_PUCT_CONSTANT * c.fPrior * dSqrtN / (1 + c.iVisits);
+        if (dScore > dBest) { dBest = dScore; pBest = &c; }
+    }
+    return pBest;
+}
+
+// 随机下完：每次从“与已有棋子相邻的空位”里均匀随机选一个
+// 黑棋在有禁手的规则下走到禁手点判负 (与正式连珠规则一致)
+template <int N, class TRule>
+int CMCTST<N, TRule>::Simulate(Board& board, int color) {
+    bool arrInSet[N * N] = {};
+    int arrCells[N * N];
+    int iCount = 0;
+    int iEmpty = 0;
+
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            if (board.IsEmpty(x, y)) { iEmpty++; continue; }
+            for (int ny = max(0, y - 1); ny <= min(N - 1, y + 1); ny++) {
+                for (int nx = max(0, x - 1); nx <= min(N - 1, x + 1); nx++) {
+                    int c = ny * N + nx;
+                    if (!arrInSet[c] && board.IsEmpty(nx, ny)) { arrInSet[c] = true; arrCells[iCount++] = c; }
+                }
+            }
+        }
+    }
+    if (iCount == 0 && iEmpty > 0) arrCells[iCount++] = (N / 2) * N + N / 2;
+
+    while (iCount > 0) {
+        int k = (int)(m_rng() % iCount);
+        int iCell = arrCells[k];
+        arrCells[k] = arrCells[--iCount];
+        int x = iCell % N, y = iCell / N;
+
+        board.PlacePiece(x, y, color);
+        if (CRefereeT<N, TRule>::CheckWin(board, x, y)) return color;
+        if (color == BLACK && CRefereeT<N, TRule>::CheckForbidden(board, x, y)) return WHITE;
+
+        for (int ny = max(0, y - 1); ny <= min(N - 1, y + 1); ny++) {
+            for (int nx = max(0, x - 1); nx <= min(N - 1, x + 1); nx++) {
+                int c = ny * N + nx;
+                if (!arrInSet[c] && board.IsEmpty(nx, ny)) { arrInSet[c] = true; arrCells[iCount++] = c; }
+            }
+        }
+        color = (color == BLACK) ? WHITE : BLACK;
+    }
+    return EMPTY;
+}
+
+#define INSTANTIATE_MCTS(N, TRule) template class CMCTST<N, TRule>;
+WZQ_FOR_EACH_GAME(INSTANTIATE_MCTS)
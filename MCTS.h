@@ -0,0 +1,82 @@
+#ifndef _MCTS_H_
+#define _MCTS_H_
+
+#include "Board.h"
+#include "Rules.h"
+#include "SearchControl.h"
+#include "FixedList.h"
+#include "Arena.h"
+#include "BatchPlayout.h"
+#include <random>
+#include <cstdint>
+
+struct AIWeights;
+
+// 蒙特卡洛树搜索的选择方式
+enum EMCTSMode {
+    MCTS_UCB1 = 0,  // 设计文档里的做法：所有候选一视同仁，未试过的先试，再按 UCB1 选
+    MCTS_PUCT       // 棋型分做先验，按 PUCT 选，并且按访问次数逐步放开低先验的子节点
+};
+
+const double MCTS_UCB_CONSTANT = 1.414;  // sqrt(2)
+const double MCTS_PUCT_CONSTANT = 1.5;
+const double MCTS_WIDEN_BASE = 2.0;      // 渐进加宽：放开的子节点数 = BASE * (visits + 1) ^ EXPONENT
+const double MCTS_WIDEN_EXPONENT = 0.5;
+
+struct SMCTSStats {
+    Point stMove;             // iX < 0 表示一次模拟都没做
+    int iPlayouts;
+    int iTreeNodes;
+    int iBestVisits;
+    double dBestWinRate;      // 选中走法的胜率 (站在 AI 一方)
+
+    SMCTSStats() : iPlayouts(0), iTreeNodes(0), iBestVisits(0), dBestWinRate(0) {
+        stMove.iX = -1; stMove.iY = -1;
+    }
+};
+
+// 树节点放在线程的分配器里，一次搜索结束整体退回，下一次搜索接着用同一片内存
+template <int N, class TRule>
+class CMCTST {
+public:
+    typedef CBoardT<N> Board;
+
+    CMCTST(const AIWeights& weights, EMCTSMode eMode, unsigned uSeed);
+
+    // 从 board 出发、color 走，最多 iPlayouts 次模拟 (ctl 每次模拟记一个节点)
+    SMCTSStats Search(const Board& board, int color, int iPlayouts, CSearchControl& ctl);
+
+    // 每个叶子一次模拟几盘 (1..64)：>1 时由 CBatchPlayoutT 同步下完，回传按盘数加权
+    // 默认 1，走 Simulate，结果与原来逐盘模拟完全一样
+    void SetBatch(int iLanes);
+
+    // 从当前局面随机下完一盘，返回胜者 (EMPTY 表示和棋)
+    int Simulate(Board& board, int color);
+
+private:
+    struct SNode {
+        int iMove;          // 走到这个节点的一步 (格子编号)，根为 -1
+        SNode* pChildren;   // 子节点在分配器里连续存放，空指针表示还没展开
+        int iChildCount;
+        int iVisits;
+        float fWins;        // 站在“走这一步的一方”的累计得分 (赢 1，和 0.5)
+        float fPrior;
+        int8_t iMover;      // 走这一步的颜色
+        int8_t iWinner;     // 这一步直接成五时为胜者，否则为 EMPTY
+    };
+
+    const AIWeights& m_weights;
+    EMCTSMode m_eMode;
+    std::minstd_rand m_rng;
+    CArena* m_pArena;   // 一次 Search 期间有效
+    int m_iNodeCount;
+    int m_iBatch;
+    CBatchPlayoutT<N, TRule>* m_pBatch; // m_iBatch > 1 时在分配器里，随树一起作废
+
+    void Expand(SNode& node, Board& board, int color);
+    SNode* SelectChild(SNode& parent);
+    int GetWidenedCount(const SNode& node) const;
+    void ComputePriors(const Board& board, int color, const CMoveListT<N>& vecMoves, CFixedList<float, N * N>& vecPriors);
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "MCTS.h"
+#include "Checks.h"
+#include "AIPlayer.h"
+#include "Board.h"
+#include "Referee.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+// MCTS 对比：WuZiQiDemo --bench-mcts [PUCT 模拟数] [UCB1 模拟数] [局数]
+// PUCT 与 UCB1 轮流执黑对下，统计胜负，看 PUCT 用更少的模拟能否达到同样的棋力
+int RunMCTSBench(int argc, char* argv[]) {
+    int iPuctPlayouts = (argc > 2) ? atoi(argv[2]) : 500;
+    int iUcbPlayouts = (argc > 3) ? atoi(argv[3]) : 2000;
+    int iGames = (argc > 4) ? atoi(argv[4]) : 10;
+    shared_ptr<const AIWeights> pWeights = make_shared<AIWeights>();
+
+    int iPuctWins = 0, iUcbWins = 0, iDraws = 0;
+    long long arrPlayouts[2] = { 0, 0 };
+    double arrSeconds[2] = { 0, 0 };
+    for (int g = 0; g < iGames; g++) {
+        bool bPuctBlack = (g % 2 == 0);
+        CAIPlayer black(BLACK, pWeights), white(WHITE, pWeights);
+        CAIPlayer& puct = bPuctBlack ? black : white;
+        CAIPlayer& ucb = bPuctBlack ? white : black;
+        puct.SetMCTS(iPuctPlayouts, MCTS_PUCT);
+        ucb.SetMCTS(iUcbPlayouts, MCTS_UCB1);
+
+        CBoard board;
+        int winner = EMPTY;
+        for (int ply = 0; ply < BOARD_SIZE * BOARD_SIZE; ply++) {
+            bool bBlack = (ply % 2 == 0);
+            CAIPlayer& ai = bBlack ? black : white;
+            int k = (&ai == &puct) ? 0 : 1;
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            Point p = ai.SearchMove(board);
+            arrSeconds[k] += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            arrPlayouts[k] += ai.GetLastMCTSStats().iPlayouts;
+
+            board.PlacePiece(p.iX, p.iY, bBlack ? BLACK : WHITE);
+            if (CReferee::CheckWin(board, p.iX, p.iY)) {
+                winner = bBlack ? BLACK : WHITE;
+                break;
+            }
+        }
+        if (winner == EMPTY) iDraws++;
+        else if ((winner == BLACK) == bPuctBlack) iPuctWins++;
+        else iUcbWins++;
+        cout << " 第 " << (g + 1) << " 局: " << (winner == EMPTY ? "和" : ((winner == BLACK) == bPuctBlack ? "PUCT 胜" : "UCB1 胜"))
+             << (bPuctBlack ? " (PUCT 执黑)" : " (UCB1 执黑)") << endl;
+    }
+
+    cout << "PUCT(" << iPuctPlayouts << ") " << iPuctWins << " 胜, UCB1(" << iUcbPlayouts << ") "
+         << iUcbWins << " 胜, 和 " << iDraws << endl;
+    cout << " 模拟总数 PUCT " << arrPlayouts[0] << " / UCB1 " << arrPlayouts[1]
+         << ", 用时 PUCT " << arrSeconds[0] << "s / UCB1 " << arrSeconds[1] << "s" << endl;
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+CMappedFile::CMappedFile() : m_pData(NULL), m_iSize(0), m_hFile(INVALID_HANDLE_VALUE), m_hMapping(NULL) {}
+
+bool CMappedFile::Open(const string& strFile, string* pError) {
+    Close();
+    m_hFile = CreateFileA(strFile.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                          FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_hFile == INVALID_HANDLE_VALUE) {
+        if (pError) *pError = "无法打开文件";
+        return false;
+    }
+    LARGE_INTEGER liSize;
+    if (!GetFileSizeEx(m_hFile, &liSize)) {
+        if (pError) *pError = "无法取得文件大小";
+        Close();
+        return false;
+    }
+    m_iSize = (size_t)liSize.QuadPart;
+    if (m_iSize == 0) return true;
+    m_hMapping = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_hMapping != NULL) m_pData = (const uint8_t*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_pData == NULL) {
+        if (pError) *pError = "内存映射失败";
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void CMappedFile::Close() {
+    if (m_pData) UnmapViewOfFile(m_pData);
+    if (m_hMapping) CloseHandle(m_hMapping);
+    if (m_hFile != INVALID_HANDLE_VALUE) CloseHandle(m_hFile);
+    m_pData = NULL;
+    m_iSize = 0;
+    m_hMapping = NULL;
+    m_hFile = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+CMappedFile::CMappedFile() : m_pData(NULL), m_iSize(0), m_iFd(-1) {}
+
+bool CMappedFile::Open(const string& strFile, string* pError) {
+    Close();
+    m_iFd = open(strFile.c_str(), O_RDONLY);
+    if (m_iFd < 0) {
+        if (pError) *pError = "无法打开文件";
+        return false;
+    }
+    struct stat st;
+    if (fstat(m_iFd, &st) != 0) {
+        if (pError) *pError = "无法取得文件大小";
+        Close();
+        return false;
+    }
+    m_iSize = (size_t)st.st_size;
+    if (m_iSize == 0) return true;
+    void* pMap = mmap(NULL, m_iSize, PROT_READ, MAP_PRIVATE, m_iFd, 0);
+    if (pMap == MAP_FAILED) {
+        if (pError) *pError = "内存映射失败";
+        Close();
+        return false;
+    }
+    m_pData = (const uint8_t*)pMap;
+    return true;
+}
+
+void CMappedFile::Close() {
+    if (m_pData) munmap((void*)m_pData, m_iSize);
+    if (m_iFd >= 0) close(m_iFd);
+    m_pData = NULL;
+    m_iSize = 0;
+    m_iFd = -1;
+}
+
+#endif
+
+CMappedFile::~CMappedFile() {
+    Close();
+}
@@ -0,0 +1,35 @@
+#ifndef _MAPPEDFILE_H_
+#define _MAPPEDFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 只读内存映射文件：按需分页，不经过流缓冲，大文件打开后不用先整个读进来
+// Windows 用 CreateFileMapping / MapViewOfFile，其余平台用 mmap；空文件也能打开 (GetData 为空)
+class CMappedFile {
+public:
+    CMappedFile();
+    ~CMappedFile();
+
+    bool Open(const std::string& strFile, std::string* pError);
+    void Close();
+
+    const uint8_t* GetData() const { return m_pData; }
+    size_t GetSize() const { return m_iSize; }
+
+private:
+    CMappedFile(const CMappedFile&);
+    CMappedFile& operator=(const CMappedFile&);
+
+    const uint8_t* m_pData;
+    size_t m_iSize;
+#ifdef _WIN32
+    void* m_hFile;
+    void* m_hMapping;
+#else
+    int m_iFd;
+#endif
+};
+
+#endif
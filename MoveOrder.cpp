@@ -0,0 +1,158 @@
+#include "MoveOrder.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+// 各类走法的排序键，高位优先；历史分封顶在杀手之下
+static const int ORDER_TT = 1 << 30;
+static const int ORDER_WIN = 1 << 29;
+static const int ORDER_BLOCK_FIVE = 1 << 28;
+static const int ORDER_MAKE_FOUR = 1 << 27;
+static const int ORDER_THREE_OR_BLOCK_FOUR = 1 << 26;
+static const int ORDER_BLOCK_THREE = 1 << 25;
+static const int ORDER_KILLER1 = 1 << 24;
+static const int ORDER_KILLER2 = 1 << 23;
+static const int HISTORY_MAX = (1 << 23) - 1;
+
+template <int N, class TRule>
+CMoveOrdererT<N, TRule>::CMoveOrdererT() : m_bEnabled(true) {
+    Clear();
+}
+
+template <int N, class TRule>
+void CMoveOrdererT<N, TRule>::Clear() {
+    for (int i = 0; i < SEARCH_MAX_PLY; i++) {
+        m_arrKillers[i][0] = -1;
+        m_arrKillers[i][1] = -1;
+    }
+    memset(m_arrHistory, 0, sizeof(m_arrHistory));
+    m_stStats.llCutoffs = 0;
+    m_stStats.llFirstCutoffs = 0;
+}
+
+template <int N, class TRule>
+void CMoveOrdererT<N, TRule>::Order(const Board& board, int color, int ply, int iTTMove, CMoveListT<N>& vecMoves) {
+    if (!m_bEnabled) return;
+
+    int enemy = (color == BLACK) ? WHITE : BLACK;
+    int c = (color == BLACK) ? 0 : 1;
+    int iCount = vecMoves.size();
+    int arrKeys[N * N]; // 排序用的临时分数
+
+    for (int i = 0; i < iCount; i++) {
+        int iCell = vecMoves[i];
+        int x = iCell % N, y = iCell / N;
+        int key = 0;
+        if (iCell == iTTMove) {
+            key = ORDER_TT;
+        } else {
+            int mine = ClassifyThreat(board, x, y, color);
+            int theirs = ClassifyThreat(board, x, y, enemy);
+            if (mine == THREAT_FIVE) key = ORDER_WIN;
+            else if (theirs == THREAT_FIVE) key = ORDER_BLOCK_FIVE;
+            else if (mine == THREAT_FOUR) key = ORDER_MAKE_FOUR;
+            else if (mine == THREAT_OPEN_THREE || theirs == THREAT_FOUR) key = ORDER_THREE_OR_BLOCK_FOUR;
+            else if (theirs == THREAT_OPEN_THREE) key = ORDER_BLOCK_THREE;
+            else if (ply < SEARCH_MAX_PLY && iCell == m_arrKillers[ply][0]) key = ORDER_KILLER1;
+            else if (ply < SEARCH_MAX_PLY && iCell == m_arrKillers[ply][1]) key = ORDER_KILLER2;
+            else key = m_arrHistory[c][iCell];
+        }
+        arrKeys[i] = key;
+    }
+
+    // 插入排序：候选一般只有几十个，且稳定 (同分保持行优先顺序)
+    for (int i = 1; i < iCount; i++) {
+        int iMove = vecMoves[i], key = arrKeys[i];
+        int j = i - 1;
+        while (j >= 0 && arrKeys[j] < key) {
+            vecMoves[j + 1] = vecMoves[j];
+            arrKeys[j + 1] = arrKeys[j];
+            j--;
+        }
+        vecMoves[j + 1] = iMove;
+        arrKeys[j + 1] = key;
+    }
+}
+
+template <int N, class TRule>
+void CMoveOrdererT<N, TRule>::OnCutoff(int color, int ply, int iCell, int iDepth, int iIndex) {
+    m_stStats.llCutoffs++;
+    if (iIndex == 0) m_stStats.llFirstCutoffs++;
+    if (!m_bEnabled) return;
+
+    if (ply < SEARCH_MAX_PLY && m_arrKillers[ply][0] != iCell) {
+        m_arrKillers[ply][1] = m_arrKillers[ply][0];
+        m_arrKillers[ply][0] = iCell;
+    }
+
+    int& h = m_arrHistory[color == BLACK ? 0 : 1][iCell];
+    h += iDepth * iDepth;
+    if (h > HISTORY_MAX) {
+        // 满了整体减半，保持相对大小
+        for (int c = 0; c < 2; c++) {
+            for (int i = 0; i < N * N; i++) m_arrHistory[c][i] /= 2;
+        }
+    }
+}
+
+template <int N, class TRule>
+int CMoveOrdererT<N, TRule>::ClassifyThreat(const Board& board, int x, int y, int color) {
+    int best = THREAT_NONE;
+    best = max(best, LineThreat(board, x, y, 1, 0, color));
+    if (best == THREAT_FIVE) return best;
+    best = max(best, LineThreat(board, x, y, 0, 1, color));
+    if (best == THREAT_FIVE) return best;
+    best = max(best, LineThreat(board, x, y, 1, 1, color));
+    if (best == THREAT_FIVE) return best;
+    best = max(best, LineThreat(board, x, y, 1, -1, color));
+    return best;
+}
+
+// 沿一条线看 (x, y) 落子后的棋型 (该点视为 color)
+// 取 (x, y) 两侧各 5 格：连子数判五连和活三，任意含 (x, y) 的 5 格窗口里 4 子 1 空即为四 (含跳四)
+template <int N, class TRule>
+int CMoveOrdererT<N, TRule>::LineThreat(const Board& board, int x, int y, int dx, int dy, int color) {
+    // cells[5] 是 (x, y)；-1 表示棋盘外
+    int cells[11];
+    for (int k = -5; k <= 5; k++) {
+        int nx = x + dx * k, ny = y + dy * k;
+        if (k == 0) cells[5] = color;
+        else cells[k + 5] = board.IsValid(nx, ny) ? board.GetPiece(nx, ny) : -1;
+    }
+
+    int left = 5, right = 5;
+    while (left > 0 && cells[left - 1] == color) left--;
+    while (right < 10 && cells[right + 1] == color) right++;
+    int count = right - left + 1;
+
+    bool bExactFive = (color == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+    if (count == 5 || (count > 5 && !bExactFive)) return THREAT_FIVE;
+    if (count > 5) return THREAT_NONE;
+
+    for (int s = 1; s <= 5; s++) {
+        int iStones = 0, iEmpty = 0;
+        for (int k = s; k < s + 5; k++) {
+            if (cells[k] == color) iStones++;
+            else if (cells[k] == EMPTY) iEmpty++;
+        }
+        if (iStones != 4 || iEmpty != 1) continue;
+        // 必须正好五连时，补上空位后窗口两头不能再接己方子
+        if (bExactFive && (cells[s - 1] == color || (s + 5 <= 10 && cells[s + 5] == color))) continue;
+        return THREAT_FOUR;
+    }
+
+    if (count == 3) {
+        bool bLeftOpen = cells[left - 1] == EMPTY;
+        bool bRightOpen = right < 10 && cells[right + 1] == EMPTY;
+        // 活三：两头都空，且至少一头再外面还有空位 (能走成活四)
+        if (bLeftOpen && bRightOpen &&
+            ((left >= 2 && cells[left - 2] == EMPTY) || (right <= 8 && cells[right + 2] == EMPTY))) {
+            return THREAT_OPEN_THREE;
+        }
+    }
+    return THREAT_NONE;
+}
+
+#define INSTANTIATE_ORDERER(N, TRule) template class CMoveOrdererT<N, TRule>;
+WZQ_FOR_EACH_GAME(INSTANTIATE_ORDERER)
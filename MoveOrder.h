@@ -0,0 +1,68 @@
+#ifndef _MOVEORDER_H_
+#define _MOVEORDER_H_
+
+#include "Board.h"
+#include "Rules.h"
+#include "Global.h"
+#include "FixedList.h"
+
+// 搜索的最大层数 (杀手表、主变例都按它分配)
+const int SEARCH_MAX_PLY = 32;
+
+// 某个空位落子后形成的威胁等级
+enum EThreat {
+    THREAT_NONE = 0,
+    THREAT_OPEN_THREE,  // 活三
+    THREAT_FOUR,        // 冲四或活四 (再下一手就成五)
+    THREAT_FIVE         // 直接成五
+};
+
+// 走法排序的统计
+struct SOrderStats {
+    long long llCutoffs;       // 发生 beta 剪枝的节点数
+    long long llFirstCutoffs;  // 其中第一个走法就剪枝的节点数
+
+    // 首着剪枝率：越接近 1 说明排序越好
+    double GetFirstCutoffRate() const {
+        return llCutoffs > 0 ? (double)llFirstCutoffs / llCutoffs : 0.0;
+    }
+};
+
+// 走法排序：置换表走法 > 成五 > 挡五 > 冲四 > 活三/挡四 > 挡活三 > 杀手 > 历史
+// 每个搜索线程一份 (杀手表和历史表不共享)
+template <int N, class TRule>
+class CMoveOrdererT {
+public:
+    typedef CBoardT<N> Board;
+
+    CMoveOrdererT();
+
+    // 清空杀手表、历史表和统计 (新的一次搜索开始时调用)
+    void Clear();
+
+    // 关闭后只按生成顺序 (行优先) 搜索，用来对比节点数
+    void SetEnabled(bool bEnabled) { m_bEnabled = bEnabled; }
+    bool IsEnabled() const { return m_bEnabled; }
+
+    // 给候选走法 (格子编号 y * N + x) 打分并从高到低排好
+    // iTTMove 为置换表里的最佳走法，-1 表示没有
+    void Order(const Board& board, int color, int ply, int iTTMove, CMoveListT<N>& vecMoves);
+
+    // 第 iIndex 个走法引起了 beta 剪枝：更新杀手表、历史表和统计
+    void OnCutoff(int color, int ply, int iCell, int iDepth, int iIndex);
+
+    const SOrderStats& GetStats() const { return m_stStats; }
+
+    // 在 (x, y) 落 color 子会形成的最高威胁 (只看直线，足够用来排序)
+    static int ClassifyThreat(const Board& board, int x, int y, int color);
+
+private:
+    bool m_bEnabled;
+    int m_arrKillers[SEARCH_MAX_PLY][2];
+    int m_arrHistory[2][N * N];   // 蝶形历史表：[颜色][格子]
+    SOrderStats m_stStats;
+
+    static int LineThreat(const Board& board, int x, int y, int dx, int dy, int color);
+};
+
+#endif
@@ -0,0 +1,208 @@
+#include "NNUE.h"
+#include "Rules.h"
+#include "ByteIO.h"
+#include <fstream>
+#include <random>
+#include <cstring>
+
+using namespace std;
+
+// ============================================================================
+// 标量内核
+// ============================================================================
+void NNUEAffineScalar(const uint8_t* pIn, int iIn, const int8_t* pW, const int32_t* pBias, int iOut, int32_t* pOut) {
+    for (int j = 0; j < iOut; j++) {
+        int32_t sum = pBias[j];
+        const int8_t* pRow = pW + (size_t)j * iIn;
+        for (int i = 0; i < iIn; i++) sum += (int32_t)pIn[i] * pRow[i];
+        pOut[j] = sum;
+    }
+}
+
+void NNUEAccUpdateScalar(int16_t* pAcc, const int16_t* pRow, int iCount, int iSign) {
+    for (int i = 0; i < iCount; i++) {
+        pAcc[i] = (int16_t)(iSign > 0 ? pAcc[i] + pRow[i] : pAcc[i] - pRow[i]);
+    }
+}
+
+static void NNUEAffine(EEvalKernel eKernel, const uint8_t* pIn, int iIn, const int8_t* pW,
+                       const int32_t* pBias, int iOut, int32_t* pOut) {
+    if (!CEvalKernel::IsSupported(eKernel)) eKernel = EVAL_KERNEL_SCALAR;
+    switch (eKernel) {
+    case EVAL_KERNEL_AVX2: NNUEAffineAVX2(pIn, iIn, pW, pBias, iOut, pOut); break;
+    case EVAL_KERNEL_SSE4: NNUEAffineSSE4(pIn, iIn, pW, pBias, iOut, pOut); break;
+    default:               NNUEAffineScalar(pIn, iIn, pW, pBias, iOut, pOut); break;
+    }
+}
+
+static uint8_t ClipU8(int32_t v) {
+    return (uint8_t)(v < 0 ? 0 : (v > 127 ? 127 : v));
+}
+
+// ============================================================================
+// CNNUENetwork
+// ============================================================================
+int CNNUENetwork::Forward(const int16_t* pAccUs, const int16_t* pAccThem, EEvalKernel eKernel) const {
+    uint8_t arrIn[2 * NNUE_HIDDEN];
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        arrIn[i] = ClipU8(pAccUs[i]);
+        arrIn[NNUE_HIDDEN + i] = ClipU8(pAccThem[i]);
+    }
+
+    int32_t arrL2[NNUE_L2];
+    NNUEAffine(eKernel, arrIn, 2 * NNUE_HIDDEN, &m_arrW2[0][0], m_arrB2, NNUE_L2, arrL2);
+
+    uint8_t arrL2Out[NNUE_L2];
+    for (int j = 0; j < NNUE_L2; j++) arrL2Out[j] = ClipU8(arrL2[j] >> NNUE_L2_SHIFT);
+
+    int32_t iOut = 0;
+    NNUEAffine(eKernel, arrL2Out, NNUE_L2, m_arrW3, &m_iB3, 1, &iOut);
+    return iOut / NNUE_OUTPUT_SCALE;
+}
+
+shared_ptr<CNNUENetwork> CNNUENetwork::CreateRandom(int iBoardSize, unsigned uSeed) {
+    shared_ptr<CNNUENetwork> pNet(new CNNUENetwork());
+    pNet->m_iBoardSize = iBoardSize;
+    pNet->m_vecW1.resize((size_t)pNet->GetFeatureCount() * NNUE_HIDDEN);
+
+    // 取值范围保证 N*N 个特征全部加上也不会让 int16 累加器溢出
+    minstd_rand rng(uSeed);
+    for (size_t i = 0; i < pNet->m_vecW1.size(); i++) pNet->m_vecW1[i] = (int16_t)((int)(rng() % 65) - 32);
+    for (int i = 0; i < NNUE_HIDDEN; i++) pNet->m_arrB1[i] = (int16_t)(rng() % 65);
+    for (int j = 0; j < NNUE_L2; j++) {
+        for (int i = 0; i < 2 * NNUE_HIDDEN; i++) pNet->m_arrW2[j][i] = (int8_t)((int)(rng() % 33) - 16);
+        pNet->m_arrB2[j] = (int32_t)(rng() % 1024);
+        pNet->m_arrW3[j] = (int8_t)((int)(rng() % 33) - 16);
+    }
+    pNet->m_iB3 = 0;
+    return pNet;
+}
+
+// ---- 文件格式 ----
+
+void CNNUENetwork::Serialize(vector<uint8_t>& v) const {
+    v.clear();
+    v.push_back('W'); v.push_back('Z'); v.push_back('Q'); v.push_back('N');
+    PutU32(v, NNUE_FILE_VERSION);
+    PutU32(v, (uint32_t)m_iBoardSize);
+    PutU32(v, NNUE_HIDDEN);
+    PutU32(v, NNUE_L2);
+    for (size_t i = 0; i < m_vecW1.size(); i++) {
+        v.push_back((uint8_t)(m_vecW1[i] & 0xFF));
+        v.push_back((uint8_t)((uint16_t)m_vecW1[i] >> 8));
+    }
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        v.push_back((uint8_t)(m_arrB1[i] & 0xFF));
+        v.push_back((uint8_t)((uint16_t)m_arrB1[i] >> 8));
+    }
+    for (int j = 0; j < NNUE_L2; j++) {
+        for (int i = 0; i < 2 * NNUE_HIDDEN; i++) v.push_back((uint8_t)m_arrW2[j][i]);
+    }
+    for (int j = 0; j < NNUE_L2; j++) PutU32(v, (uint32_t)m_arrB2[j]);
+    for (int j = 0; j < NNUE_L2; j++) v.push_back((uint8_t)m_arrW3[j]);
+    PutU32(v, (uint32_t)m_iB3);
+    PutU32(v, Fnv1a(v.data(), v.size()));
+}
+
+bool CNNUENetwork::Save(const string& strFile) const {
+    vector<uint8_t> v;
+    Serialize(v);
+    ofstream file(strFile, ios::binary);
+    if (!file.is_open()) return false;
+    file.write((const char*)v.data(), (streamsize)v.size());
+    return file.good();
+}
+
+shared_ptr<CNNUENetwork> CNNUENetwork::Load(const string& strFile, string* pError) {
+    ifstream file(strFile, ios::binary);
+    if (!file.is_open()) {
+        if (pError) *pError = "无法打开文件";
+        return shared_ptr<CNNUENetwork>();
+    }
+    vector<uint8_t> v((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    const size_t iHeader = 20;
+    if (v.size() < iHeader + 4 || memcmp(v.data(), "WZQN", 4) != 0) {
+        if (pError) *pError = "不是网络文件";
+        return shared_ptr<CNNUENetwork>();
+    }
+    uint32_t uVersion = GetU32(&v[4]);
+    int iSize = (int)GetU32(&v[8]);
+    if (uVersion != NNUE_FILE_VERSION || GetU32(&v[12]) != NNUE_HIDDEN || GetU32(&v[16]) != NNUE_L2) {
+        if (pError) *pError = "版本或网络结构不匹配";
+        return shared_ptr<CNNUENetwork>();
+    }
+    if (!IsSupportedBoardSize(iSize)) {
+        if (pError) *pError = "不支持的棋盘大小";
+        return shared_ptr<CNNUENetwork>();
+    }
+
+    size_t iFeatures = (size_t)2 * iSize * iSize;
+    size_t iExpected = iHeader + iFeatures * NNUE_HIDDEN * 2 + NNUE_HIDDEN * 2 +
+                       NNUE_L2 * 2 * NNUE_HIDDEN + NNUE_L2 * 4 + NNUE_L2 + 4 + 4;
+    if (v.size() != iExpected) {
+        if (pError) *pError = "文件长度不对";
+        return shared_ptr<CNNUENetwork>();
+    }
+    if (Fnv1a(v.data(), v.size() - 4) != GetU32(&v[v.size() - 4])) {
+        if (pError) *pError = "校验和不对，文件已损坏";
+        return shared_ptr<CNNUENetwork>();
+    }
+
+    shared_ptr<CNNUENetwork> pNet(new CNNUENetwork());
+    pNet->m_iBoardSize = iSize;
+    pNet->m_vecW1.resize(iFeatures * NNUE_HIDDEN);
+    const uint8_t* p = &v[iHeader];
+    for (size_t i = 0; i < pNet->m_vecW1.size(); i++, p += 2) pNet->m_vecW1[i] = (int16_t)(p[0] | (p[1] << 8));
+    for (int i = 0; i < NNUE_HIDDEN; i++, p += 2) pNet->m_arrB1[i] = (int16_t)(p[0] | (p[1] << 8));
+    for (int j = 0; j < NNUE_L2; j++) {
+        for (int i = 0; i < 2 * NNUE_HIDDEN; i++) pNet->m_arrW2[j][i] = (int8_t)*p++;
+    }
+    for (int j = 0; j < NNUE_L2; j++, p += 4) pNet->m_arrB2[j] = (int32_t)GetU32(p);
+    for (int j = 0; j < NNUE_L2; j++) pNet->m_arrW3[j] = (int8_t)*p++;
+    pNet->m_iB3 = (int32_t)GetU32(p);
+    return pNet;
+}
+
+// ============================================================================
+// CNNUEAccumulator
+// ============================================================================
+CNNUEAccumulator::CNNUEAccumulator(const CNNUENetwork& net) : m_net(net) {
+    Reset();
+}
+
+void CNNUEAccumulator::Reset() {
+    memcpy(m_arrAcc[0], m_net.GetBias1(), sizeof(m_arrAcc[0]));
+    memcpy(m_arrAcc[1], m_net.GetBias1(), sizeof(m_arrAcc[1]));
+}
+
+void CNNUEAccumulator::Update(int color, int iCell, int iSign) {
+    int iCells = m_net.GetBoardSize() * m_net.GetBoardSize();
+    // 黑视角：黑子是“己方”；白视角反过来
+    int iBlackFeature = (color == BLACK ? 0 : iCells) + iCell;
+    int iWhiteFeature = (color == WHITE ? 0 : iCells) + iCell;
+
+    switch (CEvalKernel::GetBest()) {
+    case EVAL_KERNEL_AVX2:
+        NNUEAccUpdateAVX2(m_arrAcc[0], m_net.GetFeatureRow(iBlackFeature), NNUE_HIDDEN, iSign);
+        NNUEAccUpdateAVX2(m_arrAcc[1], m_net.GetFeatureRow(iWhiteFeature), NNUE_HIDDEN, iSign);
+        break;
+    case EVAL_KERNEL_SSE4:
+        NNUEAccUpdateSSE4(m_arrAcc[0], m_net.GetFeatureRow(iBlackFeature), NNUE_HIDDEN, iSign);
+        NNUEAccUpdateSSE4(m_arrAcc[1], m_net.GetFeatureRow(iWhiteFeature), NNUE_HIDDEN, iSign);
+        break;
+    default:
+        NNUEAccUpdateScalar(m_arrAcc[0], m_net.GetFeatureRow(iBlackFeature), NNUE_HIDDEN, iSign);
+        NNUEAccUpdateScalar(m_arrAcc[1], m_net.GetFeatureRow(iWhiteFeature), NNUE_HIDDEN, iSign);
+        break;
+    }
+}
+
+int CNNUEAccumulator::Evaluate(int color, EEvalKernel eKernel) const {
+    int us = (color == BLACK) ? 0 : 1;
+    return m_net.Forward(m_arrAcc[us], m_arrAcc[1 - us], eKernel);
+}
+
+bool CNNUEAccumulator::SameAs(const CNNUEAccumulator& other) const {
+    return memcmp(m_arrAcc, other.m_arrAcc, sizeof(m_arrAcc)) == 0;
+}
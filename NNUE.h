@@ -0,0 +1,109 @@
+#ifndef _NNUE_H_
+#define _NNUE_H_
+
+#include "Global.h"
+#include "EvalKernel.h"
+#include "Board.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 小型量化神经网络评估 (NNUE 结构)
+//
+// 输入：每个视角 (黑/白) 2 * N * N 个 0/1 特征，“己方棋子在某格”和“对方棋子在某格”
+// 第一层：特征 → NNUE_HIDDEN 个 int16 累加器，落子/提子时只加减一行权重 (增量更新)
+// 之后：两个视角的累加器截断到 [0, 127] 拼成 2H 个 uint8 → NNUE_L2 个 int8 全连接 → 1 个输出
+// 所有内积都是 uint8 x int8，走 SSE4/AVX2 的 maddubs，和标量版逐位一致
+
+const int NNUE_HIDDEN = 128;       // 每个视角的累加器宽度
+const int NNUE_L2 = 32;            // 第二层宽度
+const int NNUE_L2_SHIFT = 6;       // 第二层输出右移后再截断
+const int NNUE_OUTPUT_SCALE = 16;  // 最终输出除以它得到评估分
+
+// 网络文件 (小端)：
+//   "WZQN"  uint32 版本  uint32 棋盘大小  uint32 NNUE_HIDDEN  uint32 NNUE_L2
+//   int16 W1[2*N*N][H]  int16 B1[H]  int8 W2[L2][2H]  int32 B2[L2]  int8 W3[L2]  int32 B3
+//   uint32 FNV-1a 校验 (覆盖前面所有字节)
+const uint32_t NNUE_FILE_VERSION = 1;
+
+class CNNUENetwork {
+public:
+    // 读取网络文件；失败返回空指针，原因写进 pError
+    static std::shared_ptr<CNNUENetwork> Load(const std::string& strFile, std::string* pError);
+
+    bool Save(const std::string& strFile) const;
+
+    // 随机初始化 (给外部训练当起点，也用于自检)
+    static std::shared_ptr<CNNUENetwork> CreateRandom(int iBoardSize, unsigned uSeed);
+
+    int GetBoardSize() const { return m_iBoardSize; }
+    int GetFeatureCount() const { return 2 * m_iBoardSize * m_iBoardSize; }
+
+    const int16_t* GetFeatureRow(int iFeature) const { return &m_vecW1[(size_t)iFeature * NNUE_HIDDEN]; }
+    const int16_t* GetBias1() const { return m_arrB1; }
+
+    // 由两个视角的累加器算出评估分 (站在 pAccUs 一方的角度)
+    int Forward(const int16_t* pAccUs, const int16_t* pAccThem, EEvalKernel eKernel) const;
+
+private:
+    int m_iBoardSize;
+    std::vector<int16_t> m_vecW1;
+    int16_t m_arrB1[NNUE_HIDDEN];
+    int8_t m_arrW2[NNUE_L2][2 * NNUE_HIDDEN];
+    int32_t m_arrB2[NNUE_L2];
+    int8_t m_arrW3[NNUE_L2];
+    int32_t m_iB3;
+
+    CNNUENetwork() : m_iBoardSize(0), m_iB3(0) {}
+    void Serialize(std::vector<uint8_t>& vecOut) const;
+};
+
+// 第一层累加器：跟着棋盘落子/提子增量更新，评估的代价与棋子数无关
+class CNNUEAccumulator {
+public:
+    explicit CNNUEAccumulator(const CNNUENetwork& net);
+
+    // 回到空棋盘 (累加器 = 偏置)
+    void Reset();
+
+    // (iCell = y * N + x) 上多了/少了一个 color 子
+    void Add(int color, int iCell) { Update(color, iCell, 1); }
+    void Remove(int color, int iCell) { Update(color, iCell, -1); }
+
+    // 按棋盘全量重算
+    template <int N>
+    void Refresh(const CBoardT<N>& board) {
+        Reset();
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                int piece = board.GetPiece(x, y);
+                if (piece != EMPTY) Add(piece, y * N + x);
+            }
+        }
+    }
+
+    // 站在 color 一方的评估分
+    int Evaluate(int color) const { return Evaluate(color, CEvalKernel::GetBest()); }
+    int Evaluate(int color, EEvalKernel eKernel) const;
+
+    bool SameAs(const CNNUEAccumulator& other) const;
+
+private:
+    const CNNUENetwork& m_net;
+    int16_t m_arrAcc[2][NNUE_HIDDEN]; // [视角：0 黑，1 白]
+
+    void Update(int color, int iCell, int iSign);
+};
+
+// 各指令集的实现 (与评分内核放在同样带指令集选项编译的文件里)
+// 全连接：pOut[j] = pBias[j] + sum_i pIn[i] * pW[j * iIn + i]，iIn 为 32 的倍数
+void NNUEAffineScalar(const uint8_t* pIn, int iIn, const int8_t* pW, const int32_t* pBias, int iOut, int32_t* pOut);
+void NNUEAffineSSE4(const uint8_t* pIn, int iIn, const int8_t* pW, const int32_t* pBias, int iOut, int32_t* pOut);
+void NNUEAffineAVX2(const uint8_t* pIn, int iIn, const int8_t* pW, const int32_t* pBias, int iOut, int32_t* pOut);
+// 累加器：pAcc[i] += iSign * pRow[i] (int16 回绕)，iCount 为 16 的倍数
+void NNUEAccUpdateScalar(int16_t* pAcc, const int16_t* pRow, int iCount, int iSign);
+void NNUEAccUpdateSSE4(int16_t* pAcc, const int16_t* pRow, int iCount, int iSign);
+void NNUEAccUpdateAVX2(int16_t* pAcc, const int16_t* pRow, int iCount, int iSign);
+
+#endif
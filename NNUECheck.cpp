@@ -0,0 +1,127 @@
+#include "NNUE.h"
+#include "Checks.h"
+#include "Board.h"
+#include "EvalKernel.h"
+#include "Rules.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 神经网络评估自检：WuZiQiDemo --check-nnue [步数]
+// 1. 随机落子/提子时增量累加器与全量重算逐位相同  2. 各 SIMD 内核与标量版输出相同
+// 3. 存盘再读回评估不变，改坏一个字节必须被校验和拒绝
+template <int N>
+static int CheckNNUE(int iSteps, minstd_rand& rng) {
+    shared_ptr<CNNUENetwork> pNet = CNNUENetwork::CreateRandom(N, (unsigned)rng());
+    const EEvalKernel arrKernels[] = { EVAL_KERNEL_SCALAR, EVAL_KERNEL_SSE4, EVAL_KERNEL_AVX2 };
+
+    int iErrors = 0;
+    CBoardT<N> board;
+    CNNUEAccumulator acc(*pNet), full(*pNet);
+    vector<Point> vecMoves;
+    for (int k = 0; k < iSteps; k++) {
+        if (!vecMoves.empty() && (rng() % 3 == 0 || (int)vecMoves.size() >= N * N)) {
+            Point p = vecMoves.back();
+            vecMoves.pop_back();
+            acc.Remove(board.GetPiece(p.iX, p.iY), p.iY * N + p.iX);
+            board.UndoPiece(p.iX, p.iY);
+        } else {
+            int x = (int)(rng() % N), y = (int)(rng() % N);
+            if (!board.IsEmpty(x, y)) continue;
+            int color = (rng() % 2) ? BLACK : WHITE;
+            board.PlacePiece(x, y, color);
+            acc.Add(color, y * N + x);
+            vecMoves.push_back({x, y});
+        }
+
+        full.Refresh(board);
+        if (!acc.SameAs(full)) iErrors++;
+        for (int color = BLACK; color <= WHITE; color++) {
+            int iExpected = full.Evaluate(color, EVAL_KERNEL_SCALAR);
+            for (int i = 1; i < 3; i++) {
+                if (CEvalKernel::IsSupported(arrKernels[i]) && acc.Evaluate(color, arrKernels[i]) != iExpected) iErrors++;
+            }
+        }
+    }
+
+    // 存盘往返
+    const string strFile = "nnue_selftest.tmp";
+    string strError;
+    pNet->Save(strFile);
+    shared_ptr<CNNUENetwork> pLoaded = CNNUENetwork::Load(strFile, &strError);
+    if (!pLoaded) {
+        cout << " [失败] 读回网络: " << strError << endl;
+        iErrors++;
+    } else {
+        CNNUEAccumulator reloaded(*pLoaded);
+        reloaded.Refresh(board);
+        if (reloaded.Evaluate(BLACK) != acc.Evaluate(BLACK)) iErrors++;
+    }
+    {
+        fstream file(strFile, ios::in | ios::out | ios::binary);
+        file.seekp(100);
+        file.put('\x5A');
+    }
+    if (CNNUENetwork::Load(strFile, &strError)) {
+        cout << " [失败] 损坏的网络文件没有被拒绝" << endl;
+        iErrors++;
+    }
+    remove(strFile.c_str());
+
+    // 代价：增量 (一子进一子出) + 前向 与 全量重算 + 前向
+    const int iRounds = 20000;
+    int iSink = 0;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int r = 0; r < iRounds; r++) {
+        acc.Add(BLACK, r % (N * N));
+        iSink += acc.Evaluate(WHITE);
+        acc.Remove(BLACK, r % (N * N));
+    }
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    for (int r = 0; r < iRounds / 20; r++) {
+        full.Refresh(board);
+        iSink += full.Evaluate(WHITE);
+    }
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    double dInc = chrono::duration<double, nano>(t1 - t0).count() / iRounds;
+    double dFull = chrono::duration<double, nano>(t2 - t1).count() / (iRounds / 20);
+
+    cout << " " << N << "x" << N << ": " << iSteps << " 步, 错误 " << iErrors
+         << ", 增量评估 " << (int)dInc << " ns, 全量重算评估 " << (int)dFull << " ns ("
+         << vecMoves.size() << " 子)" << (iSink == 42 ? " " : "") << endl;
+    return iErrors;
+}
+
+int RunNNUECheck(int argc, char* argv[]) {
+    int iSteps = (argc > 2) ? atoi(argv[2]) : 2000;
+    minstd_rand rng(7);
+    cout << "NNUE 内核: " << CEvalKernel::GetName(CEvalKernel::GetBest()) << endl;
+    int iErrors = CheckNNUE<15>(iSteps, rng) + CheckNNUE<19>(iSteps, rng) + CheckNNUE<20>(iSteps, rng);
+    cout << (iErrors == 0 ? "[通过]" : "[失败]") << " 错误数: " << iErrors << endl;
+    return iErrors == 0 ? 0 : 1;
+}
+
+// 生成一个随机初始化的网络文件：WuZiQiDemo --nnue-init <文件> [棋盘大小]
+// 训练不在本程序里做，这个文件是外部训练的起点，也可以用来试用网络评估的流程
+int RunNNUEInit(int argc, char* argv[]) {
+    if (argc < 3) {
+        cout << "用法: --nnue-init <文件> [棋盘大小]" << endl;
+        return 1;
+    }
+    int iSize = (argc > 3) ? atoi(argv[3]) : BOARD_SIZE;
+    if (!IsSupportedBoardSize(iSize)) iSize = BOARD_SIZE;
+    if (!CNNUENetwork::CreateRandom(iSize, (unsigned)time(NULL))->Save(argv[2])) {
+        cout << "[错误] 无法写入 " << argv[2] << endl;
+        return 1;
+    }
+    cout << "已生成 " << iSize << "x" << iSize << " 网络: " << argv[2] << endl;
+    return 0;
+}
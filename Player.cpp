@@ -1,19 +1,29 @@
 #include "Player.h"
+#include "Rules.h"
+#include "Trace.h"
 #include <iostream>
 #include <string>
 #include <cctype> // toupper
 
 using namespace std;
 
-CPlayer::CPlayer(int color) : m_iColor(color) {}
+template <int N>
+CPlayerT<N>::CPlayerT(int color) : m_iColor(color) {}
 
-CHumanPlayer::CHumanPlayer(int color) : CPlayer(color) {}
+template <int N>
+CHumanPlayerT<N>::CHumanPlayerT(int color) : CPlayerT<N>(color) {}
+
+template <int N>
+Point CHumanPlayerT<N>::MakeMove(CBoardT<N>& board) {
+    WZQ_TRACE_SCOPE("human.input", "input");
+    // 最后一列的字母 (15 路为 O，19 路为 S，20 路为 T)
+    const char cLastCol = (char)('A' + N - 1);
+    const int iColor = this->m_iColor;
 
-Point CHumanPlayer::MakeMove(CBoard& board) {
     while (true) {
         // 纯净的输入提示，不移动光标
         cout << endl;
-        cout << ">> 玩家 " << (m_iColor == BLACK ? "黑" : "白")
+        cout << ">> 玩家 " << (iColor == BLACK ? "黑" : "白")
              << " 落子 (如 H8): ";
 
         string input;
@@ -23,10 +33,10 @@ Point CHumanPlayer::MakeMove(CBoard& board) {
 
         char colChar = toupper(input[0]);
         int x = -1;
-        if (colChar >= 'A' && colChar <= 'O') {
+        if (colChar >= 'A' && colChar <= cLastCol) {
             x = colChar - 'A';
         } else {
-            cout << "   [错误] 列号不对 (A-O)，请重试。" << endl;
+            cout << "   [错误] 列号不对 (A-" << cLastCol << ")，请重试。" << endl;
             continue;
         }
 
@@ -44,4 +54,7 @@ Point CHumanPlayer::MakeMove(CBoard& board) {
             cout << "   [错误] 该位置 (" << input << ") 无效或已有子。" << endl;
         }
     }
-}
\ No newline at end of file
+}
+
+#define INSTANTIATE_PLAYER(N) template class CPlayerT<N>; template class CHumanPlayerT<N>;
+WZQ_FOR_EACH_SIZE(INSTANTIATE_PLAYER)
@@ -4,23 +4,29 @@
 #include "Board.h"
 #include "Global.h"
 
-class CPlayer {
+template <int N>
+class CPlayerT {
 protected:
     int m_iColor; // 玩家执棋颜色 (BLACK 或 WHITE)
 
 public:
-    CPlayer(int color);
-    virtual ~CPlayer() {}
+    CPlayerT(int color);
+    virtual ~CPlayerT() {}
 
     // 纯虚函数：返回落子的坐标
-    virtual Point MakeMove(CBoard& board) = 0;
+    virtual Point MakeMove(CBoardT<N>& board) = 0;
 };
 
 // 人类玩家
-class CHumanPlayer : public CPlayer {
+template <int N>
+class CHumanPlayerT : public CPlayerT<N> {
 public:
-    CHumanPlayer(int color);
-    virtual Point MakeMove(CBoard& board) override;
+    CHumanPlayerT(int color);
+    virtual Point MakeMove(CBoardT<N>& board) override;
 };
 
-#endif
\ No newline at end of file
+// 默认 15x15
+typedef CPlayerT<BOARD_SIZE> CPlayer;
+typedef CHumanPlayerT<BOARD_SIZE> CHumanPlayer;
+
+#endif
@@ -0,0 +1,497 @@
+#include "ProofSolver.h"
+#include "Referee.h"
+#include "TransTable.h"
+#include "ByteIO.h"
+#include "Trace.h"
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+using namespace std;
+
+// 区分“谁是进攻方”“该谁走”“是否只走威胁/只走四”，几者不同的同一盘面是不同的节点
+static const uint64_t PROOF_KEY_OR_NODE = 0x9E3779B97F4A7C15ULL;
+static const uint64_t PROOF_KEY_WHITE_ATTACKS = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PROOF_KEY_THREATS_ONLY = 0x165667B19E3779F9ULL;
+static const uint64_t PROOF_KEY_FOURS_ONLY = 0x27D4EB2F165667C5ULL;
+
+static uint32_t SaturatingAdd(uint32_t a, uint32_t b) {
+    uint64_t s = (uint64_t)a + b;
+    return s >= PROOF_INFINITY ? PROOF_INFINITY : (uint32_t)s;
+}
+
+template <int N, class TRule>
+CProofSolverT<N, TRule>::CProofSolverT(size_t iMemoryBytes)
+    : m_iUsed(0), m_llReplaced(0), m_bThreatsOnly(true), m_bFoursOnly(false), m_pCtl(nullptr),
+      m_ullHash(0), m_iAttacker(BLACK), m_llNodes(0), m_bAborted(false), m_pArena(nullptr) {
+    // 条目数取不超过预算的 2 的幂，至少一组
+    size_t iEntries = 2;
+    while (iEntries * 2 * sizeof(SEntry) <= iMemoryBytes) iEntries *= 2;
+    m_vecTable.resize(iEntries);
+    m_iMask = iEntries - 1;
+    Clear();
+}
+
+template <int N, class TRule>
+void CProofSolverT<N, TRule>::Clear() {
+    memset(m_vecTable.data(), 0, m_vecTable.size() * sizeof(SEntry));
+    m_iUsed = 0;
+    m_llReplaced = 0;
+}
+
+template <int N, class TRule>
+uint64_t CProofSolverT<N, TRule>::NodeKey(uint64_t ullHash, bool bOr) const {
+    uint64_t ullKey = ullHash;
+    if (bOr) ullKey ^= PROOF_KEY_OR_NODE;
+    if (m_iAttacker == WHITE) ullKey ^= PROOF_KEY_WHITE_ATTACKS;
+    if (m_bThreatsOnly) ullKey ^= PROOF_KEY_THREATS_ONLY;
+    if (m_bThreatsOnly && m_bFoursOnly) ullKey ^= PROOF_KEY_FOURS_ONLY;
+    return ullKey;
+}
+
+template <int N, class TRule>
+const typename CProofSolverT<N, TRule>::SEntry* CProofSolverT<N, TRule>::Probe(uint64_t ullKey) const {
+    size_t i = (size_t)ullKey & m_iMask & ~(size_t)1;
+    for (size_t k = i; k < i + 2; k++) {
+        if (m_vecTable[k].uUsed && m_vecTable[k].ullKey == ullKey) return &m_vecTable[k];
+    }
+    return nullptr;
+}
+
+// 同一组两条：命中就覆盖；否则用空位；都占了就挤掉价值低的 (已解的比未解的值钱，其次看子树大小)
+template <int N, class TRule>
+void CProofSolverT<N, TRule>::Store(uint64_t ullKey, uint32_t uPN, uint32_t uDN, uint32_t uWork) {
+    size_t i = (size_t)ullKey & m_iMask & ~(size_t)1;
+    SEntry* pVictim = nullptr;
+    uint64_t ullVictimValue = ~0ULL;
+    for (size_t k = i; k < i + 2; k++) {
+        SEntry& e = m_vecTable[k];
+        if (e.uUsed && e.ullKey == ullKey) {
+            pVictim = &e;
+            break;
+        }
+        uint64_t ullValue = 0;
+        if (e.uUsed) {
+            bool bSolved = (e.uPN == 0 || e.uDN == 0);
+            ullValue = ((uint64_t)(bSolved ? 1 : 0) << 32) + e.uWork + 1;
+        }
+        if (ullValue < ullVictimValue) {
+            ullVictimValue = ullValue;
+            pVictim = &e;
+        }
+    }
+    if (!pVictim->uUsed) m_iUsed++;
+    else if (pVictim->ullKey != ullKey) m_llReplaced++;
+    pVictim->ullKey = ullKey;
+    pVictim->uPN = uPN;
+    pVictim->uDN = uDN;
+    pVictim->uWork = uWork;
+    pVictim->uUsed = 1;
+}
+
+template <int N, class TRule>
+void CProofSolverT<N, TRule>::Place(int iCell, int color) {
+    m_board.PlacePiece(iCell % N, iCell / N, color);
+    m_threats.Place(iCell % N, iCell / N, color);
+    m_ullHash ^= CZobrist::Piece(color, iCell);
+}
+
+template <int N, class TRule>
+void CProofSolverT<N, TRule>::Undo(int iCell, int color) {
+    m_board.UndoPiece(iCell % N, iCell / N);
+    m_threats.Undo(iCell % N, iCell / N);
+    m_ullHash ^= CZobrist::Piece(color, iCell);
+}
+
+// 空位且不是黑棋禁手 (成五优先于禁手)
+template <int N, class TRule>
+bool CProofSolverT<N, TRule>::IsLegal(int iCell, int color) {
+    int x = iCell % N, y = iCell / N;
+    if (!m_board.IsEmpty(x, y)) return false;
+    if (!TRule::HAS_FORBIDDEN || color != BLACK) return true;
+    m_board.PlacePiece(x, y, BLACK);
+    bool bForbidden = !CRefereeT<N, TRule>::CheckWin(m_board, x, y) &&
+                      CRefereeT<N, TRule>::CheckForbidden(m_board, x, y);
+    m_board.UndoPiece(x, y);
+    return !bForbidden;
+}
+
+// 去掉非空位和黑棋禁手点
+template <int N, class TRule>
+void CProofSolverT<N, TRule>::FilterLegal(CMoveListT<N>& vecCells, int color) {
+    int iKeep = 0;
+    for (int i = 0; i < vecCells.size(); i++) {
+        if (IsLegal(vecCells[i], color)) vecCells[iKeep++] = vecCells[i];
+    }
+    vecCells.resize(iKeep);
+}
+
+// 棋子周围两格内的合法空位
+template <int N, class TRule>
+void CProofSolverT<N, TRule>::CollectNear(CMoveListT<N>& vecCells, int color) {
+    bool arrNear[N * N] = {};
+    bool bAny = false;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            if (m_board.IsEmpty(x, y)) continue;
+            bAny = true;
+            for (int ny = max(0, y - 2); ny <= min(N - 1, y + 2); ny++) {
+                for (int nx = max(0, x - 2); nx <= min(N - 1, x + 2); nx++) arrNear[ny * N + nx] = true;
+            }
+        }
+    }
+    if (!bAny) arrNear[(N / 2) * N + N / 2] = true;
+    for (int i = 0; i < N * N; i++) {
+        if (arrNear[i] && IsLegal(i, color)) vecCells.push_back(i);
+    }
+}
+
+// color 的成五点 (去重)，从威胁索引的活动列表里取
+template <int N, class TRule>
+void CProofSolverT<N, TRule>::CollectFiveSquares(int color, CMoveListT<N>& vecCells) const {
+    vecCells.clear();
+    if (!m_threats.HasFour(color)) return;
+    for (int i = 0; i < m_threats.GetThreatCount(color); i++) {
+        SThreatInfo info;
+        m_threats.GetThreat(color, i, &info);
+        if (info.iShape != SHAPE_FOUR && info.iShape != SHAPE_BROKEN_FOUR && info.iShape != SHAPE_LIVE_FOUR) continue;
+        for (int k = 0; k < info.iGainCount; k++) {
+            if (find(vecCells.begin(), vecCells.end(), info.arrGain[k]) == vecCells.end()) vecCells.push_back(info.arrGain[k]);
+        }
+    }
+    sort(vecCells.begin(), vecCells.end());
+}
+
+// 终局判断和走法生成 (证明数/否证数都站在进攻方角度)
+// - 该走的一方能成五：直接分出胜负
+// - 对方能成五：只能挡；挡不住 (两个以上成五点，或挡点是禁手) 就输了
+// - 进攻方 (只走威胁时)：能做成四或三的点
+// - 防守方面对活三：三的防守点 + 自己能冲四的点；三的成活四点对黑棋是禁手时不算真三
+// - 其余：棋子周围两格内的所有合法空位
+template <int N, class TRule>
+bool CProofSolverT<N, TRule>::GenerateMoves(bool bOr, CMoveListT<N>& vecMoves, uint32_t* pPN, uint32_t* pDN) {
+    int toMove = bOr ? m_iAttacker : 3 - m_iAttacker;
+    int other = 3 - toMove;
+    vecMoves.clear();
+
+    // toMove 赢 / toMove 输，换算到进攻方角度
+    uint32_t uWinPN = bOr ? 0 : PROOF_INFINITY, uWinDN = bOr ? PROOF_INFINITY : 0;
+    uint32_t uLosePN = bOr ? PROOF_INFINITY : 0, uLoseDN = bOr ? 0 : PROOF_INFINITY;
+
+    CMoveListT<N> vecFive;
+    CollectFiveSquares(toMove, vecFive);
+    if (!vecFive.empty()) {
+        *pPN = uWinPN;
+        *pDN = uWinDN;
+        return true;
+    }
+
+    CollectFiveSquares(other, vecFive);
+    if (!vecFive.empty()) {
+        if (vecFive.size() == 1 && IsLegal(vecFive[0], toMove)) {
+            vecMoves.push_back(vecFive[0]);
+            return false;
+        }
+        *pPN = uLosePN;
+        *pDN = uLoseDN;
+        return true;
+    }
+
+    if (bOr && m_bThreatsOnly) {
+        // 只走威胁：没有能做四/三的点就算没赢 (VCF 只看做四的点)
+        m_threats.CollectMakingSquares(toMove, !m_bFoursOnly, vecMoves);
+        FilterLegal(vecMoves, toMove);
+        if (vecMoves.empty()) {
+            *pPN = PROOF_INFINITY;
+            *pDN = 0;
+            return true;
+        }
+        return false;
+    }
+
+    // 防守方面对真三：三的防守点 + 自己能冲四的点
+    if (!bOr) {
+        bool arrAllowed[N * N] = {};
+        bool bThreat = false;
+        for (int i = 0; i < m_threats.GetThreatCount(other); i++) {
+            SThreatInfo info;
+            m_threats.GetThreat(other, i, &info);
+            if (info.iShape != SHAPE_OPEN_THREE && info.iShape != SHAPE_SPLIT_THREE) continue;
+            if (!IsLegal(info.arrGain[0], other)) continue;
+            bThreat = true;
+            for (int k = 0; k < info.iDefenseCount; k++) arrAllowed[info.arrDefense[k]] = true;
+        }
+        if (bThreat) {
+            m_threats.CollectMakingSquares(toMove, false, vecMoves);
+            for (int i = 0; i < vecMoves.size(); i++) arrAllowed[vecMoves[i]] = true;
+            vecMoves.clear();
+            for (int i = 0; i < N * N; i++) {
+                if (arrAllowed[i]) vecMoves.push_back(i);
+            }
+            FilterLegal(vecMoves, toMove);
+            if (vecMoves.empty()) {
+                *pPN = uLosePN;
+                *pDN = uLoseDN;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    CollectNear(vecMoves, toMove);
+    if (vecMoves.empty()) {
+        // 下满了 (或只剩禁手点)：进攻方没赢
+        *pPN = PROOF_INFINITY;
+        *pDN = 0;
+        return true;
+    }
+    return false;
+}
+
+// df-pn 的一次展开：在 (uThPN, uThDN) 阈值内反复深入最有希望的子节点
+// OR 节点 (进攻方走)：pn = 子节点 pn 的最小值，dn = 子节点 dn 的“和”
+// AND 节点 (防守方走)：反过来；“和”用 WPNS 的 最大值 + 其余未解个数
+// 返回本次展开的节点数
+template <int N, class TRule>
+uint32_t CProofSolverT<N, TRule>::Mid(bool bOr, uint32_t uThPN, uint32_t uThDN) {
+    uint64_t ullKey = NodeKey(m_ullHash, bOr);
+    uint32_t uWork = 1;
+    m_llNodes++;
+    if (!m_pCtl->CountNode()) {
+        m_bAborted = true;
+        return uWork;
+    }
+
+    // 已解 (可能来自导入的文件) 就不用再生成走法
+    const SEntry* pOld = Probe(ullKey);
+    if (pOld != nullptr && (pOld->uPN == 0 || pOld->uDN == 0)) return uWork;
+    if (pOld != nullptr) uWork += pOld->uWork;
+
+    uint32_t uPN = 1, uDN = 1;
+    if (GenerateMoves(bOr, m_vecScratch, &uPN, &uDN)) {
+        Store(ullKey, uPN, uDN, uWork);
+        return uWork;
+    }
+
+    // 从分配器里切出这个节点的走法和子节点键，返回时整体退回
+    CArenaScope scope(*m_pArena);
+    int toMove = bOr ? m_iAttacker : 3 - m_iAttacker;
+    int iCount = m_vecScratch.size();
+    int* arrMoves = m_pArena->AllocateArray<int>(iCount);
+    uint64_t* arrKeys = m_pArena->AllocateArray<uint64_t>(iCount);
+    for (int i = 0; i < iCount; i++) {
+        arrMoves[i] = m_vecScratch[i];
+        arrKeys[i] = NodeKey(m_ullHash ^ CZobrist::Piece(toMove, arrMoves[i]), !bOr);
+    }
+
+    while (true) {
+        // 汇总子节点：按“选择侧” (OR 看 pn，AND 看 dn) 找最小和次小，另一侧求 WPNS 和
+        uint32_t uMin = PROOF_INFINITY, uSecond = PROOF_INFINITY, uMaxOther = 0;
+        uint32_t uUnsolved = 0;
+        int iBest = -1;
+        uint32_t uBestOther = 0;
+        for (int i = 0; i < iCount; i++) {
+            const SEntry* p = Probe(arrKeys[i]);
+            uint32_t uChildPN = p ? p->uPN : 1, uChildDN = p ? p->uDN : 1;
+            uint32_t uSel = bOr ? uChildPN : uChildDN;
+            uint32_t uOther = bOr ? uChildDN : uChildPN;
+            if (uSel < uMin) {
+                uSecond = uMin;
+                uMin = uSel;
+                iBest = i;
+                uBestOther = uOther;
+            } else if (uSel < uSecond) {
+                uSecond = uSel;
+            }
+            if (uOther >= PROOF_INFINITY) uMaxOther = PROOF_INFINITY;
+            else if (uOther > 0) {
+                uMaxOther = max(uMaxOther, uOther);
+                uUnsolved++;
+            }
+        }
+        uint32_t uSum = (uMaxOther >= PROOF_INFINITY) ? PROOF_INFINITY
+                      : (uUnsolved == 0 ? 0 : SaturatingAdd(uMaxOther, uUnsolved - 1));
+        uPN = bOr ? uMin : uSum;
+        uDN = bOr ? uSum : uMin;
+
+        if (uPN >= uThPN || uDN >= uThDN || m_bAborted) break;
+
+        // 子节点阈值：选择侧不超过次优 + 1，求和侧扣掉兄弟们占的部分
+        uint32_t uThSel = min(bOr ? uThPN : uThDN, SaturatingAdd(uSecond, 1));
+        uint32_t uThSum = bOr ? uThDN : uThPN;
+        uint32_t uThOther = (uint32_t)min<uint64_t>(PROOF_INFINITY, (uint64_t)uThSum - uSum + uBestOther);
+
+        Place(arrMoves[iBest], toMove);
+        uWork += Mid(!bOr, bOr ? uThSel : uThOther, bOr ? uThOther : uThSel);
+        Undo(arrMoves[iBest], toMove);
+    }
+
+    Store(ullKey, uPN, uDN, uWork);
+    return uWork;
+}
+
+template <int N, class TRule>
+SProofResult CProofSolverT<N, TRule>::Solve(const Board& board, int attacker, CSearchControl& ctl) {
+    SProofResult result;
+    Solve(board, attacker, ctl, result);
+    return result;
+}
+
+template <int N, class TRule>
+void CProofSolverT<N, TRule>::Solve(const Board& board, int attacker, CSearchControl& ctl, SProofResult& result) {
+    WZQ_TRACE_SCOPE("proof.solve", "solver");
+    m_pCtl = &ctl;
+    m_pArena = &CArena::ForThread();
+    m_board = board;
+    m_threats.Rebuild(board);
+    m_ullHash = 0;
+    for (int i = 0; i < N * N; i++) {
+        int piece = board.GetPiece(i % N, i / N);
+        if (piece != EMPTY) m_ullHash ^= CZobrist::Piece(piece, i);
+    }
+    m_iAttacker = attacker;
+    m_llNodes = 0;
+    m_bAborted = false;
+
+    Mid(true, PROOF_INFINITY, PROOF_INFINITY);
+
+    const SEntry* pRoot = Probe(NodeKey(m_ullHash, true));
+    result.uProof = pRoot ? pRoot->uPN : 1;
+    result.uDisproof = pRoot ? pRoot->uDN : 1;
+    result.iResult = PROOF_UNKNOWN;
+    if (result.uProof == 0) result.iResult = PROOF_WIN;
+    else if (result.uDisproof == 0) result.iResult = PROOF_NOT_WIN;
+    result.llNodes = m_llNodes;
+    result.iTTUsed = m_iUsed;
+    result.iTTCapacity = m_vecTable.size();
+    result.llTTReplaced = m_llReplaced;
+    result.vecLine.clear();
+    if (result.iResult != PROOF_UNKNOWN) ExtractLine(result.iResult, result.vecLine);
+}
+
+// 沿已解的子节点走到终局：赢的一方挑最省事的 (子树最小)，输的一方挑最顽强的 (子树最大)
+template <int N, class TRule>
+void CProofSolverT<N, TRule>::ExtractLine(int iResult, vector<Point>& vecLine) {
+    CMoveListT<N> vecPlayed;
+    CMoveListT<N> vecMoves;
+    bool bOr = true;
+    while (vecPlayed.size() < N * N) {
+        int toMove = bOr ? m_iAttacker : 3 - m_iAttacker;
+        uint32_t uPN = 1, uDN = 1;
+        if (GenerateMoves(bOr, vecMoves, &uPN, &uDN)) {
+            // 终局：能成五就把成五那手记上；挡不住对方的五就补上一手挡 (禁手点也照挡，黑棋因此判负) 和对方的成五
+            CollectFiveSquares(toMove, vecMoves);
+            if (!vecMoves.empty()) {
+                vecLine.push_back({vecMoves[0] % N, vecMoves[0] / N});
+                break;
+            }
+            CollectFiveSquares(3 - toMove, vecMoves);
+            if (vecMoves.empty()) break;
+            int iBlock = vecMoves[0];
+            vecLine.push_back({iBlock % N, iBlock / N});
+            Place(iBlock, toMove);
+            CollectFiveSquares(3 - toMove, vecMoves);
+            Undo(iBlock, toMove);
+            if (!vecMoves.empty() && !(TRule::HAS_FORBIDDEN && toMove == BLACK && !IsLegal(iBlock, BLACK))) {
+                vecLine.push_back({vecMoves[0] % N, vecMoves[0] / N});
+            }
+            break;
+        }
+
+        // 胜方要找已解的子节点，负方所有子节点都已解
+        bool bWinnerMoves = (iResult == PROOF_WIN) == bOr;
+        int iPick = -1;
+        uint32_t uPickWork = 0;
+        for (int i = 0; i < vecMoves.size(); i++) {
+            const SEntry* p = Probe(NodeKey(m_ullHash ^ CZobrist::Piece(toMove, vecMoves[i]), !bOr));
+            if (p == nullptr) continue;
+            bool bSolved = (iResult == PROOF_WIN) ? p->uPN == 0 : p->uDN == 0;
+            if (!bSolved) continue;
+            bool bBetter = bWinnerMoves ? (iPick < 0 || p->uWork < uPickWork) : (iPick < 0 || p->uWork > uPickWork);
+            if (bBetter) {
+                iPick = vecMoves[i];
+                uPickWork = p->uWork;
+            }
+        }
+        if (iPick < 0) break; // 被挤出置换表了，主线到此为止
+
+        vecLine.push_back({iPick % N, iPick / N});
+        Place(iPick, toMove);
+        vecPlayed.push_back(iPick);
+        bOr = !bOr;
+    }
+
+    // 复原棋盘
+    for (int i = vecPlayed.size() - 1; i >= 0; i--) {
+        Undo(vecPlayed[i], (i % 2 == 0) ? m_iAttacker : 3 - m_iAttacker);
+    }
+}
+
+// ---- 导出格式 ----
+// "WZQP" 版本 棋盘大小 规则名(16 字节) 条数，每条 8 字节键 + 1 字节结果 (1 胜 / 2 不胜)，最后是校验和
+
+template <int N, class TRule>
+bool CProofSolverT<N, TRule>::Export(const string& strFile) const {
+    vector<uint8_t> v;
+    v.push_back('W'); v.push_back('Z'); v.push_back('Q'); v.push_back('P');
+    PutU32(v, PROOF_FILE_VERSION);
+    PutU32(v, (uint32_t)N);
+    char szRule[16] = {};
+    strncpy(szRule, TRule::Name(), sizeof(szRule) - 1);
+    v.insert(v.end(), szRule, szRule + sizeof(szRule));
+    size_t iCountAt = v.size();
+    PutU32(v, 0);
+
+    uint32_t uCount = 0;
+    for (size_t i = 0; i < m_vecTable.size(); i++) {
+        const SEntry& e = m_vecTable[i];
+        if (!e.uUsed || (e.uPN != 0 && e.uDN != 0)) continue;
+        PutU64(v, e.ullKey);
+        v.push_back(e.uPN == 0 ? (uint8_t)PROOF_WIN : (uint8_t)PROOF_NOT_WIN);
+        uCount++;
+    }
+    for (int i = 0; i < 4; i++) v[iCountAt + i] = (uint8_t)(uCount >> (8 * i));
+    PutU32(v, Fnv1a(v.data(), v.size()));
+    return WriteFileAtomic(strFile, v, nullptr);
+}
+
+template <int N, class TRule>
+int CProofSolverT<N, TRule>::Import(const string& strFile, string* pError) {
+    ifstream file(strFile, ios::binary);
+    if (!file.is_open()) {
+        if (pError) *pError = "无法打开文件";
+        return -1;
+    }
+    vector<uint8_t> v((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    const size_t iHeader = 32;
+    if (v.size() < iHeader + 4 || memcmp(v.data(), "WZQP", 4) != 0) {
+        if (pError) *pError = "不是证明文件";
+        return -1;
+    }
+    char szRule[16] = {};
+    strncpy(szRule, TRule::Name(), sizeof(szRule) - 1);
+    if (GetU32(&v[4]) != PROOF_FILE_VERSION || GetU32(&v[8]) != (uint32_t)N || memcmp(&v[12], szRule, 16) != 0) {
+        if (pError) *pError = "版本、棋盘大小或规则不匹配";
+        return -1;
+    }
+    uint32_t uCount = GetU32(&v[28]);
+    if (v.size() != iHeader + (size_t)uCount * 9 + 4) {
+        if (pError) *pError = "文件长度不对";
+        return -1;
+    }
+    if (Fnv1a(v.data(), v.size() - 4) != GetU32(&v[v.size() - 4])) {
+        if (pError) *pError = "校验和不对，文件已损坏";
+        return -1;
+    }
+
+    const uint8_t* p = &v[iHeader];
+    for (uint32_t i = 0; i < uCount; i++, p += 9) {
+        bool bWin = (p[8] == PROOF_WIN);
+        Store(GetU64(p), bWin ? 0 : PROOF_INFINITY, bWin ? PROOF_INFINITY : 0, 1);
+    }
+    return (int)uCount;
+}
+
+#define INSTANTIATE_PROOFSOLVER(N, TRule) template class CProofSolverT<N, TRule>;
+WZQ_FOR_EACH_GAME(INSTANTIATE_PROOFSOLVER)
@@ -0,0 +1,117 @@
+#ifndef _PROOFSOLVER_H_
+#define _PROOFSOLVER_H_
+
+#include "Board.h"
+#include "Rules.h"
+#include "SearchControl.h"
+#include "ThreatIndex.h"
+#include "FixedList.h"
+#include "Arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 证明数/否证数的“无穷大”
+const uint32_t PROOF_INFINITY = 100000000;
+
+// 证明文件格式版本
+const uint32_t PROOF_FILE_VERSION = 1;
+
+enum EProofResult {
+    PROOF_UNKNOWN = 0, // 时间或节点数用完
+    PROOF_WIN,         // 进攻方必胜
+    PROOF_NOT_WIN      // 进攻方赢不了 (只走威胁时表示“没有连续威胁取胜”)
+};
+
+struct SProofResult {
+    int iResult;                // EProofResult
+    uint32_t uProof;            // 根节点的证明数/否证数
+    uint32_t uDisproof;
+    long long llNodes;          // 展开的节点数
+    size_t iTTUsed;             // 置换表占用的条目数
+    size_t iTTCapacity;
+    long long llTTReplaced;     // 因为满了被挤掉的条目数
+    std::vector<Point> vecLine; // 证明出的主线 (进攻方先走)；否证时是防守方的应法
+};
+
+// 深度优先证明数搜索 (df-pn)：离线分析关键局面，证明进攻方能否必胜
+//
+// 局面之间的转置由置换表共享；棋局里只会加子，局面图是无环的 DAG，
+// 但同一个子局面从多条路径汇合时，“求和”的一侧会被重复计数，
+// 因此求和按 WPNS 的做法改为 最大值 + (未解子节点数 - 1)，合流处不再被高估
+// 置换表按内存预算一次分配，每两条一组，满了挤掉子树最小的那条 (已解的优先保留)
+//
+// 默认只让进攻方走冲四/活三 (VCT)，防守方只考虑挡点和反冲四，搜索量才可控；
+// 关掉后进攻方也考虑棋子周围两格内的所有空位
+// 黑棋禁手点一律用 CReferee 判断，禁手点上的挡点不能下
+template <int N, class TRule>
+class CProofSolverT {
+public:
+    typedef CBoardT<N> Board;
+
+    explicit CProofSolverT(size_t iMemoryBytes);
+
+    void SetThreatsOnly(bool bThreatsOnly) { m_bThreatsOnly = bThreatsOnly; }
+    // 只走冲四 (VCF)；只在只走威胁时生效，防守方每步都只能挡四
+    void SetFoursOnly(bool bFoursOnly) { m_bFoursOnly = bFoursOnly; }
+
+    // attacker 先走，证明它能否必胜；预算用完返回 PROOF_UNKNOWN，置换表保留，可以接着再算
+    SProofResult Solve(const Board& board, int attacker, CSearchControl& ctl);
+    // 同上，结果写进调用方的 result：复用同一个 result 反复求解时，整个求解不分配堆内存
+    void Solve(const Board& board, int attacker, CSearchControl& ctl, SProofResult& result);
+
+    // 清空置换表
+    void Clear();
+
+    // 导出/导入已解的局面 (键与 Zobrist 表绑定，换了棋盘大小或规则会被拒绝)；导出先写临时文件再改名
+    bool Export(const std::string& strFile) const;
+    int Import(const std::string& strFile, std::string* pError); // 返回读入的条数，失败返回 -1
+
+private:
+    struct SEntry {
+        uint64_t ullKey;
+        uint32_t uPN;
+        uint32_t uDN;
+        uint32_t uWork;  // 子树展开的节点数，替换时用
+        uint32_t uUsed;
+    };
+
+    std::vector<SEntry> m_vecTable;
+    size_t m_iMask;
+    size_t m_iUsed;
+    long long m_llReplaced;
+    bool m_bThreatsOnly;
+    bool m_bFoursOnly;
+
+    // 一次 Solve 的状态
+    CSearchControl* m_pCtl;
+    Board m_board;
+    CThreatIndexT<N, TRule> m_threats;
+    uint64_t m_ullHash;
+    int m_iAttacker;
+    long long m_llNodes;
+    bool m_bAborted;
+    // 每个节点的走法和子节点键放在线程的分配器里 (递归可能很深，不放栈上)，生成时先写进 m_vecScratch
+    CArena* m_pArena;
+    CMoveListT<N> m_vecScratch;
+
+    uint64_t NodeKey(uint64_t ullHash, bool bOr) const;
+    const SEntry* Probe(uint64_t ullKey) const;
+    void Store(uint64_t ullKey, uint32_t uPN, uint32_t uDN, uint32_t uWork);
+
+    // 生成走法；返回 true 表示是终局，此时 *pPN/*pDN 给出结果
+    bool GenerateMoves(bool bOr, CMoveListT<N>& vecMoves, uint32_t* pPN, uint32_t* pDN);
+    bool IsLegal(int iCell, int color);
+    void CollectNear(CMoveListT<N>& vecCells, int color);
+    void FilterLegal(CMoveListT<N>& vecCells, int color);
+    void CollectFiveSquares(int color, CMoveListT<N>& vecCells) const;
+
+    void Place(int iCell, int color);
+    void Undo(int iCell, int color);
+
+    uint32_t Mid(bool bOr, uint32_t uThPN, uint32_t uThDN);
+    void ExtractLine(int iResult, std::vector<Point>& vecLine);
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "ProofSolver.h"
+#include "Checks.h"
+#include "Board.h"
+#include "GameSession.h"
+#include "Referee.h"
+#include "Rules.h"
+#include "SearchControl.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 证明数搜索：WuZiQiDemo --solve <着法,逗号分隔> [节点上限] [内存MB] [证明文件] [棋盘大小] [规则] [full]
+// 摆好局面后证明轮到的一方能否必胜；给了证明文件就先读入已解的局面，算完再写回
+// 默认只走冲四/活三 (VCT)，最后加 full 则进攻方考虑所有着法
+struct SSolveRunner {
+    typedef int ResultType;
+    string strMoves;
+    long long llNodes;
+    size_t iMemoryBytes;
+    string strFile;
+    bool bFullWidth;
+
+    template <int N, class TRule>
+    int Run() {
+        CBoardT<N> board;
+        int color = BLACK;
+        stringstream ss(strMoves);
+        string strMove;
+        while (getline(ss, strMove, ',')) {
+            if (strMove.empty()) continue;
+            Point p;
+            if (!StringToPoint(strMove, &p) || !board.IsValid(p.iX, p.iY) || !board.IsEmpty(p.iX, p.iY)) {
+                cout << "无效着法: " << strMove << endl;
+                return 1;
+            }
+            board.PlacePiece(p.iX, p.iY, color);
+            color = 3 - color;
+        }
+
+        CProofSolverT<N, TRule> solver(iMemoryBytes);
+        solver.SetThreatsOnly(!bFullWidth);
+        if (!strFile.empty()) {
+            string strError;
+            int iLoaded = solver.Import(strFile, &strError);
+            if (iLoaded >= 0) cout << "已读入 " << iLoaded << " 个已解局面 (" << strFile << ")" << endl;
+            else cout << "未读入证明文件: " << strError << endl;
+        }
+
+        CSearchControl ctl(CSearchControl::Clock::time_point::max(), llNodes, 1);
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        SProofResult result = solver.Solve(board, color, ctl);
+        double dSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        const char* arrResults[] = { "未知 (预算用完)", "必胜", bFullWidth ? "不能必胜" : "没有连续威胁取胜" };
+        cout << N << "x" << N << " " << TRule::Name() << (bFullWidth ? " 全宽" : " VCT") << ", "
+             << (color == BLACK ? "黑" : "白") << "先: " << arrResults[result.iResult] << endl;
+        cout << " 证明数 " << result.uProof << "  否证数 " << result.uDisproof
+             << "  节点 " << result.llNodes << "  用时 " << dSeconds << "s" << endl;
+        cout << " 置换表 " << result.iTTUsed << "/" << result.iTTCapacity << " 条, 挤掉 " << result.llTTReplaced << " 次" << endl;
+        if (!result.vecLine.empty()) {
+            cout << " 主线:";
+            for (size_t i = 0; i < result.vecLine.size(); i++) cout << " " << PointToString(result.vecLine[i]);
+            cout << endl;
+        }
+        if (result.iResult == PROOF_WIN) {
+            // 复核：主线按裁判的规则摆下去，最后一手必须是进攻方成五
+            bool bOk = false;
+            int toMove = color;
+            for (size_t i = 0; i < result.vecLine.size(); i++) {
+                Point p = result.vecLine[i];
+                if (!board.IsEmpty(p.iX, p.iY)) break;
+                board.PlacePiece(p.iX, p.iY, toMove);
+                if (CRefereeT<N, TRule>::CheckWin(board, p.iX, p.iY)) {
+                    bOk = (toMove == color && i + 1 == result.vecLine.size());
+                    break;
+                }
+                if (toMove == BLACK && TRule::HAS_FORBIDDEN && CRefereeT<N, TRule>::CheckForbidden(board, p.iX, p.iY)) {
+                    bOk = (toMove != color && i + 1 == result.vecLine.size()); // 防守的黑棋只能下禁手
+                    break;
+                }
+                toMove = 3 - toMove;
+            }
+            cout << " 主线复核: " << (bOk ? "通过" : "未通过") << endl;
+        }
+        if (!strFile.empty() && !solver.Export(strFile)) cout << "写入证明文件失败: " << strFile << endl;
+        return 0;
+    }
+};
+
+int RunSolve(int argc, char* argv[]) {
+    vector<string> vecArgs;
+    bool bFullWidth = false;
+    for (int i = 2; i < argc; i++) {
+        if (string(argv[i]) == "full") bFullWidth = true;
+        else vecArgs.push_back(argv[i]);
+    }
+    // 默认局面：黑棋有一串冲四活三连续取胜
+    SSolveRunner runner;
+    runner.strMoves = vecArgs.size() > 0 ? vecArgs[0] : "H8,H9,I8,I9,J9,G7,J8,K8,I10,J11";
+    runner.llNodes = vecArgs.size() > 1 ? atoll(vecArgs[1].c_str()) : 2000000;
+    runner.iMemoryBytes = (size_t)(vecArgs.size() > 2 ? atoi(vecArgs[2].c_str()) : 64) << 20;
+    runner.strFile = vecArgs.size() > 3 ? vecArgs[3] : "";
+    runner.bFullWidth = bFullWidth;
+    int iSize = vecArgs.size() > 4 ? atoi(vecArgs[4].c_str()) : BOARD_SIZE;
+    if (!IsSupportedBoardSize(iSize)) iSize = BOARD_SIZE;
+    int iRule = RULE_RENJU;
+    if (vecArgs.size() > 5 && vecArgs[5] == "standard") iRule = RULE_STANDARD;
+    else if (vecArgs.size() > 5 && vecArgs[5] == "freestyle") iRule = RULE_FREESTYLE;
+    return DispatchGame(iSize, iRule, runner);
+}
@@ -1,10 +1,12 @@
 #include "Referee.h"
+#include "SparseBoard.h"
 #include <iostream>
 
 using namespace std;
 
 // 检查胜利
-bool CReferee::CheckWin(const CBoard& board, int x, int y) {
+template <class TBoard, class TRule>
+bool CRefereeCoreT<TBoard, TRule>::CheckWin(const Board& board, int x, int y) {
     int color = board.GetPiece(x, y);
     if (color == EMPTY) return false;
 
@@ -18,12 +20,12 @@ bool CReferee::CheckWin(const CBoard& board, int x, int y) {
         count += CountConsecutive(board, x, y, -dx[i], -dy[i], color);
 
         // --- 核心修正点 ---
-        if (color == BLACK) {
-            // 黑棋：必须严格等于5才算赢
-            // 如果是6个或更多，这是长连，不算赢（稍后会被 CheckForbidden 抓获）
+        // 是否必须正好五连由规则决定，两个常量相同时颜色判断会被编译器整个删掉
+        // 连珠：黑棋必须严格等于5，长连不算赢（稍后会被 CheckForbidden 抓获）；白棋5个或以上都算赢
+        bool bExactFive = (color == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+        if (bExactFive) {
             if (count == 5) return true;
         } else {
-            // 白棋：5个或以上都算赢
             if (count >= 5) return true;
         }
     }
@@ -31,9 +33,10 @@ bool CReferee::CheckWin(const CBoard& board, int x, int y) {
 }
 
 // 辅助：往一个方向数数
-int CReferee::CountConsecutive(const CBoard& board, int x, int y, int dx, int dy, int color) {
+template <class TBoard, class TRule>
+int CRefereeCoreT<TBoard, TRule>::CountConsecutive(const Board& board, int x, int y, int dx, int dy, int color) {
     int count = 0;
-    for (int step = 1; step < BOARD_SIZE; step++) {
+    for (int step = 1; step < Board::SIZE; step++) {
         int nx = x + dx * step;
         int ny = y + dy * step;
         if (!board.IsValid(nx, ny) || board.GetPiece(nx, ny) != color) {
@@ -45,7 +48,9 @@ int CReferee::CountConsecutive(const CBoard& board, int x, int y, int dx, int dy
 }
 
 // 检查禁手 (仅限黑棋)
-bool CReferee::CheckForbidden(const CBoard& board, int x, int y) {
+template <class TBoard, class TRule>
+bool CRefereeCoreT<TBoard, TRule>::CheckForbidden(const Board& board, int x, int y) {
+    if (!TRule::HAS_FORBIDDEN) return false; // 编译期常量，无禁手规则直接返回
     if (board.GetPiece(x, y) != BLACK) return false;
 
     int dx[] = { 1, 0, 1, 1 };
@@ -83,7 +88,8 @@ bool CReferee::CheckForbidden(const CBoard& board, int x, int y) {
 }
 
 // 智能分析：判断当前方向形成什么棋型 (3=活三, 4=四, 0=其他)
-int CReferee::GetLineType(const CBoard& board, int x, int y, int dx, int dy) {
+template <class TBoard, class TRule>
+int CRefereeCoreT<TBoard, TRule>::GetLineType(const Board& board, int x, int y, int dx, int dy) {
     int len = 1;
     int color = BLACK;
 
@@ -116,4 +122,13 @@ int CReferee::GetLineType(const CBoard& board, int x, int y, int dx, int dy) {
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+// 显式实例化所有支持的 大小 × 规则 组合
+#define INSTANTIATE_REFEREE(N, TRule) template class CRefereeCoreT<CBoardT<N>, TRule>; template class CRefereeT<N, TRule>;
+WZQ_FOR_EACH_GAME(INSTANTIATE_REFEREE)
+WZQ_FOR_EACH_SMALL_GAME(INSTANTIATE_REFEREE)
+
+template class CRefereeCoreT<CSparseBoard, CRenjuRule>;
+template class CRefereeCoreT<CSparseBoard, CStandardRule>;
+template class CRefereeCoreT<CSparseBoard, CFreestyleRule>;
@@ -2,22 +2,41 @@
 #define _REFEREE_H_
 
 #include "Board.h"
+#include "Rules.h"
 #include "Global.h"
 
-class CReferee {
+class CSparseBoard;
+
+// 裁判的判定逻辑：只用到棋盘的 IsValid / GetPiece，稠密棋盘和无边界棋盘 (CSparseBoard) 共用一份
+template <class TBoard, class TRule>
+class CRefereeCoreT {
 public:
+    typedef TBoard Board;
+
     // 检查是否胜利 (五连)
-    static bool CheckWin(const CBoard& board, int x, int y);
+    static bool CheckWin(const Board& board, int x, int y);
 
-    // 检查是否触发黑棋禁手 (返回 true 表示犯规)
-    static bool CheckForbidden(const CBoard& board, int x, int y);
+    // 检查是否触发黑棋禁手 (返回 true 表示犯规；没有禁手的规则恒为 false)
+    static bool CheckForbidden(const Board& board, int x, int y);
 
 private:
     // 辅助函数：计算某个方向的连子数
-    static int CountConsecutive(const CBoard& board, int x, int y, int dx, int dy, int color);
+    static int CountConsecutive(const Board& board, int x, int y, int dx, int dy, int color);
     
     // 辅助函数：判断某个方向构成的棋型 (3=活三, 4=四, 0=其他)
-    static int GetLineType(const CBoard& board, int x, int y, int dx, int dy);
+    static int GetLineType(const Board& board, int x, int y, int dx, int dy);
+};
+
+// 裁判：按棋盘大小 N 和规则 TRule 特化
+template <int N, class TRule>
+class CRefereeT : public CRefereeCoreT<CBoardT<N>, TRule> {
 };
 
-#endif
\ No newline at end of file
+// 无边界棋盘上的裁判
+template <class TRule>
+using CSparseRefereeT = CRefereeCoreT<CSparseBoard, TRule>;
+
+// 默认：15x15 连珠规则
+typedef CRefereeT<BOARD_SIZE, CRenjuRule> CReferee;
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef _RULES_H_
+#define _RULES_H_
+
+#include "Global.h"
+
+// 规则策略：编译期常量，裁判/AI 以模板参数的形式使用
+// 每个组合都会生成一份完全特化的代码，规则判断在编译期就决定了
+
+// 自由规则：五连或长连都算赢，没有禁手
+struct CFreestyleRule {
+    static const bool BLACK_EXACT_FIVE = false; // 黑棋是否必须正好五连
+    static const bool WHITE_EXACT_FIVE = false; // 白棋是否必须正好五连
+    static const bool HAS_FORBIDDEN = false;    // 黑棋是否有禁手
+    static const char* Name() { return "freestyle"; }
+};
+
+// 标准规则：双方都必须正好五连，长连不算赢，没有禁手
+struct CStandardRule {
+    static const bool BLACK_EXACT_FIVE = true;
+    static const bool WHITE_EXACT_FIVE = true;
+    static const bool HAS_FORBIDDEN = false;
+    static const char* Name() { return "standard"; }
+};
+
+// 连珠规则 (默认)：黑棋正好五连才算赢，有长连/三三/四四禁手；白棋五连或长连都算赢
+struct CRenjuRule {
+    static const bool BLACK_EXACT_FIVE = true;
+    static const bool WHITE_EXACT_FIVE = false;
+    static const bool HAS_FORBIDDEN = true;
+    static const char* Name() { return "renju"; }
+};
+
+// 运行时的规则编号 (菜单/协议用)，只在开局时转换成模板参数一次
+enum ERuleType {
+    RULE_RENJU = 0,
+    RULE_STANDARD,
+    RULE_FREESTYLE
+};
+
+// 支持的棋盘大小，各模板类在自己的 .cpp 里用它显式实例化
+#define WZQ_FOR_EACH_SIZE(MACRO) \
+    MACRO(15)                     \
+    MACRO(19)                     \
+    MACRO(20)
+
+// 支持的 棋盘大小 × 规则 组合
+#define WZQ_FOR_EACH_GAME(MACRO)                                          \
+    MACRO(15, CRenjuRule) MACRO(15, CStandardRule) MACRO(15, CFreestyleRule) \
+    MACRO(19, CRenjuRule) MACRO(19, CStandardRule) MACRO(19, CFreestyleRule) \
+    MACRO(20, CRenjuRule) MACRO(20, CStandardRule) MACRO(20, CFreestyleRule)
+
+// 穷举求解用的小棋盘 (7~11 路)：不进菜单，只实例化棋盘、裁判和 CSmallSolverT
+#define WZQ_FOR_EACH_SMALL_SIZE(MACRO) \
+    MACRO(7) MACRO(8) MACRO(9) MACRO(10) MACRO(11)
+
+#define WZQ_FOR_EACH_SMALL_GAME(MACRO)                                     \
+    MACRO(7, CRenjuRule) MACRO(7, CStandardRule) MACRO(7, CFreestyleRule)    \
+    MACRO(8, CRenjuRule) MACRO(8, CStandardRule) MACRO(8, CFreestyleRule)    \
+    MACRO(9, CRenjuRule) MACRO(9, CStandardRule) MACRO(9, CFreestyleRule)    \
+    MACRO(10, CRenjuRule) MACRO(10, CStandardRule) MACRO(10, CFreestyleRule) \
+    MACRO(11, CRenjuRule) MACRO(11, CStandardRule) MACRO(11, CFreestyleRule)
+
+inline bool IsSupportedBoardSize(int iSize) {
+    return iSize == 15 || iSize == 19 || iSize == 20;
+}
+
+// 运行时分发：把 (大小, 规则) 转成一次模板调用
+// TVisitor 需要提供 typedef ResultType 和 template <int N, class TRule> ResultType Run()
+template <int N, class TVisitor>
+typename TVisitor::ResultType DispatchRule(int iRule, TVisitor& visitor) {
+    switch (iRule) {
+    case RULE_STANDARD:  return visitor.template Run<N, CStandardRule>();
+    case RULE_FREESTYLE: return visitor.template Run<N, CFreestyleRule>();
+    default:             return visitor.template Run<N, CRenjuRule>();
+    }
+}
+
+template <class TVisitor>
+typename TVisitor::ResultType DispatchGame(int iSize, int iRule, TVisitor& visitor) {
+    switch (iSize) {
+    case 19: return DispatchRule<19>(iRule, visitor);
+    case 20: return DispatchRule<20>(iRule, visitor);
+    default: return DispatchRule<15>(iRule, visitor);
+    }
+}
+
+// 小棋盘的分发，iSize 必须在 7~11 之间
+inline bool IsSmallBoardSize(int iSize) {
+    return iSize >= 7 && iSize <= 11;
+}
+
+template <class TVisitor>
+typename TVisitor::ResultType DispatchSmallGame(int iSize, int iRule, TVisitor& visitor) {
+    switch (iSize) {
+    case 8:  return DispatchRule<8>(iRule, visitor);
+    case 9:  return DispatchRule<9>(iRule, visitor);
+    case 10: return DispatchRule<10>(iRule, visitor);
+    case 11: return DispatchRule<11>(iRule, visitor);
+    default: return DispatchRule<7>(iRule, visitor);
+    }
+}
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef _SEARCHCONTROL_H_
+#define _SEARCHCONTROL_H_
+
+#include "Global.h"
+#include <atomic>
+#include <chrono>
+
+// 一次 AI 搜索的预算与进度
+// 调度器和搜索线程通过它通信：调度器可以随时收紧预算，搜索线程定期检查
+class CSearchControl {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    CSearchControl(Clock::time_point tpDeadline, long long llNodeBudget, int iThreadShare)
+        : m_tpDeadline(tpDeadline), m_atNodeBudget(llNodeBudget),
+          m_atNodes(0), m_atThreadShare(iThreadShare), m_atParticipants(0), m_atEntered(0), m_atShed(0),
+          m_atStop(false) {}
+
+    // 不限时、不限量 (单机对战用)
+    static CSearchControl Unlimited() {
+        return CSearchControl(Clock::time_point::max(), -1, 1);
+    }
+
+    // 记一个节点，返回 false 表示预算用完应当停止
+    bool CountNode() {
+        long long llUsed = ++m_atNodes;
+        long long llBudget = m_atNodeBudget.load(std::memory_order_relaxed);
+        if (llBudget >= 0 && llUsed > llBudget) return false;
+        // 份额被收紧：多出来的线程在这里退出 (平时只多两次读)
+        if (m_atParticipants.load(std::memory_order_relaxed) > m_atThreadShare.load(std::memory_order_relaxed) ||
+            m_atShed.load(std::memory_order_relaxed) > 0) {
+            if (LeaveIfOverShare()) return false;
+        }
+        return !ShouldStop();
+    }
+
+    // 一次记 llCount 个节点 (整批算完的工作，比如一次算出的全盘评分)
+    bool CountNodes(long long llCount) {
+        long long llUsed = (m_atNodes += llCount);
+        long long llBudget = m_atNodeBudget.load(std::memory_order_relaxed);
+        if (llBudget >= 0 && llUsed > llBudget) return false;
+        return !ShouldStop();
+    }
+
+    // 超时或被要求停止
+    bool ShouldStop() const {
+        if (m_atStop.load(std::memory_order_relaxed)) return true;
+        if (m_tpDeadline != Clock::time_point::max() && Clock::now() >= m_tpDeadline) return true;
+        return false;
+    }
+
+    void Stop() { m_atStop = true; }
+
+    // 调度器在负载高时收紧预算 (只减不增)
+    void ShrinkNodeBudget(long long llBudget) {
+        long long llOld = m_atNodeBudget.load();
+        while ((llOld < 0 || llBudget < llOld) &&
+               !m_atNodeBudget.compare_exchange_weak(llOld, llBudget)) {}
+    }
+
+    void SetThreadShare(int iShare) { m_atThreadShare = iShare < 1 ? 1 : iShare; }
+    int GetThreadShare() const { return m_atThreadShare; }
+
+    // 调度器在线程进出这次搜索时调用；份额只约束这样登记过的线程
+    // 第一个进来的线程不会被请走，保证单线程的搜索 (比如 MCTS) 总有人做完
+    void Enter() {
+        SSeat& seat = CurrentSeat();
+        seat.pCtl = this;
+        seat.bOwner = (m_atEntered++ == 0);
+        seat.bShed = false;
+        m_atParticipants++;
+    }
+
+    // 返回 true 表示这个线程是因为份额收紧被请走的 (搜索本身没做完)
+    bool Exit() {
+        SSeat& seat = CurrentSeat();
+        bool bShed = seat.bShed;
+        if (bShed) {
+            m_atShed--;
+        } else {
+            m_atParticipants--;
+        }
+        seat.pCtl = nullptr;
+        return bShed;
+    }
+
+    // 仍在搜索的登记线程数
+    int GetParticipants() const { return m_atParticipants; }
+
+    long long GetNodes() const { return m_atNodes; }
+    long long GetNodeBudget() const { return m_atNodeBudget; }
+    Clock::time_point GetDeadline() const { return m_tpDeadline; }
+
+    CSearchControl(const CSearchControl& other)
+        : m_tpDeadline(other.m_tpDeadline), m_atNodeBudget(other.m_atNodeBudget.load()),
+          m_atNodes(other.m_atNodes.load()), m_atThreadShare(other.m_atThreadShare.load()),
+          m_atParticipants(0), m_atEntered(0), m_atShed(0), m_atStop(other.m_atStop.load()) {}
+
+private:
+    // 当前线程登记在哪次搜索上
+    struct SSeat {
+        const CSearchControl* pCtl;
+        bool bOwner;
+        bool bShed;
+    };
+
+    static SSeat& CurrentSeat() {
+        static thread_local SSeat s_stSeat = { nullptr, false, false };
+        return s_stSeat;
+    }
+
+    // 线程数超过份额时，让当前线程 (不是第一个进来的) 退出；已经被请走的线程一直返回 true
+    bool LeaveIfOverShare() {
+        SSeat& seat = CurrentSeat();
+        if (seat.pCtl != this || seat.bOwner) return false;
+        if (seat.bShed) return true;
+        int iActive = m_atParticipants.load();
+        while (iActive > m_atThreadShare.load()) {
+            if (m_atParticipants.compare_exchange_weak(iActive, iActive - 1)) {
+                seat.bShed = true;
+                m_atShed++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Clock::time_point m_tpDeadline;
+    std::atomic<long long> m_atNodeBudget; // <0 表示不限
+    std::atomic<long long> m_atNodes;
+    std::atomic<int> m_atThreadShare;      // 允许同时参与这次搜索的线程数
+    std::atomic<int> m_atParticipants;     // 登记了、还没被请走的线程数
+    std::atomic<int> m_atEntered;          // 累计登记过的线程数
+    std::atomic<int> m_atShed;             // 已被请走、还没退出的线程数
+    std::atomic<bool> m_atStop;
+};
+
+// 一次可拆分的搜索 (与棋盘大小/规则无关的接口，调度器和服务器只认它)
+// 多个工作线程可以同时调用 Run；全部退出后调用一次 Finish 取结果
+class CSearchTask {
+public:
+    virtual ~CSearchTask() {}
+
+    // 线程安全，可并发进入；预算用完或超时就返回
+    virtual void Run(CSearchControl& ctl) = 0;
+
+    // 所有 Run 返回后调用，返回选中的落点
+    virtual Point Finish() = 0;
+};
+
+#endif
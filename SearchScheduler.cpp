@@ -0,0 +1,223 @@
+#include "SearchScheduler.h"
+#include "Trace.h"
+#include <algorithm>
+
+using namespace std;
+
+// 负载再高，每次搜索也至少要看这么多节点，否则棋力崩溃
+static const long long MIN_NODE_BUDGET = 32;
+
+CSearchScheduler::CSearchScheduler(int iThreads, int iMaxThreadShare)
+    : m_bStopping(false), m_iMaxThreadShare(iMaxThreadShare), m_dTotalWaitMs(0), m_dNsPerNode(0) {
+    if (iThreads < 1) iThreads = 1;
+    if (m_iMaxThreadShare < 1) m_iMaxThreadShare = 1;
+    for (int i = 0; i < iThreads; i++) {
+        m_vecWorkers.push_back(thread(&CSearchScheduler::WorkerLoop, this));
+    }
+}
+
+CSearchScheduler::~CSearchScheduler() {
+    Shutdown();
+}
+
+bool CSearchScheduler::LaterDeadline(const JobPtr& a, const JobPtr& b) {
+    return a->pCtl->GetDeadline() > b->pCtl->GetDeadline();
+}
+
+void CSearchScheduler::Submit(Clock::time_point tpDeadline, long long llNodeBudget,
+                              RunFunc fnRun, DoneFunc fnDone) {
+    JobPtr pJob = make_shared<SJob>();
+    pJob->pCtl = make_shared<CSearchControl>(tpDeadline, llNodeBudget, 1);
+    pJob->fnRun = fnRun;
+    pJob->fnDone = fnDone;
+    pJob->llBaseBudget = llNodeBudget;
+    pJob->tpSubmit = Clock::now();
+    pJob->iParticipants = 0;
+    pJob->bClosed = false;
+    pJob->dWorkerNs = 0;
+
+    {
+        lock_guard<mutex> lock(m_mtx);
+        if (m_bStopping) return;
+        m_vecPending.push_back(pJob);
+        push_heap(m_vecPending.begin(), m_vecPending.end(), LaterDeadline);
+
+        m_stStats.llSubmitted++;
+        m_stStats.iMaxQueueDepth = max(m_stStats.iMaxQueueDepth, (int)m_vecPending.size());
+        Rebalance();
+    }
+    m_cv.notify_one();
+}
+
+void CSearchScheduler::Shutdown() {
+    {
+        lock_guard<mutex> lock(m_mtx);
+        m_bStopping = true;
+    }
+    m_cv.notify_all();
+    for (size_t i = 0; i < m_vecWorkers.size(); i++) {
+        if (m_vecWorkers[i].joinable()) m_vecWorkers[i].join();
+    }
+    m_vecWorkers.clear();
+}
+
+int CSearchScheduler::GetThreadCount() const {
+    return (int)m_vecWorkers.size();
+}
+
+SSchedulerStats CSearchScheduler::GetStats() {
+    lock_guard<mutex> lock(m_mtx);
+    SSchedulerStats stStats = m_stStats;
+    stStats.iQueueDepth = (int)m_vecPending.size();
+    stStats.iRunning = (int)m_vecRunning.size();
+    long long llStarted = m_stStats.llSubmitted - (long long)m_vecPending.size();
+    stStats.dAvgWaitMs = llStarted > 0 ? m_dTotalWaitMs / llStarted : 0;
+    stStats.dNsPerNode = m_dNsPerNode;
+    return stStats;
+}
+
+CSearchScheduler::JobPtr CSearchScheduler::PickJob() {
+    // 1. 有排队的请求：截止时间最早的先上
+    if (!m_vecPending.empty()) {
+        pop_heap(m_vecPending.begin(), m_vecPending.end(), LaterDeadline);
+        JobPtr pJob = m_vecPending.back();
+        m_vecPending.pop_back();
+
+        m_dTotalWaitMs += chrono::duration<double, milli>(Clock::now() - pJob->tpSubmit).count();
+        m_vecRunning.push_back(pJob);
+        Rebalance();
+        return pJob;
+    }
+
+    // 2. 没有排队的：去帮截止时间最早、还有份额空位的搜索；同样截止时间先帮剩余预算多的
+    JobPtr pBest;
+    for (size_t i = 0; i < m_vecRunning.size(); i++) {
+        const JobPtr& pJob = m_vecRunning[i];
+        if (pJob->bClosed || pJob->pCtl->GetParticipants() >= pJob->pCtl->GetThreadShare()) continue;
+        if (!pBest || pJob->pCtl->GetDeadline() < pBest->pCtl->GetDeadline()) {
+            pBest = pJob;
+        } else if (pJob->pCtl->GetDeadline() == pBest->pCtl->GetDeadline()) {
+            long long llLeftA = pJob->pCtl->GetNodeBudget() - pJob->pCtl->GetNodes();
+            long long llLeftB = pBest->pCtl->GetNodeBudget() - pBest->pCtl->GetNodes();
+            if (llLeftA > llLeftB) pBest = pJob;
+        }
+    }
+    return pBest;
+}
+
+void CSearchScheduler::Rebalance() {
+    int iWorkers = max(1, (int)m_vecWorkers.size());
+
+    if (m_vecPending.empty()) {
+        // 有空闲线程：平分给正在运行的搜索
+        if (m_vecRunning.empty()) return;
+        int iShare = min(m_iMaxThreadShare, max(1, iWorkers / (int)m_vecRunning.size()));
+        for (size_t i = 0; i < m_vecRunning.size(); i++) {
+            m_vecRunning[i]->pCtl->SetThreadShare(iShare);
+        }
+        return;
+    }
+
+    // 过载：线程全被占了还有人排队，每个搜索只留一个线程
+    // 多出来的线程在下一次 CountNode 时退出，回来做排队的请求
+    for (size_t i = 0; i < m_vecRunning.size(); i++) {
+        m_vecRunning[i]->pCtl->SetThreadShare(1);
+    }
+    if (m_dNsPerNode <= 0) return; // 还不知道速度，先不砍预算
+
+    // 估算：所有活 (剩余节点) 按实测速度要多久，能否赶在排队里最紧的截止时间前做完
+    double dDemand = 0;
+    for (size_t i = 0; i < m_vecRunning.size(); i++) {
+        const CSearchControl& ctl = *m_vecRunning[i]->pCtl;
+        if (ctl.GetNodeBudget() >= 0) dDemand += (double)max(0LL, ctl.GetNodeBudget() - ctl.GetNodes());
+    }
+    Clock::time_point tpEarliest = Clock::time_point::max();
+    for (size_t i = 0; i < m_vecPending.size(); i++) {
+        const CSearchControl& ctl = *m_vecPending[i]->pCtl;
+        if (ctl.GetNodeBudget() >= 0) dDemand += (double)ctl.GetNodeBudget();
+        tpEarliest = min(tpEarliest, ctl.GetDeadline());
+    }
+    if (dDemand <= 0 || tpEarliest == Clock::time_point::max()) return;
+
+    double dAvailNs = chrono::duration<double, nano>(tpEarliest - Clock::now()).count();
+    double dCapacity = max(0.0, dAvailNs) * iWorkers / m_dNsPerNode;
+    if (dCapacity >= dDemand) return; // 来得及，不用砍
+
+    // 来不及：所有搜索按同一比例缩小预算 (运行中和排队中的都算)
+    double dFactor = dCapacity / dDemand;
+    for (int pass = 0; pass < 2; pass++) {
+        vector<JobPtr>& vecJobs = (pass == 0) ? m_vecRunning : m_vecPending;
+        for (size_t i = 0; i < vecJobs.size(); i++) {
+            SJob& job = *vecJobs[i];
+            if (job.llBaseBudget < 0) continue;
+
+            long long llNew = max(MIN_NODE_BUDGET, (long long)(job.llBaseBudget * dFactor));
+            if (llNew < job.pCtl->GetNodeBudget()) {
+                job.pCtl->ShrinkNodeBudget(llNew);
+                m_stStats.llBudgetShrinks++;
+            }
+        }
+    }
+}
+
+void CSearchScheduler::WorkerLoop() {
+    CTrace::SetThreadName("search worker");
+    while (true) {
+        JobPtr pJob;
+        {
+            WZQ_TRACE_SCOPE("sched.wait", "pool");
+            unique_lock<mutex> lock(m_mtx);
+            m_cv.wait(lock, [this, &pJob] {
+                pJob = PickJob();
+                return pJob || m_bStopping;
+            });
+            // 停止时也把排队的请求做完，避免对局卡在"思考中"
+            if (!pJob) return;
+            pJob->iParticipants++;
+            pJob->pCtl->Enter();
+        }
+
+        Clock::time_point tpRunStart = Clock::now();
+        {
+            WZQ_TRACE_SCOPE("sched.run", "pool");
+            pJob->fnRun(*pJob->pCtl);
+        }
+        double dRunNs = chrono::duration<double, nano>(Clock::now() - tpRunStart).count();
+
+        bool bLast = false;
+        {
+            lock_guard<mutex> lock(m_mtx);
+            pJob->iParticipants--;
+            pJob->dWorkerNs += dRunNs;
+            if (pJob->pCtl->Exit()) {
+                m_stStats.llThreadsShed++;
+            } else {
+                pJob->bClosed = true; // 有线程做完说明活已经分完了
+            }
+            if (pJob->iParticipants == 0) {
+                bLast = true;
+                m_vecRunning.erase(find(m_vecRunning.begin(), m_vecRunning.end(), pJob));
+
+                m_stStats.llCompleted++;
+                long long llNodes = pJob->pCtl->GetNodes();
+                if (llNodes > 0) {
+                    double dSample = pJob->dWorkerNs / llNodes;
+                    m_dNsPerNode = (m_dNsPerNode <= 0) ? dSample : m_dNsPerNode * 0.9 + dSample * 0.1;
+                }
+                Clock::time_point tpNow = Clock::now();
+                if (tpNow > pJob->pCtl->GetDeadline()) {
+                    m_stStats.llDeadlineMisses++;
+                    double dLate = chrono::duration<double, milli>(tpNow - pJob->pCtl->GetDeadline()).count();
+                    m_stStats.dMaxLatenessMs = max(m_stStats.dMaxLatenessMs, dLate);
+                }
+                Rebalance();
+            }
+        }
+
+        if (bLast) {
+            WZQ_TRACE_SCOPE("sched.done", "pool");
+            pJob->fnDone(*pJob->pCtl);
+        }
+        m_cv.notify_all(); // 份额可能变了，叫醒空闲线程去帮忙
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef _SEARCHSCHEDULER_H_
+#define _SEARCHSCHEDULER_H_
+
+#include "SearchControl.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+// 调度器统计 (用来按真实数据规划机器容量)
+struct SSchedulerStats {
+    int iQueueDepth = 0;          // 当前排队的请求数
+    int iMaxQueueDepth = 0;       // 历史最大排队数
+    int iRunning = 0;             // 正在搜索的请求数
+    long long llSubmitted = 0;    // 累计提交
+    long long llCompleted = 0;    // 累计完成
+    long long llDeadlineMisses = 0; // 完成时已过截止时间的次数
+    long long llBudgetShrinks = 0;  // 因负载收紧预算的次数
+    long long llThreadsShed = 0;    // 份额收紧时从运行中的搜索里撤出的线程数
+    double dNsPerNode = 0;        // 实测每节点耗时 (纳秒)
+    double dAvgWaitMs = 0;        // 平均排队时间
+    double dMaxLatenessMs = 0;    // 最严重的超时 (毫秒)
+};
+
+// 截止时间优先的搜索调度器
+// 所有 AI 落子请求都交给它：按最早截止时间 (EDF) 分配工作线程，
+// 空闲线程会加入截止时间最早的正在运行的搜索；排队变长时收紧所有搜索的节点预算
+class CSearchScheduler {
+public:
+    typedef CSearchControl::Clock Clock;
+
+    // fnRun 可能被多个线程同时调用 (线程份额 > 1 时)，每个线程返回后不再进入
+    // fnDone 在最后一个参与线程退出后调用一次
+    typedef std::function<void(CSearchControl&)> RunFunc;
+    typedef std::function<void(CSearchControl&)> DoneFunc;
+
+    explicit CSearchScheduler(int iThreads, int iMaxThreadShare = 4);
+    ~CSearchScheduler();
+
+    // 提交一个请求：截止时间 + 节点预算 (不限则传 -1)
+    void Submit(Clock::time_point tpDeadline, long long llNodeBudget,
+                RunFunc fnRun, DoneFunc fnDone);
+
+    void Shutdown();
+
+    int GetThreadCount() const;
+    SSchedulerStats GetStats();
+
+private:
+    struct SJob {
+        std::shared_ptr<CSearchControl> pCtl;
+        RunFunc fnRun;
+        DoneFunc fnDone;
+        long long llBaseBudget;     // 提交时的预算，收紧按它的比例算
+        Clock::time_point tpSubmit;
+        int iParticipants;          // 正在执行 fnRun 的线程数
+        bool bClosed;               // 已有线程做完 (不算被请走的)，不再接纳新线程
+        double dWorkerNs;           // 所有参与线程累计花在 fnRun 里的时间
+    };
+    typedef std::shared_ptr<SJob> JobPtr;
+
+    std::vector<std::thread> m_vecWorkers;
+    std::vector<JobPtr> m_vecPending;   // 按截止时间排的小顶堆
+    std::vector<JobPtr> m_vecRunning;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_bStopping;
+    int m_iMaxThreadShare;
+
+    SSchedulerStats m_stStats;
+    double m_dTotalWaitMs;
+    double m_dNsPerNode;    // 实测的每节点耗时 (指数滑动平均)，0 表示还没有数据
+
+    void WorkerLoop();
+
+    // 选下一个要做的请求 (必须持锁)，没有则返回空
+    JobPtr PickJob();
+
+    // 根据当前负载重新分配线程份额和预算 (必须持锁)
+    // 排队的活按实测速度在最紧的截止时间前做不完时，才按比例收紧节点预算
+    void Rebalance();
+
+    static bool LaterDeadline(const JobPtr& a, const JobPtr& b);
+};
+
+#endif
@@ -0,0 +1,137 @@
+#include "SearchScheduler.h"
+#include "Checks.h"
+#include "AIPlayer.h"
+#include "GameSession.h"
+#include "Rules.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 贪心自对弈摆出中局，再打开搜索深度 (与服务器上 NEW 带深度的对局相同的设置)
+static shared_ptr<CGameSession> MakeMidgame(int iDepth, int iPlies, shared_ptr<const AIWeights> pWeights) {
+    shared_ptr<CGameSession> pSession = CGameSession::Create(1, MODE_AI_VS_AI, BOARD_SIZE, RULE_RENJU, pWeights);
+    for (int i = 0; i < iPlies && pSession->IsAITurn(); i++) {
+        shared_ptr<CSearchTask> pTask = pSession->CreateAITask();
+        CSearchControl ctl = CSearchControl::Unlimited();
+        pTask->Run(ctl);
+        pSession->ApplyAIMove(pTask->Finish());
+    }
+    pSession->SetAISearch(iDepth, AI_TT_ENTRIES);
+    return pSession;
+}
+
+// 按服务器的预算搜一手 (llShrink >= 0 时先把预算收紧到这么多)，返回节点数；落子不是空位时 *pValid 为 false
+static long long SearchOnce(CGameSession& session, long long llShrink, bool* pValid) {
+    shared_ptr<CSearchTask> pTask = session.CreateAITask();
+    CSearchControl ctl(CSearchControl::Clock::now() + chrono::seconds(60), session.GetAINodeBudget(), 1);
+    if (llShrink >= 0) ctl.ShrinkNodeBudget(llShrink);
+    pTask->Run(ctl);
+    Point p = pTask->Finish();
+    int N = session.GetBoardSize();
+    *pValid = p.iX >= 0 && p.iX < N && p.iY >= 0 && p.iY < N && session.GetBoardString()[p.iY * N + p.iX] == '.';
+    return ctl.GetNodes();
+}
+
+// 预算收紧自检：WuZiQiDemo --check-budget [深度] [局面数]
+// 服务器上开了搜索深度的对局按 GetAINodeBudget 提交给调度器，这里检查收紧预算确实少搜了节点：
+// 1. 同一局面从快照恢复出两份 (置换表也相同)，一份照原预算搜，一份先收紧到前者实际用量的 1/4：
+//    收紧的那次不能超出新预算，节点数必须更少，落子仍是空位
+// 2. 单线程调度器上先单独跑一手测出速度，再一次提交 8 手、截止时间只留 50 毫秒：调度器必须收紧预算，
+//    这 8 手的平均节点数必须少于单独跑的那一手
+int RunBudgetCheck(int argc, char* argv[]) {
+    int iDepth = (argc > 2) ? atoi(argv[2]) : 4;
+    int iPositions = (argc > 3) ? atoi(argv[3]) : 4;
+    if (iDepth < 1) iDepth = 1;
+    shared_ptr<const AIWeights> pWeights = make_shared<AIWeights>();
+    const string strFile = "check_budget.bin";
+    const int LOADED_MOVES = 8;
+
+    int iFailures = 0;
+    string strError;
+    long long arrTotal[2] = { 0, 0 };
+    for (int i = 0; i < iPositions; i++) {
+        shared_ptr<CGameSession> pSession = MakeMidgame(iDepth, 4 + 2 * i, pWeights);
+        if (!pSession->IsAITurn() || !pSession->SaveSnapshot(strFile, &strError)) continue;
+        shared_ptr<CGameSession> pFull = CGameSession::LoadSnapshot(strFile, 1, pWeights, &strError);
+        shared_ptr<CGameSession> pCut = CGameSession::LoadSnapshot(strFile, 1, pWeights, &strError);
+        if (!pFull || !pCut) {
+            cout << " [失败] 快照: " << strError << endl;
+            iFailures++;
+            continue;
+        }
+
+        bool bFullValid, bCutValid;
+        long long llFull = SearchOnce(*pFull, -1, &bFullValid);
+        long long llBudget = max(1LL, llFull / 4);
+        long long llCut = SearchOnce(*pCut, llBudget, &bCutValid);
+        arrTotal[0] += llFull;
+        arrTotal[1] += llCut;
+        // CountNode 在用量超过预算的那一个节点上返回 false
+        bool bOk = bFullValid && bCutValid && llCut <= llBudget + 1 && llCut < llFull;
+        cout << " 局面#" << i << ": 原预算 " << pFull->GetAINodeBudget() << " 用了 " << llFull
+             << " 节点, 收紧到 " << llBudget << " 后用了 " << llCut << " 节点" << (bOk ? "" : "  [失败]") << endl;
+        if (!bOk) iFailures++;
+    }
+
+    // 调度器：按服务器的方式提交 (同一局面的多份副本)，在 fnDone 里记下每手的节点数
+    shared_ptr<CGameSession> pSession = MakeMidgame(iDepth, 8, pWeights);
+    pSession->SaveSnapshot(strFile, &strError);
+    CSearchScheduler scheduler(1);
+    mutex mtx;
+    condition_variable cv;
+    vector<long long> vecNodes;
+    auto SubmitMove = [&](CSearchScheduler::Clock::time_point tpDeadline) {
+        shared_ptr<CGameSession> pCopy = CGameSession::LoadSnapshot(strFile, 1, pWeights, &strError);
+        if (!pCopy) return false;
+        shared_ptr<CSearchTask> pTask = pCopy->CreateAITask();
+        scheduler.Submit(tpDeadline, pCopy->GetAINodeBudget(),
+            [pTask](CSearchControl& ctl) { pTask->Run(ctl); },
+            [pCopy, pTask, &mtx, &cv, &vecNodes](CSearchControl& ctl) {
+                pTask->Finish();
+                lock_guard<mutex> lock(mtx);
+                vecNodes.push_back(ctl.GetNodes());
+                cv.notify_all();
+            });
+        return true;
+    };
+    auto WaitFor = [&](size_t iCount) {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [&] { return vecNodes.size() >= iCount; });
+    };
+
+    bool bSubmitted = SubmitMove(CSearchScheduler::Clock::now() + chrono::seconds(60));
+    if (bSubmitted) WaitFor(1);
+    for (int k = 0; k < LOADED_MOVES && bSubmitted; k++) {
+        bSubmitted = SubmitMove(CSearchScheduler::Clock::now() + chrono::milliseconds(50));
+    }
+    if (bSubmitted) WaitFor(1 + LOADED_MOVES);
+    SSchedulerStats stSched = scheduler.GetStats();
+    scheduler.Shutdown();
+    remove(strFile.c_str());
+
+    if (!bSubmitted) {
+        cout << " [失败] 快照: " << strError << endl;
+        iFailures++;
+    } else {
+        long long llLoaded = 0;
+        for (int k = 1; k <= LOADED_MOVES; k++) llLoaded += vecNodes[k];
+        llLoaded /= LOADED_MOVES;
+        bool bOk = stSched.llBudgetShrinks > 0 && llLoaded < vecNodes[0];
+        cout << " 调度器: 单独一手 " << vecNodes[0] << " 节点, 过载时平均 " << llLoaded << " 节点, 收紧预算 "
+             << stSched.llBudgetShrinks << " 次, 每节点 " << stSched.dNsPerNode << " ns" << (bOk ? "" : "  [失败]") << endl;
+        if (!bOk) iFailures++;
+    }
+
+    cout << (iFailures == 0 ? "[通过]" : "[失败]") << " 深度 " << iDepth << ", " << iPositions
+         << " 个局面, 原预算共 " << arrTotal[0] << " 节点, 收紧后共 " << arrTotal[1] << " 节点" << endl;
+    return iFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,744 @@
+#include "SmallSolver.h"
+#include "ByteIO.h"
+#include "Referee.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+const char* GetSolveValueName(int iValue) {
+    switch (iValue) {
+    case SOLVE_WIN:  return "win";
+    case SOLVE_DRAW: return "draw";
+    case SOLVE_LOSS: return "loss";
+    default:         return "unknown";
+    }
+}
+
+// 搜索值 (-1 / 0 / 1) 与 ESolveValue 互转
+static int ValueToSolve(int iValue) {
+    return iValue > 0 ? SOLVE_WIN : (iValue < 0 ? SOLVE_LOSS : SOLVE_DRAW);
+}
+
+static int SolveToValue(int iSolve) {
+    return iSolve == SOLVE_WIN ? 1 : (iSolve == SOLVE_LOSS ? -1 : 0);
+}
+
+template <int N, class TRule>
+CSmallSolverT<N, TRule>::CSmallSolverT(CTransTable* pTT)
+    : m_pTT(pTT), m_pOpeningKeys(NULL), m_pOpeningValues(NULL), m_iOpeningPly(-1), m_pCtl(NULL),
+      m_bAbort(false), m_llNodes(0), m_iStones(0), m_iWindows(0) {
+    // 所有 5 格窗口 (横、竖、两条斜线)
+    memset(m_arrCellWindowCount, 0, sizeof(m_arrCellWindowCount));
+    const int dx[] = { 1, 0, 1, 1 };
+    const int dy[] = { 0, 1, 1, -1 };
+    for (int d = 0; d < 4; d++) {
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                int ex = x + dx[d] * (WIN_LEN - 1), ey = y + dy[d] * (WIN_LEN - 1);
+                if (ex < 0 || ex >= N || ey < 0 || ey >= N) continue;
+                for (int k = 0; k < WIN_LEN; k++) {
+                    int iCell = (y + dy[d] * k) * N + (x + dx[d] * k);
+                    m_arrWindowCells[m_iWindows][k] = (uint8_t)iCell;
+                    m_arrCellWindows[iCell][m_arrCellWindowCount[iCell]++] = (uint16_t)m_iWindows;
+                }
+                m_iWindows++;
+            }
+        }
+    }
+
+    // 正方形的 8 种对称 (恒等、左右、上下、旋转 180、转置及其组合)
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int arrX[8] = { x, N - 1 - x, x, N - 1 - x, y, N - 1 - y, y, N - 1 - y };
+            int arrY[8] = { y, y, N - 1 - y, N - 1 - y, x, x, N - 1 - x, N - 1 - x };
+            for (int s = 0; s < 8; s++) {
+                int iTo = arrY[s] * N + arrX[s];
+                m_arrSym[s][y * N + x] = (uint8_t)iTo;
+                m_arrInverse[s][iTo] = (uint8_t)(y * N + x);
+            }
+        }
+    }
+
+    memset(m_arrCount, 0, sizeof(m_arrCount));
+    m_arrOpen[0] = m_arrOpen[1] = m_iWindows;
+    memset(m_arrHash, 0, sizeof(m_arrHash));
+}
+
+template <int N, class TRule>
+void CSmallSolverT<N, TRule>::SetOpeningTable(const vector<uint64_t>* pKeys, const atomic<uint8_t>* pValues, int iMaxPly) {
+    m_pOpeningKeys = pKeys;
+    m_pOpeningValues = pValues;
+    m_iOpeningPly = iMaxPly;
+}
+
+template <int N, class TRule>
+void CSmallSolverT<N, TRule>::Place(int iCell, int color) {
+    m_board.PlacePiece(iCell % N, iCell / N, color);
+    m_iStones++;
+    for (int s = 0; s < 8; s++) m_arrHash[s] ^= CZobrist::Piece(color, m_arrSym[s][iCell]);
+    int c = color - 1;
+    for (int i = 0; i < m_arrCellWindowCount[iCell]; i++) {
+        int w = m_arrCellWindows[iCell][i];
+        if (m_arrCount[c][w]++ == 0) m_arrOpen[1 - c]--; // 窗口里第一颗 c 色子，对方再也用不上它
+    }
+}
+
+template <int N, class TRule>
+void CSmallSolverT<N, TRule>::Undo(int iCell, int color) {
+    m_board.UndoPiece(iCell % N, iCell / N);
+    m_iStones--;
+    for (int s = 0; s < 8; s++) m_arrHash[s] ^= CZobrist::Piece(color, m_arrSym[s][iCell]);
+    int c = color - 1;
+    for (int i = 0; i < m_arrCellWindowCount[iCell]; i++) {
+        int w = m_arrCellWindows[iCell][i];
+        if (--m_arrCount[c][w] == 0) m_arrOpen[1 - c]++;
+    }
+}
+
+template <int N, class TRule>
+uint64_t CSmallSolverT<N, TRule>::CanonicalKey(int* pSym) const {
+    int iBest = 0;
+    for (int s = 1; s < 8; s++) {
+        if (m_arrHash[s] < m_arrHash[iBest]) iBest = s;
+    }
+    *pSym = iBest;
+    return m_arrHash[iBest];
+}
+
+template <int N, class TRule>
+int CSmallSolverT<N, TRule>::CanonicalCell(int iCell) const {
+    int iSym;
+    CanonicalKey(&iSym);
+    return m_arrSym[iSym][iCell];
+}
+
+template <int N, class TRule>
+int CSmallSolverT<N, TRule>::FromCanonicalCell(int iCell) const {
+    int iSym;
+    CanonicalKey(&iSym);
+    return m_arrInverse[iSym][iCell];
+}
+
+template <int N, class TRule>
+bool CSmallSolverT<N, TRule>::IsWinningMove(int iCell, int color) {
+    int x = iCell % N, y = iCell / N;
+    m_board.PlacePiece(x, y, color);
+    bool bWin = CRefereeT<N, TRule>::CheckWin(m_board, x, y);
+    m_board.UndoPiece(x, y);
+    return bWin;
+}
+
+// 只在确认不成五以后调用
+template <int N, class TRule>
+bool CSmallSolverT<N, TRule>::IsForbidden(int iCell) {
+    if (!TRule::HAS_FORBIDDEN) return false;
+    int x = iCell % N, y = iCell / N;
+    m_board.PlacePiece(x, y, BLACK);
+    bool bForbidden = CRefereeT<N, TRule>::CheckForbidden(m_board, x, y);
+    m_board.UndoPiece(x, y);
+    return bForbidden;
+}
+
+// color 是否已经不可能占满任何窗口 (对方只管破坏)
+// Erdős–Selfridge：势 = Σ 2^(窗口里 color 的子数)，只算不含对方棋子的窗口 (即 32 × Σ 2^-空格数)
+// 对方先走时势 < 32，或 color 先走时势加上它一步能带来的最大增量仍 < 32，对方就能让它永远凑不满一个窗口
+// 势判断不了的再试配对策略
+template <int N, class TRule>
+bool CSmallSolverT<N, TRule>::CannotWin(int color, bool bToMove) const {
+    int c = color - 1;
+    if (m_arrOpen[c] == 0) return true;
+    int iPotential = 0;
+    for (int w = 0; w < m_iWindows; w++) {
+        if (m_arrCount[1 - c][w] != 0) continue;
+        iPotential += 1 << m_arrCount[c][w];
+        if (iPotential >= 32) return false;
+    }
+    if (!bToMove) return true;
+    int iMaxGain = 0;
+    for (int iCell = 0; iCell < CELLS; iCell++) {
+        if (m_board.GetPiece(iCell % N, iCell / N) != EMPTY) continue;
+        int iGain = 0;
+        for (int i = 0; i < m_arrCellWindowCount[iCell]; i++) {
+            int w = m_arrCellWindows[iCell][i];
+            if (m_arrCount[1 - c][w] == 0) iGain += 1 << m_arrCount[c][w];
+        }
+        iMaxGain = max(iMaxGain, iGain);
+    }
+    if (iPotential + iMaxGain < 32) return true;
+    return HasBlockingPairs(color);
+}
+
+// 配对策略：给 color 还能用的每个窗口指定一对空格，各对互不相交 (一对可以同时管好几个窗口)
+// color 下了某一对里的一格，对方就下另一格，哪个窗口都占不满；谁先走都成立
+// 回溯找配对，步数有上限，找不到只说明这个办法不行
+template <int N, class TRule>
+bool CSmallSolverT<N, TRule>::HasBlockingPairs(int color) const {
+    int c = color - 1;
+    int arrWindows[MAX_WINDOWS];
+    int iWindows = 0;
+    for (int w = 0; w < m_iWindows; w++) {
+        if (m_arrCount[1 - c][w] != 0) continue;
+        int iEmpty = WIN_LEN - m_arrCount[c][w];
+        if (iEmpty < 2) return false;
+        // 空格少的窗口选择少，先定
+        int j = iWindows++;
+        while (j > 0 && WIN_LEN - m_arrCount[c][arrWindows[j - 1]] > iEmpty) {
+            arrWindows[j] = arrWindows[j - 1];
+            j--;
+        }
+        arrWindows[j] = w;
+    }
+    int arrPartner[CELLS];
+    for (int i = 0; i < CELLS; i++) arrPartner[i] = -1;
+    int iSteps = 0;
+    return AssignPairs(arrWindows, iWindows, 0, arrPartner, &iSteps);
+}
+
+template <int N, class TRule>
+bool CSmallSolverT<N, TRule>::AssignPairs(const int* pWindows, int iWindows, int iAt, int* pPartner, int* pSteps) const {
+    while (iAt < iWindows) {
+        // 已经有一对落在这个窗口里就不用再管
+        const uint8_t* pCells = m_arrWindowCells[pWindows[iAt]];
+        bool bCovered = false;
+        for (int a = 0; a < WIN_LEN && !bCovered; a++) {
+            int iPartner = pPartner[pCells[a]];
+            for (int b = 0; b < WIN_LEN && iPartner >= 0; b++) {
+                if (pCells[b] == iPartner) {
+                    bCovered = true;
+                    break;
+                }
+            }
+        }
+        if (!bCovered) break;
+        iAt++;
+    }
+    if (iAt == iWindows) return true;
+    if (++*pSteps > PAIR_STEP_LIMIT) return false;
+
+    // 相邻的两格同时落在这条线的更多窗口里，先试
+    const uint8_t* pCells = m_arrWindowCells[pWindows[iAt]];
+    for (int iGap = 1; iGap < WIN_LEN; iGap++) {
+        for (int a = 0; a + iGap < WIN_LEN; a++) {
+            int x = pCells[a], y = pCells[a + iGap];
+            if (pPartner[x] >= 0 || pPartner[y] >= 0) continue;
+            if (m_board.GetPiece(x % N, x / N) != EMPTY || m_board.GetPiece(y % N, y / N) != EMPTY) continue;
+            pPartner[x] = y;
+            pPartner[y] = x;
+            if (AssignPairs(pWindows, iWindows, iAt + 1, pPartner, pSteps)) return true;
+            pPartner[x] = pPartner[y] = -1;
+            if (*pSteps > PAIR_STEP_LIMIT) return false;
+        }
+    }
+    return false;
+}
+
+template <int N, class TRule>
+bool CSmallSolverT<N, TRule>::LookupOpening(uint64_t ullKey, int* pValue) const {
+    if (m_pOpeningKeys == NULL || m_iStones > m_iOpeningPly) return false;
+    vector<uint64_t>::const_iterator it = lower_bound(m_pOpeningKeys->begin(), m_pOpeningKeys->end(), ullKey);
+    if (it == m_pOpeningKeys->end() || *it != ullKey) return false;
+    int iSolve = m_pOpeningValues[it - m_pOpeningKeys->begin()].load(memory_order_acquire);
+    if (iSolve == SOLVE_UNKNOWN) return false;
+    *pValue = SolveToValue(iSolve);
+    return true;
+}
+
+template <int N, class TRule>
+int CSmallSolverT<N, TRule>::Search(int toMove, int alpha, int beta, int* pBest) {
+    *pBest = -1;
+    if (!m_pCtl->CountNode()) {
+        m_bAbort = true;
+        return 0;
+    }
+    m_llNodes++;
+    if (m_iStones == CELLS) return 0;
+
+    int me = toMove - 1, op = 2 - toMove;
+    int opColor = 3 - toMove;
+
+    // 黑棋没有可用窗口时也下不出禁手 (长连、活三、四都离不开不含白子的 5 格)，所以双方都没有就是和棋
+    if (m_arrOpen[me] == 0 && m_arrOpen[op] == 0) return 0;
+    // 成不了五的一方最多和棋；连珠规则下白棋还能等黑棋被逼进禁手，而且破坏方是黑棋时有些点不能下，都不算
+    bool bMeDone = !(TRule::HAS_FORBIDDEN && toMove == WHITE) && CannotWin(toMove, true);
+    bool bOpDone = !(TRule::HAS_FORBIDDEN && opColor == WHITE) && CannotWin(opColor, false);
+    if (bMeDone && bOpDone) return 0;
+    int lower = -1, upper = 1;
+    if (bMeDone) upper = 0;
+    if (bOpDone) lower = 0;
+
+    int iSym;
+    uint64_t ullKey = CanonicalKey(&iSym);
+    int iTTMove = -1;
+    STTEntry tt;
+    if (m_pTT->Probe(ullKey, &tt)) {
+        if (tt.iBound == TT_EXACT) {
+            lower = max(lower, tt.iValue);
+            upper = min(upper, tt.iValue);
+        } else if (tt.iBound == TT_LOWER) {
+            lower = max(lower, tt.iValue);
+        } else if (tt.iBound == TT_UPPER) {
+            upper = min(upper, tt.iValue);
+        }
+        if (tt.iMove >= 0 && tt.iMove < CELLS) iTTMove = m_arrInverse[iSym][tt.iMove];
+    }
+    int iOpening;
+    if (LookupOpening(ullKey, &iOpening)) lower = upper = iOpening;
+    if (lower >= beta || lower == upper) {
+        *pBest = iTTMove;
+        return lower;
+    }
+    if (upper <= alpha) return upper;
+    alpha = max(alpha, lower);
+    beta = min(beta, upper);
+
+    // 自己的成五点；同时收集对方的成五点
+    int arrThreats[2];
+    int iThreats = 0;
+    for (int w = 0; w < m_iWindows; w++) {
+        bool bMine = m_arrCount[me][w] == WIN_LEN - 1 && m_arrCount[op][w] == 0;
+        bool bTheirs = m_arrCount[op][w] == WIN_LEN - 1 && m_arrCount[me][w] == 0;
+        if (!bMine && !bTheirs) continue;
+        int iEmpty = -1;
+        for (int k = 0; k < WIN_LEN; k++) {
+            int iCell = m_arrWindowCells[w][k];
+            if (m_board.GetPiece(iCell % N, iCell / N) == EMPTY) iEmpty = iCell;
+        }
+        if (bMine) {
+            if (IsWinningMove(iEmpty, toMove)) {
+                *pBest = iEmpty;
+                return 1;
+            }
+        } else if (iThreats < 2 && (iThreats == 0 || arrThreats[0] != iEmpty) && IsWinningMove(iEmpty, opColor)) {
+            arrThreats[iThreats++] = iEmpty;
+        }
+    }
+
+    // 候选点：对方有成五点只能挡 (两个挡不住)，否则所有空位；黑棋的禁手点去掉
+    int arrMoves[CELLS];
+    int arrScores[CELLS];
+    int iMoves = 0;
+    if (iThreats >= 2) return -1;
+    if (iThreats == 1) {
+        if (toMove == BLACK && IsForbidden(arrThreats[0])) return -1;
+        arrMoves[iMoves] = arrThreats[0];
+        arrScores[iMoves++] = 0;
+    } else {
+        // 走法排序：经过这一格、还能成五的窗口里子越多越先走，进攻和防守一起算
+        // 死格 (经过它的窗口都已有两色棋子) 上的子永远不会成为五连、长连、三四的一部分，也不是谁的端点，
+        // 下在那里等于停一手；死格之间完全等价，只试第一个
+        static const int arrWeight[WIN_LEN] = { 1, 4, 16, 64, 256 };
+        bool bDeadTried = false;
+        for (int iCell = 0; iCell < CELLS; iCell++) {
+            if (m_board.GetPiece(iCell % N, iCell / N) != EMPTY) continue;
+            int iScore = 0;
+            bool bDead = true;
+            for (int i = 0; i < m_arrCellWindowCount[iCell]; i++) {
+                int w = m_arrCellWindows[iCell][i];
+                if (m_arrCount[op][w] == 0) iScore += arrWeight[m_arrCount[me][w]];
+                if (m_arrCount[me][w] == 0) iScore += arrWeight[m_arrCount[op][w]];
+                if (m_arrCount[op][w] == 0 || m_arrCount[me][w] == 0) bDead = false;
+            }
+            if (bDead) {
+                if (bDeadTried) continue;
+                bDeadTried = true;
+            } else if (toMove == BLACK && IsForbidden(iCell)) {
+                continue;
+            }
+            if (iCell == iTTMove) iScore = 1 << 30;
+            // 插入排序，分高的在前
+            int j = iMoves++;
+            while (j > 0 && arrScores[j - 1] < iScore) {
+                arrMoves[j] = arrMoves[j - 1];
+                arrScores[j] = arrScores[j - 1];
+                j--;
+            }
+            arrMoves[j] = iCell;
+            arrScores[j] = iScore;
+        }
+        // 黑棋只剩禁手点可下，判负
+        if (iMoves == 0) return -1;
+    }
+
+    int iAlphaOrig = alpha;
+    int iBestValue = -2;
+    int iBestMove = -1;
+    for (int i = 0; i < iMoves; i++) {
+        int iChildBest;
+        Place(arrMoves[i], toMove);
+        int v = -Search(opColor, -beta, -alpha, &iChildBest);
+        Undo(arrMoves[i], toMove);
+        if (m_bAbort) return 0;
+        if (v > iBestValue) {
+            iBestValue = v;
+            iBestMove = arrMoves[i];
+        }
+        if (v > alpha) alpha = v;
+        if (alpha >= beta) break;
+    }
+
+    int iBound = (iBestValue <= iAlphaOrig) ? TT_UPPER : (iBestValue >= beta ? TT_LOWER : TT_EXACT);
+    m_pTT->Store(ullKey, iBestValue, 0, iBound, m_arrSym[iSym][iBestMove]);
+    *pBest = iBestMove;
+    return iBestValue;
+}
+
+template <int N, class TRule>
+void CSmallSolverT<N, TRule>::SetPosition(const Board& board) {
+    // 先撤掉现有的子，再照 board 摆一遍，顺带建好窗口计数和 8 个键
+    for (int iCell = 0; iCell < CELLS; iCell++) {
+        int iPiece = m_board.GetPiece(iCell % N, iCell / N);
+        if (iPiece != EMPTY) Undo(iCell, iPiece);
+    }
+    for (int iCell = 0; iCell < CELLS; iCell++) {
+        int iPiece = board.GetPiece(iCell % N, iCell / N);
+        if (iPiece != EMPTY) Place(iCell, iPiece);
+    }
+}
+
+template <int N, class TRule>
+int CSmallSolverT<N, TRule>::Solve(const Board& board, int toMove, CSearchControl& ctl, Point* pBest) {
+    SetPosition(board);
+    m_pCtl = &ctl;
+    m_bAbort = false;
+    int iBest = -1;
+    int v = Search(toMove, -1, 1, &iBest);
+    m_pCtl = NULL;
+    if (pBest) {
+        pBest->iX = iBest < 0 ? -1 : iBest % N;
+        pBest->iY = iBest < 0 ? -1 : iBest / N;
+    }
+    return m_bAbort ? SOLVE_UNKNOWN : ValueToSolve(v);
+}
+
+template <int N, class TRule>
+void CSmallSolverT<N, TRule>::EnumerateOpenings(const vector<uint8_t>& vecRoot, int iMaxPly, vector<SSolveRecord>& vecRecords,
+                                                vector<vector<uint8_t> >& vecLines) {
+    vecRecords.clear();
+    vecLines.clear();
+    SetPosition(Board());
+    for (size_t i = 0; i < vecRoot.size(); i++) Place(vecRoot[i], (i % 2 == 0) ? BLACK : WHITE);
+    int iSym;
+    SSolveRecord root = { CanonicalKey(&iSym), (uint8_t)vecRoot.size(), SOLVE_UNKNOWN, 255 };
+    for (int i = (int)vecRoot.size() - 1; i >= 0; i--) Undo(vecRoot[i], (i % 2 == 0) ? BLACK : WHITE);
+    vecRecords.push_back(root);
+    vecLines.push_back(vecRoot);
+
+    unordered_set<uint64_t> setSeen;
+    setSeen.insert(root.ullKey);
+    size_t iLevelBegin = 0;
+    for (int iPly = 0; iPly < iMaxPly; iPly++) {
+        size_t iLevelEnd = vecRecords.size();
+        for (size_t p = iLevelBegin; p < iLevelEnd; p++) {
+            vector<uint8_t> vecLine = vecLines[p];
+            int toMove = (vecLine.size() % 2 == 0) ? BLACK : WHITE;
+            for (size_t i = 0; i < vecLine.size(); i++) Place(vecLine[i], (i % 2 == 0) ? BLACK : WHITE);
+
+            for (int iCell = 0; iCell < CELLS; iCell++) {
+                if (m_board.GetPiece(iCell % N, iCell / N) != EMPTY) continue;
+                if (IsWinningMove(iCell, toMove)) continue; // 棋局到此结束，不进表
+                if (toMove == BLACK && IsForbidden(iCell)) continue;
+                Place(iCell, toMove);
+                uint64_t ullKey = CanonicalKey(&iSym);
+                if (setSeen.insert(ullKey).second) {
+                    SSolveRecord rec = { ullKey, (uint8_t)(vecLine.size() + 1), SOLVE_UNKNOWN, 255 };
+                    vecRecords.push_back(rec);
+                    vecLines.push_back(vecLine);
+                    vecLines.back().push_back((uint8_t)iCell);
+                }
+                Undo(iCell, toMove);
+            }
+
+            for (int i = (int)vecLine.size() - 1; i >= 0; i--) Undo(vecLine[i], (i % 2 == 0) ? BLACK : WHITE);
+        }
+        iLevelBegin = iLevelEnd;
+    }
+}
+
+#define INSTANTIATE_SMALLSOLVER(N, TRule) template class CSmallSolverT<N, TRule>;
+WZQ_FOR_EACH_SMALL_GAME(INSTANTIATE_SMALLSOLVER)
+
+// ---- 结果表文件 ----
+
+static const size_t SOLVE_HEADER_BYTES = 36;
+static const size_t SOLVE_RECORD_BYTES = 11;
+
+bool SaveSolveTable(const string& strFile, int iSize, const char* szRule, int iMaxStones,
+                    const vector<SSolveRecord>& vecRecords) {
+    vector<uint8_t> v;
+    v.reserve(SOLVE_HEADER_BYTES + vecRecords.size() * SOLVE_RECORD_BYTES + 4);
+    v.push_back('W'); v.push_back('Z'); v.push_back('Q'); v.push_back('S');
+    PutU32(v, SOLVE_TABLE_VERSION);
+    PutU32(v, (uint32_t)iSize);
+    char szName[16] = {};
+    strncpy(szName, szRule, sizeof(szName) - 1);
+    v.insert(v.end(), szName, szName + sizeof(szName));
+    PutU32(v, (uint32_t)iMaxStones);
+    PutU32(v, (uint32_t)vecRecords.size());
+    for (size_t i = 0; i < vecRecords.size(); i++) {
+        PutU64(v, vecRecords[i].ullKey);
+        v.push_back(vecRecords[i].uPly);
+        v.push_back(vecRecords[i].uValue);
+        v.push_back(vecRecords[i].uBest);
+    }
+    PutU32(v, Fnv1a(v.data(), v.size()));
+    return WriteFileAtomic(strFile, v, nullptr);
+}
+
+bool LoadSolveTable(const string& strFile, int iSize, const char* szRule,
+                    vector<SSolveRecord>& vecRecords, string* pError) {
+    vecRecords.clear();
+    ifstream file(strFile, ios::binary);
+    if (!file.is_open()) {
+        if (pError) *pError = "无法打开文件";
+        return false;
+    }
+    vector<uint8_t> v((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    if (v.size() < SOLVE_HEADER_BYTES + 4 || memcmp(v.data(), "WZQS", 4) != 0) {
+        if (pError) *pError = "不是求解结果文件";
+        return false;
+    }
+    char szName[16] = {};
+    strncpy(szName, szRule, sizeof(szName) - 1);
+    if (GetU32(&v[4]) != SOLVE_TABLE_VERSION || GetU32(&v[8]) != (uint32_t)iSize || memcmp(&v[12], szName, 16) != 0) {
+        if (pError) *pError = "版本、棋盘大小或规则不匹配";
+        return false;
+    }
+    uint32_t uCount = GetU32(&v[32]);
+    if (v.size() != SOLVE_HEADER_BYTES + (size_t)uCount * SOLVE_RECORD_BYTES + 4) {
+        if (pError) *pError = "文件长度不对";
+        return false;
+    }
+    if (Fnv1a(v.data(), v.size() - 4) != GetU32(&v[v.size() - 4])) {
+        if (pError) *pError = "校验和不对，文件已损坏";
+        return false;
+    }
+
+    vecRecords.resize(uCount);
+    const uint8_t* p = &v[SOLVE_HEADER_BYTES];
+    for (uint32_t i = 0; i < uCount; i++, p += SOLVE_RECORD_BYTES) {
+        vecRecords[i].ullKey = GetU64(p);
+        vecRecords[i].uPly = p[8];
+        vecRecords[i].uValue = p[9] <= SOLVE_LOSS ? p[9] : (uint8_t)SOLVE_UNKNOWN;
+        vecRecords[i].uBest = p[10];
+    }
+    return true;
+}
+
+// ---- 开局表求解 ----
+
+template <int N, class TRule>
+static SSmallSolveSummary RunSmallSolve(const SSmallSolveOptions& opt, ostream& out) {
+    typedef chrono::steady_clock Clock;
+    Clock::time_point tpStart = Clock::now();
+
+    SSmallSolveSummary sum;
+    sum.bOk = false;
+    sum.iPositions = 0;
+    sum.iResumed = 0;
+    memset(sum.arrValues, 0, sizeof(sum.arrValues));
+    sum.iRootValue = SOLVE_UNKNOWN;
+    sum.stRootBest = { -1, -1 };
+    sum.llNodes = 0;
+    sum.dSeconds = 0;
+
+    CTransTable tt(max<size_t>(opt.iTTBytes / 16, 1024));
+
+    // 起始着法：不能越界、重叠，也不能已经分出胜负
+    CBoardT<N> rootBoard;
+    vector<uint8_t> vecRoot;
+    for (size_t i = 0; i < opt.vecRootMoves.size(); i++) {
+        Point p = opt.vecRootMoves[i];
+        int color = (i % 2 == 0) ? BLACK : WHITE;
+        if (!rootBoard.IsValid(p.iX, p.iY) || !rootBoard.IsEmpty(p.iX, p.iY)) {
+            sum.strError = "起始着法第 " + to_string(i + 1) + " 手落点无效";
+            return sum;
+        }
+        rootBoard.PlacePiece(p.iX, p.iY, color);
+        if (CRefereeT<N, TRule>::CheckWin(rootBoard, p.iX, p.iY) ||
+            (color == BLACK && CRefereeT<N, TRule>::CheckForbidden(rootBoard, p.iX, p.iY))) {
+            sum.strError = "起始着法第 " + to_string(i + 1) + " 手已经分出胜负";
+            return sum;
+        }
+        vecRoot.push_back((uint8_t)(p.iY * N + p.iX));
+    }
+    int iMaxStones = (int)vecRoot.size() + opt.iPlies;
+
+    // 枚举开局局面
+    vector<SSolveRecord> vecRecords;
+    vector<vector<uint8_t> > vecLines;
+    unique_ptr<CSmallSolverT<N, TRule> > pEnum(new CSmallSolverT<N, TRule>(&tt));
+    pEnum->EnumerateOpenings(vecRoot, opt.iPlies, vecRecords, vecLines);
+    sum.iPositions = (int)vecRecords.size();
+
+    // 已有结果文件就接着算：解出的局面不再重算，这次没枚举到的 (上次算得更深) 原样保留
+    vector<SSolveRecord> vecExtra;
+    {
+        ifstream probe(opt.strTableFile, ios::binary);
+        if (probe.is_open()) {
+            probe.close();
+            vector<SSolveRecord> vecOld;
+            string strError;
+            if (!LoadSolveTable(opt.strTableFile, N, TRule::Name(), vecOld, &strError)) {
+                sum.strError = opt.strTableFile + ": " + strError;
+                return sum;
+            }
+            unordered_map<uint64_t, size_t> mapIndex;
+            for (size_t i = 0; i < vecRecords.size(); i++) mapIndex[vecRecords[i].ullKey] = i;
+            for (size_t i = 0; i < vecOld.size(); i++) {
+                unordered_map<uint64_t, size_t>::iterator it = mapIndex.find(vecOld[i].ullKey);
+                if (it == mapIndex.end()) {
+                    vecExtra.push_back(vecOld[i]);
+                } else if (vecOld[i].uValue != SOLVE_UNKNOWN) {
+                    vecRecords[it->second].uValue = vecOld[i].uValue;
+                    vecRecords[it->second].uBest = vecOld[i].uBest;
+                    sum.iResumed++;
+                }
+            }
+        }
+    }
+
+    // 开局表：按键排序的下标，值用原子量，求解线程边写边读
+    size_t iCount = vecRecords.size();
+    vector<size_t> vecOrder(iCount);
+    for (size_t i = 0; i < iCount; i++) vecOrder[i] = i;
+    sort(vecOrder.begin(), vecOrder.end(), [&vecRecords](size_t a, size_t b) {
+        return vecRecords[a].ullKey < vecRecords[b].ullKey;
+    });
+    vector<uint64_t> vecKeys(iCount);
+    vector<size_t> vecSlot(iCount); // 记录下标 -> 开局表里的位置
+    unique_ptr<atomic<uint8_t>[]> pValues(new atomic<uint8_t>[iCount]);
+    for (size_t i = 0; i < iCount; i++) {
+        vecKeys[i] = vecRecords[vecOrder[i]].ullKey;
+        vecSlot[vecOrder[i]] = i;
+        pValues[i].store(vecRecords[vecOrder[i]].uValue, memory_order_relaxed);
+    }
+
+    // 待解的局面，深的先解
+    vector<size_t> vecWork;
+    for (size_t i = 0; i < iCount; i++) {
+        if (vecRecords[i].uValue == SOLVE_UNKNOWN) vecWork.push_back(i);
+    }
+    stable_sort(vecWork.begin(), vecWork.end(), [&vecRecords](size_t a, size_t b) {
+        return vecRecords[a].uPly > vecRecords[b].uPly;
+    });
+
+    out << N << "x" << N << " " << TRule::Name() << "：起始 " << vecRoot.size() << " 手之后 " << opt.iPlies << " 手以内 " << iCount << " 个局面 (对称已合并)，"
+        << sum.iResumed << " 个沿用已有结果，待解 " << vecWork.size() << endl;
+
+    Clock::time_point tpDeadline = opt.iSeconds > 0 ? tpStart + chrono::seconds(opt.iSeconds) : Clock::time_point::max();
+    mutex mtx; // 保护 vecRecords 的最佳落点和值 (写检查点时读)
+    atomic<size_t> atNext(0);
+    atomic<size_t> atDone(0);
+    atomic<long long> atNodes(0);
+    atomic<int> atExited(0);
+    int iThreads = max(1, opt.iThreads);
+
+    auto fnSnapshot = [&]() {
+        vector<SSolveRecord> vecAll;
+        {
+            lock_guard<mutex> lock(mtx);
+            vecAll = vecRecords;
+        }
+        vecAll.insert(vecAll.end(), vecExtra.begin(), vecExtra.end());
+        sort(vecAll.begin(), vecAll.end(), [](const SSolveRecord& a, const SSolveRecord& b) {
+            return a.uPly != b.uPly ? a.uPly < b.uPly : a.ullKey < b.ullKey;
+        });
+        return vecAll;
+    };
+
+    CThreadPool pool(iThreads);
+    for (int t = 0; t < iThreads; t++) {
+        pool.Submit([&]() {
+            unique_ptr<CSmallSolverT<N, TRule> > pSolver(new CSmallSolverT<N, TRule>(&tt));
+            pSolver->SetOpeningTable(&vecKeys, pValues.get(), iMaxStones);
+            CBoardT<N> board;
+            for (;;) {
+                if (Clock::now() >= tpDeadline) break;
+                size_t iWork = atNext.fetch_add(1);
+                if (iWork >= vecWork.size()) break;
+                size_t iRec = vecWork[iWork];
+                const vector<uint8_t>& vecLine = vecLines[iRec];
+
+                board.Reset();
+                for (size_t i = 0; i < vecLine.size(); i++) {
+                    board.PlacePiece(vecLine[i] % N, vecLine[i] / N, (i % 2 == 0) ? BLACK : WHITE);
+                }
+                int toMove = (vecLine.size() % 2 == 0) ? BLACK : WHITE;
+                CSearchControl ctl(tpDeadline, opt.llNodesPerPosition, 1);
+                Point stBest;
+                long long llBefore = pSolver->GetNodes();
+                int iValue = pSolver->Solve(board, toMove, ctl, &stBest);
+                atNodes += pSolver->GetNodes() - llBefore;
+
+                if (iValue != SOLVE_UNKNOWN) {
+                    lock_guard<mutex> lock(mtx);
+                    vecRecords[iRec].uValue = (uint8_t)iValue;
+                    vecRecords[iRec].uBest = stBest.iX < 0 ? (uint8_t)255
+                                                           : (uint8_t)pSolver->CanonicalCell(stBest.iY * N + stBest.iX);
+                    pValues[vecSlot[iRec]].store((uint8_t)iValue, memory_order_release);
+                }
+                atDone++;
+            }
+            atExited++;
+        });
+    }
+
+    // 主线程：定期写检查点，等所有线程领完活
+    Clock::time_point tpCheckpoint = Clock::now();
+    bool bSaveOk = true;
+    for (;;) {
+        if (atExited.load() >= iThreads) break;
+        this_thread::sleep_for(chrono::milliseconds(50));
+        if (opt.iCheckpointSeconds > 0 && Clock::now() - tpCheckpoint >= chrono::seconds(opt.iCheckpointSeconds)) {
+            tpCheckpoint = Clock::now();
+            bSaveOk = SaveSolveTable(opt.strTableFile, N, TRule::Name(), iMaxStones, fnSnapshot()) && bSaveOk;
+            double dElapsed = chrono::duration<double>(Clock::now() - tpStart).count();
+            out << "  检查点：已处理 " << atDone.load() << "/" << vecWork.size() << "，用时 " << dElapsed << "s" << endl;
+        }
+    }
+    pool.Shutdown();
+
+    vector<SSolveRecord> vecAll = fnSnapshot();
+    bSaveOk = SaveSolveTable(opt.strTableFile, N, TRule::Name(), iMaxStones, vecAll) && bSaveOk;
+    if (!bSaveOk) {
+        sum.strError = opt.strTableFile + ": 写入失败";
+        return sum;
+    }
+
+    for (size_t i = 0; i < iCount; i++) sum.arrValues[vecRecords[i].uValue]++;
+    sum.iRootValue = vecRecords[0].uValue;
+    if (vecRecords[0].uBest != 255) {
+        // 结果表里存的是规范朝向，换回起始局面的朝向
+        pEnum->SetPosition(rootBoard);
+        int iBest = pEnum->FromCanonicalCell(vecRecords[0].uBest);
+        sum.stRootBest = { iBest % N, iBest / N };
+    }
+    sum.llNodes = atNodes.load();
+    sum.dSeconds = chrono::duration<double>(Clock::now() - tpStart).count();
+    sum.bOk = true;
+    return sum;
+}
+
+struct SSmallSolveRunner {
+    typedef SSmallSolveSummary ResultType;
+    const SSmallSolveOptions* pOpt;
+    ostream* pOut;
+    template <int N, class TRule>
+    ResultType Run() { return RunSmallSolve<N, TRule>(*pOpt, *pOut); }
+};
+
+SSmallSolveSummary SolveSmallBoard(const SSmallSolveOptions& opt, ostream& out) {
+    SSmallSolveRunner visitor = { &opt, &out };
+    return DispatchSmallGame(opt.iSize, opt.iRule, visitor);
+}
@@ -0,0 +1,153 @@
+#ifndef _SMALLSOLVER_H_
+#define _SMALLSOLVER_H_
+
+#include "Board.h"
+#include "Rules.h"
+#include "SearchControl.h"
+#include "TransTable.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 结果表文件格式版本
+const uint32_t SOLVE_TABLE_VERSION = 1;
+
+// 博弈值，一律是轮到走棋一方的视角
+enum ESolveValue {
+    SOLVE_UNKNOWN = 0, // 节点数或时间用完
+    SOLVE_WIN,
+    SOLVE_DRAW,
+    SOLVE_LOSS
+};
+
+const char* GetSolveValueName(int iValue);
+
+// 结果表的一条：开局阶段的一个局面 (已按 8 种对称取最小键)
+struct SSolveRecord {
+    uint64_t ullKey;
+    uint8_t uPly;    // 棋子数
+    uint8_t uValue;  // ESolveValue
+    uint8_t uBest;   // 最佳落点在规范朝向下的格子编号 (y * N + x)，255 表示没有
+};
+
+// 小棋盘 (7~11 路) 的完全求解：双方所有空位都考虑，求出胜 / 和 / 负
+//
+// 负极大 + alpha-beta，值只有 -1 / 0 / 1，窗口很快就收窄
+// 置换表 (CTransTable，多线程共享) 的键取棋盘 8 种对称里最小的 Zobrist 键，对称的局面只算一次；
+// 8 个键随落子增量维护，最佳落点按规范朝向存，取出时再变换回来
+// 剪枝都是精确的：
+//  · 自己能成五直接赢；对方有成五点只能去挡，两个以上挡不住直接输
+//  · 每个 5 格窗口记着两色的子数；按 Erdős–Selfridge 的势或配对策略判断一方是否已经不可能占满任何窗口，
+//    这样的一方最多和棋，双方都是就直接和棋 (连珠规则下白棋例外：黑棋可能被逼进禁手)
+//  · 死格 (经过的窗口都已有两色棋子) 下子等于停一手，彼此等价，每层只试一个
+//  · 开局表 (SetOpeningTable) 里已经解出的局面直接取值
+// 胜负和禁手一律用 CReferee 判断；黑棋的禁手点不能下，无处可下判负
+template <int N, class TRule>
+class CSmallSolverT {
+public:
+    typedef CBoardT<N> Board;
+
+    static const int CELLS = N * N;
+
+    explicit CSmallSolverT(CTransTable* pTT);
+
+    // 开局表：排好序的键和对应的值 (ESolveValue，别的线程随时可能填进新解出的值)
+    // 搜索中遇到棋子数不超过 iMaxPly 的局面先查它
+    void SetOpeningTable(const std::vector<uint64_t>* pKeys, const std::atomic<uint8_t>* pValues, int iMaxPly);
+
+    // 摆好局面 (Solve 会自己调用)
+    void SetPosition(const Board& board);
+
+    // 求 toMove 先走时的博弈值 (局面不能已经分出胜负)；预算用完返回 SOLVE_UNKNOWN
+    // pBest 返回最佳落点 (局面已分出胜负或没有可走的点时为 -1, -1)
+    int Solve(const Board& board, int toMove, CSearchControl& ctl, Point* pBest);
+
+    // 列出从 vecRoot (格子编号，黑先交替，空表示空棋盘) 起 iMaxPly 手以内的所有局面
+    // 对称的只留一个，已成五的不再展开；每个局面给出一条到达它的着法，按棋子数从少到多排列
+    void EnumerateOpenings(const std::vector<uint8_t>& vecRoot, int iMaxPly, std::vector<SSolveRecord>& vecRecords,
+                           std::vector<std::vector<uint8_t> >& vecLines);
+
+    // 格子在当前局面 (SetPosition / 最近一次 Solve 的根局面) 的规范朝向下的编号，和反过来的变换
+    int CanonicalCell(int iCell) const;
+    int FromCanonicalCell(int iCell) const;
+
+    long long GetNodes() const { return m_llNodes; }
+
+private:
+    enum { WIN_LEN = 5, MAX_WINDOWS = 4 * N * N, MAX_CELL_WINDOWS = 4 * WIN_LEN, PAIR_STEP_LIMIT = 64 };
+
+    Board m_board;
+    CTransTable* m_pTT;
+    const std::vector<uint64_t>* m_pOpeningKeys;
+    const std::atomic<uint8_t>* m_pOpeningValues;
+    int m_iOpeningPly;
+    CSearchControl* m_pCtl;
+    bool m_bAbort;
+    long long m_llNodes;
+    int m_iStones;
+
+    // 5 格窗口：格子、每个格子所在的窗口、每个窗口里两色的子数、不含对方棋子的窗口数
+    int m_iWindows;
+    uint8_t m_arrWindowCells[MAX_WINDOWS][WIN_LEN];
+    uint16_t m_arrCellWindows[CELLS][MAX_CELL_WINDOWS];
+    uint8_t m_arrCellWindowCount[CELLS];
+    uint8_t m_arrCount[2][MAX_WINDOWS];
+    int m_arrOpen[2];
+
+    // 8 种对称：格子映射、逆映射、各自的 Zobrist 键
+    uint8_t m_arrSym[8][CELLS];
+    uint8_t m_arrInverse[8][CELLS];
+    uint64_t m_arrHash[8];
+
+    void Place(int iCell, int color);
+    void Undo(int iCell, int color);
+    uint64_t CanonicalKey(int* pSym) const;
+    bool IsWinningMove(int iCell, int color);
+    bool IsForbidden(int iCell);
+    bool CannotWin(int color, bool bToMove) const;
+    bool HasBlockingPairs(int color) const;
+    bool AssignPairs(const int* pWindows, int iWindows, int iAt, int* pPartner, int* pSteps) const;
+    bool LookupOpening(uint64_t ullKey, int* pValue) const;
+    int Search(int toMove, int alpha, int beta, int* pBest);
+};
+
+// 求解开局表：枚举起始着法之后 iPlies 手以内的局面，按棋子数从多到少分给各线程求解
+// 先解出的深层局面进开局表，浅层局面搜到它们就直接取值
+// 每隔 iCheckpointSeconds 秒把结果表整个写一次 (先写临时文件再改名)；文件已存在就接着算，
+// 只重算还没解出的局面
+struct SSmallSolveOptions {
+    int iSize;
+    int iRule;
+    std::vector<Point> vecRootMoves; // 起始着法，空表示从空棋盘开始
+    int iPlies;
+    int iThreads;
+    long long llNodesPerPosition; // 每个局面的节点上限，<0 不限
+    int iSeconds;                 // 总时间上限，<=0 不限；到时写一次检查点后退出
+    int iCheckpointSeconds;
+    size_t iTTBytes;
+    std::string strTableFile;
+};
+
+struct SSmallSolveSummary {
+    bool bOk;
+    std::string strError;
+    int iPositions;
+    int iResumed;                 // 从已有文件里读到、不用重算的局面数
+    int arrValues[4];             // 按 ESolveValue 计数
+    int iRootValue;               // 起始局面的值
+    Point stRootBest;
+    long long llNodes;
+    double dSeconds;
+};
+
+SSmallSolveSummary SolveSmallBoard(const SSmallSolveOptions& opt, std::ostream& out);
+
+// 结果表文件："WZQS" 版本 棋盘大小 规则名(16 字节) 最大棋子数 条数，每条 8 字节键 + 手数 + 值 + 最佳落点，最后是校验和
+bool SaveSolveTable(const std::string& strFile, int iSize, const char* szRule, int iMaxStones,
+                    const std::vector<SSolveRecord>& vecRecords);
+bool LoadSolveTable(const std::string& strFile, int iSize, const char* szRule,
+                    std::vector<SSolveRecord>& vecRecords, std::string* pError);
+
+#endif
@@ -0,0 +1,228 @@
+#include "SmallSolver.h"
+#include "Checks.h"
+#include "Board.h"
+#include "GameSession.h"
+#include "Referee.h"
+#include "Rules.h"
+#include "SearchControl.h"
+#include "TransTable.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// 小棋盘求解器校验：WuZiQiDemo --check-small [局面数] [空格数]
+// 7 路棋盘上随机下到只剩若干空格 (没人成五)，分别用 CSmallSolverT 和不带任何剪枝的负极大 (所有空格、
+// 禁手点当作下了就输) 求博弈值，三种规则逐个比对；同时给出求解器在更多空格时的耗时
+template <int N, class TRule>
+static int BruteForceValue(CBoardT<N>& board, int toMove, int iEmpty, int alpha, int beta) {
+    if (iEmpty == 0) return 0;
+    int iBest = -2;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            if (!board.IsEmpty(x, y)) continue;
+            board.PlacePiece(x, y, toMove);
+            int v;
+            if (CRefereeT<N, TRule>::CheckWin(board, x, y)) v = 1;
+            else if (toMove == BLACK && CRefereeT<N, TRule>::CheckForbidden(board, x, y)) v = -1;
+            else v = -BruteForceValue<N, TRule>(board, 3 - toMove, iEmpty - 1, -beta, -alpha);
+            board.UndoPiece(x, y);
+            if (v > iBest) iBest = v;
+            if (v > alpha) alpha = v;
+            if (alpha >= beta) return iBest;
+        }
+    }
+    return iBest;
+}
+
+struct SSmallSolveChecker {
+    typedef int ResultType;
+    int iPositions;
+    int iEmpty;
+    minstd_rand* pRng;
+
+    template <int N, class TRule>
+    int Run() {
+        minstd_rand& rng = *pRng;
+        CTransTable tt(1 << 20);
+        CSmallSolverT<N, TRule> solver(&tt);
+        int iMismatches = 0;
+        int arrValues[4] = {};
+        for (int p = 0; p < iPositions; p++) {
+            // 随机对局，成五或禁手就重来
+            CBoardT<N> board;
+            int toMove = BLACK;
+            int iStones = 0;
+            while (iStones < N * N - iEmpty) {
+                int x = (int)(rng() % N), y = (int)(rng() % N);
+                if (!board.IsEmpty(x, y)) continue;
+                board.PlacePiece(x, y, toMove);
+                if (CRefereeT<N, TRule>::CheckWin(board, x, y) ||
+                    (toMove == BLACK && CRefereeT<N, TRule>::CheckForbidden(board, x, y))) {
+                    board.Reset();
+                    toMove = BLACK;
+                    iStones = 0;
+                    continue;
+                }
+                toMove = 3 - toMove;
+                iStones++;
+            }
+            int iExpect = BruteForceValue<N, TRule>(board, toMove, iEmpty, -1, 1);
+            int iExpectSolve = iExpect > 0 ? SOLVE_WIN : (iExpect < 0 ? SOLVE_LOSS : SOLVE_DRAW);
+            tt.Clear();
+            CSearchControl ctl = CSearchControl::Unlimited();
+            Point stBest;
+            int iValue = solver.Solve(board, toMove, ctl, &stBest);
+            arrValues[iExpectSolve]++;
+            if (iValue != iExpectSolve) {
+                if (iMismatches < 5) {
+                    cout << " [不一致] " << TRule::Name() << " 局面 " << p << ": 求解器 " << GetSolveValueName(iValue)
+                         << ", 穷举 " << GetSolveValueName(iExpectSolve) << endl;
+                }
+                iMismatches++;
+            }
+        }
+        cout << " " << TRule::Name() << ": 胜 " << arrValues[SOLVE_WIN] << ", 和 " << arrValues[SOLVE_DRAW] << ", 负 "
+             << arrValues[SOLVE_LOSS] << endl;
+        return iMismatches;
+    }
+};
+
+// 求解器在空格更多的随机局面上的平均节点数和耗时
+struct SSmallSolveTimer {
+    typedef int ResultType;
+    int iPositions;
+    int iEmpty;
+    minstd_rand* pRng;
+
+    template <int N, class TRule>
+    int Run() {
+        minstd_rand& rng = *pRng;
+        CTransTable tt(1 << 22);
+        CSmallSolverT<N, TRule> solver(&tt);
+        long long llNodes = 0;
+        int iSolved = 0;
+        double dSeconds = 0; // 只算 Solve 本身，摆局面和清空 4M 条的置换表不算
+        for (int p = 0; p < iPositions; p++) {
+            CBoardT<N> board;
+            int toMove = BLACK;
+            int iStones = 0;
+            while (iStones < N * N - iEmpty) {
+                int x = (int)(rng() % N), y = (int)(rng() % N);
+                if (!board.IsEmpty(x, y)) continue;
+                board.PlacePiece(x, y, toMove);
+                if (CRefereeT<N, TRule>::CheckWin(board, x, y) ||
+                    (toMove == BLACK && CRefereeT<N, TRule>::CheckForbidden(board, x, y))) {
+                    board.Reset();
+                    toMove = BLACK;
+                    iStones = 0;
+                    continue;
+                }
+                toMove = 3 - toMove;
+                iStones++;
+            }
+            tt.Clear();
+            CSearchControl ctl(CSearchControl::Clock::time_point::max(), 2000000, 1);
+            long long llBefore = solver.GetNodes();
+            Point stBest;
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            if (solver.Solve(board, toMove, ctl, &stBest) != SOLVE_UNKNOWN) iSolved++;
+            dSeconds += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            llNodes += solver.GetNodes() - llBefore;
+        }
+        cout << "  " << TRule::Name() << " 空格 " << iEmpty << ": 解出 " << iSolved << "/" << iPositions << ", 平均 "
+             << llNodes / iPositions << " 节点, " << dSeconds * 1000 / iPositions << " ms, 每秒 "
+             << (dSeconds > 0 ? (long long)(llNodes / dSeconds) : 0) << " 节点" << endl;
+        return 0;
+    }
+};
+
+int RunSmallSolveCheck(int argc, char* argv[]) {
+    int iPositions = (argc > 2) ? atoi(argv[2]) : 200;
+    int iEmpty = (argc > 3) ? atoi(argv[3]) : 9;
+    minstd_rand rng(45);
+    const int arrRules[3] = { RULE_RENJU, RULE_STANDARD, RULE_FREESTYLE };
+
+    int iMismatches = 0;
+    for (int j = 0; j < 3; j++) {
+        SSmallSolveChecker checker = { iPositions, iEmpty, &rng };
+        iMismatches += DispatchSmallGame(7, arrRules[j], checker);
+    }
+    cout << (iMismatches == 0 ? "[通过]" : "[失败]") << " 3 种规则 x " << iPositions << " 个局面 (空格 " << iEmpty
+         << "), 不一致数: " << iMismatches << endl;
+
+    cout << "求解耗时 (7 路，每局面最多 200 万节点):" << endl;
+    for (int iMore = 15; iMore <= 35; iMore += 5) {
+        for (int j = 0; j < 3; j++) {
+            SSmallSolveTimer timer = { 20, iMore, &rng };
+            DispatchSmallGame(7, arrRules[j], timer);
+        }
+    }
+    return iMismatches == 0 ? 0 : 1;
+}
+
+// 小棋盘完全求解：WuZiQiDemo --solve-small <棋盘大小 7~11> <规则> <起始着法|-> <手数> <结果文件> [线程数] [每局面节点上限] [总秒数] [置换表MB]
+// 求出起始局面 (着法逗号分隔，"-" 为空棋盘) 之后若干手以内每个局面 (对称合并) 的胜 / 和 / 负，写成结果表
+// 每 10 秒写一次检查点；结果文件已存在就接着算，中途被杀掉或到了总秒数，下次用同样的参数再跑就从检查点继续
+int RunSmallSolve(int argc, char* argv[]) {
+    if (argc < 7) {
+        cout << "用法: --solve-small <棋盘大小 7~11> <renju|standard|freestyle> <起始着法|-> <手数> <结果文件> "
+             << "[线程数] [每局面节点上限] [总秒数] [置换表MB]" << endl;
+        return 1;
+    }
+    SSmallSolveOptions opt;
+    opt.iSize = atoi(argv[2]);
+    if (!IsSmallBoardSize(opt.iSize)) {
+        cout << "棋盘大小必须在 7~11 之间" << endl;
+        return 1;
+    }
+    string strRule = argv[3];
+    if (strRule == "renju") opt.iRule = RULE_RENJU;
+    else if (strRule == "standard") opt.iRule = RULE_STANDARD;
+    else if (strRule == "freestyle") opt.iRule = RULE_FREESTYLE;
+    else {
+        cout << "未知规则 " << strRule << " (renju / standard / freestyle)" << endl;
+        return 1;
+    }
+    string strMoves = argv[4];
+    if (strMoves != "-") {
+        stringstream ss(strMoves);
+        string strMove;
+        while (getline(ss, strMove, ',')) {
+            Point p;
+            if (!StringToPoint(strMove, &p)) {
+                cout << "看不懂的着法: " << strMove << endl;
+                return 1;
+            }
+            opt.vecRootMoves.push_back(p);
+        }
+    }
+    opt.iPlies = max(0, min(atoi(argv[5]), 8));
+    opt.strTableFile = argv[6];
+    opt.iThreads = (argc > 7) ? atoi(argv[7]) : (int)thread::hardware_concurrency();
+    if (opt.iThreads < 1) opt.iThreads = 1;
+    opt.llNodesPerPosition = (argc > 8) ? atoll(argv[8]) : -1;
+    opt.iSeconds = (argc > 9) ? atoi(argv[9]) : 0;
+    opt.iTTBytes = (size_t)((argc > 10) ? atoi(argv[10]) : 256) << 20;
+    opt.iCheckpointSeconds = 10;
+
+    SSmallSolveSummary sum = SolveSmallBoard(opt, cout);
+    if (!sum.bOk) {
+        cout << sum.strError << endl;
+        return 1;
+    }
+    cout << "局面 " << sum.iPositions << " 个: 胜 " << sum.arrValues[SOLVE_WIN] << ", 和 " << sum.arrValues[SOLVE_DRAW]
+         << ", 负 " << sum.arrValues[SOLVE_LOSS] << ", 未解 " << sum.arrValues[SOLVE_UNKNOWN] << " (走棋一方视角)" << endl;
+    cout << "本次 " << sum.llNodes << " 节点, 用时 " << sum.dSeconds << "s ("
+         << (long long)(sum.dSeconds > 0 ? sum.llNodes / sum.dSeconds : 0) << " 节点/秒)" << endl;
+    cout << "起始局面 (" << (opt.vecRootMoves.size() % 2 == 0 ? "黑" : "白") << "先): " << GetSolveValueName(sum.iRootValue);
+    if (sum.stRootBest.iX >= 0) cout << ", 最佳第一手 " << PointToString(sum.stRootBest);
+    cout << endl;
+    return sum.arrValues[SOLVE_UNKNOWN] == 0 ? 0 : 2;
+}
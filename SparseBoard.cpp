@@ -0,0 +1,105 @@
+#include "SparseBoard.h"
+#include <algorithm>
+
+using namespace std;
+
+CSparseBoard::CSparseBoard() {
+    Reset();
+}
+
+void CSparseBoard::Reset() {
+    m_mapChunks.clear();
+    m_stLastMove = { -1, -1 };
+    m_iStones = 0;
+}
+
+int CSparseBoard::GetPiece(int x, int y) const {
+    if (!IsValid(x, y)) return -1;
+    unordered_map<uint64_t, SChunk, SKeyHash>::const_iterator it = m_mapChunks.find(ChunkKey(x, y));
+    if (it == m_mapChunks.end()) return EMPTY;
+    uint16_t uBit = (uint16_t)(1u << (x & CHUNK_MASK));
+    int iRow = y & CHUNK_MASK;
+    if (it->second.arrRows[0][iRow] & uBit) return BLACK;
+    if (it->second.arrRows[1][iRow] & uBit) return WHITE;
+    return EMPTY;
+}
+
+// 与 CBoardT 一样：落 EMPTY 等于提子，越界忽略
+void CSparseBoard::PlacePiece(int x, int y, int type) {
+    if (!IsValid(x, y)) return;
+    if (type == EMPTY) {
+        UndoPiece(x, y);
+        return;
+    }
+    SChunk& chunk = m_mapChunks[ChunkKey(x, y)]; // 新块值初始化为全 0
+    uint16_t uBit = (uint16_t)(1u << (x & CHUNK_MASK));
+    int iRow = y & CHUNK_MASK;
+    bool bWasEmpty = ((chunk.arrRows[0][iRow] | chunk.arrRows[1][iRow]) & uBit) == 0;
+    chunk.arrRows[0][iRow] &= (uint16_t)~uBit;
+    chunk.arrRows[1][iRow] &= (uint16_t)~uBit;
+    chunk.arrRows[type - 1][iRow] |= uBit;
+    if (bWasEmpty) {
+        chunk.iStones++;
+        m_iStones++;
+    }
+    m_stLastMove = { x, y };
+}
+
+// 块里的子提光就把块删掉，内存只跟着现有的棋子走
+void CSparseBoard::UndoPiece(int x, int y) {
+    if (!IsValid(x, y)) return;
+    unordered_map<uint64_t, SChunk, SKeyHash>::iterator it = m_mapChunks.find(ChunkKey(x, y));
+    if (it == m_mapChunks.end()) return;
+    SChunk& chunk = it->second;
+    uint16_t uBit = (uint16_t)(1u << (x & CHUNK_MASK));
+    int iRow = y & CHUNK_MASK;
+    if (((chunk.arrRows[0][iRow] | chunk.arrRows[1][iRow]) & uBit) == 0) return;
+    chunk.arrRows[0][iRow] &= (uint16_t)~uBit;
+    chunk.arrRows[1][iRow] &= (uint16_t)~uBit;
+    m_iStones--;
+    if (--chunk.iStones == 0) m_mapChunks.erase(it);
+}
+
+size_t CSparseBoard::GetMemoryBytes() const {
+    // 每个节点：值 + 键 + 链表指针 + 缓存的哈希值；再加桶数组
+    size_t iNode = sizeof(SChunk) + sizeof(uint64_t) + 2 * sizeof(void*);
+    return m_mapChunks.size() * iNode + m_mapChunks.bucket_count() * sizeof(void*);
+}
+
+void CSparseBoard::GetStones(vector<Point>& vecOut) const {
+    vecOut.clear();
+    for (unordered_map<uint64_t, SChunk, SKeyHash>::const_iterator it = m_mapChunks.begin(); it != m_mapChunks.end(); ++it) {
+        int iBaseX = (int)(int32_t)(uint32_t)(it->first >> 32) * CHUNK;
+        int iBaseY = (int)(int32_t)(uint32_t)it->first * CHUNK;
+        for (int r = 0; r < CHUNK; r++) {
+            unsigned uBits = (unsigned)(it->second.arrRows[0][r] | it->second.arrRows[1][r]);
+            for (int c = 0; uBits != 0; c++, uBits >>= 1) {
+                if (uBits & 1u) vecOut.push_back({ iBaseX + c, iBaseY + r });
+            }
+        }
+    }
+}
+
+void CSparseBoard::CollectCandidates(int iRadius, vector<Point>& vecOut) const {
+    vecOut.clear();
+    if (m_iStones == 0) {
+        vecOut.push_back({ 0, 0 });
+        return;
+    }
+    vector<Point> vecStones;
+    GetStones(vecStones);
+    vecOut.reserve(vecStones.size() * (2 * iRadius + 1) * (2 * iRadius + 1));
+    for (size_t i = 0; i < vecStones.size(); i++) {
+        for (int dy = -iRadius; dy <= iRadius; dy++) {
+            for (int dx = -iRadius; dx <= iRadius; dx++) {
+                vecOut.push_back({ vecStones[i].iX + dx, vecStones[i].iY + dy });
+            }
+        }
+    }
+    sort(vecOut.begin(), vecOut.end(), [](const Point& a, const Point& b) {
+        return a.iY != b.iY ? a.iY < b.iY : a.iX < b.iX;
+    });
+    vecOut.erase(unique(vecOut.begin(), vecOut.end()), vecOut.end());
+    vecOut.erase(remove_if(vecOut.begin(), vecOut.end(), [this](const Point& p) { return !IsEmpty(p.iX, p.iY); }),
+                 vecOut.end());
+}
@@ -0,0 +1,76 @@
+#ifndef _SPARSEBOARD_H_
+#define _SPARSEBOARD_H_
+
+#include "Global.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 坐标范围 (正负都可以)，块编号打包成 64 位键时不会溢出
+const int SPARSE_COORD_LIMIT = 1 << 28;
+
+// 无边界棋盘：按 16x16 的块存放，块放在哈希表里，只有落过子的块才分配 (64 字节的两张位图)
+// 接口与 CBoardT 相同 (PlacePiece / UndoPiece / GetPiece / IsValid / IsEmpty / GetLastMove)，
+// 裁判 (CSparseRefereeT) 直接在上面判五连和禁手；没有边，线只会被对方棋子或空位截断
+// 内存和扫描都只与棋子数和它们周围的格子有关，与坐标跨度无关
+class CSparseBoard {
+public:
+    // 一条线上最多能数到的格子数 (CBoardT 为 N)
+    static const int SIZE = 2 * SPARSE_COORD_LIMIT;
+
+    CSparseBoard();
+
+    void Reset();
+
+    void PlacePiece(int x, int y, int type);
+    void UndoPiece(int x, int y);
+
+    // 越出 SPARSE_COORD_LIMIT 返回 -1 (与 CBoardT 的越界一致)
+    int GetPiece(int x, int y) const;
+    bool IsValid(int x, int y) const {
+        return x > -SPARSE_COORD_LIMIT && x < SPARSE_COORD_LIMIT && y > -SPARSE_COORD_LIMIT && y < SPARSE_COORD_LIMIT;
+    }
+    bool IsEmpty(int x, int y) const { return GetPiece(x, y) == EMPTY; }
+    Point GetLastMove() const { return m_stLastMove; }
+
+    int GetStoneCount() const { return m_iStones; }
+    int GetChunkCount() const { return (int)m_mapChunks.size(); }
+    // 块和哈希表占用的大致字节数
+    size_t GetMemoryBytes() const;
+
+    // 所有棋子的坐标 (顺序不定)
+    void GetStones(std::vector<Point>& vecOut) const;
+
+    // 候选点：与某颗棋子的切比雪夫距离不超过 iRadius 的空位，按 (y, x) 排序；空棋盘只有原点
+    // 只扫有子的块里的位，与棋盘跨度无关
+    void CollectCandidates(int iRadius, std::vector<Point>& vecOut) const;
+
+private:
+    enum { CHUNK_SHIFT = 4, CHUNK = 1 << CHUNK_SHIFT, CHUNK_MASK = CHUNK - 1 };
+
+    struct SChunk {
+        uint16_t arrRows[2][CHUNK]; // [颜色-1][行]，第 i 位是块内第 i 列
+        int iStones;
+    };
+
+    struct SKeyHash {
+        size_t operator()(uint64_t ullKey) const {
+            ullKey ^= ullKey >> 33;
+            ullKey *= 0xff51afd7ed558ccdULL;
+            ullKey ^= ullKey >> 33;
+            return (size_t)ullKey;
+        }
+    };
+
+    std::unordered_map<uint64_t, SChunk, SKeyHash> m_mapChunks;
+    Point m_stLastMove;
+    int m_iStones;
+
+    // 负坐标也按向下取整分块 (算术右移)
+    static uint64_t ChunkKey(int x, int y) {
+        return ((uint64_t)(uint32_t)(x >> CHUNK_SHIFT) << 32) | (uint32_t)(y >> CHUNK_SHIFT);
+    }
+};
+
+#endif
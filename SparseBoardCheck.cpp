@@ -0,0 +1,190 @@
+#include "SparseBoard.h"
+#include "Checks.h"
+#include "Board.h"
+#include "GameSession.h"
+#include "Referee.h"
+#include "Rules.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// 无边界棋盘校验：WuZiQiDemo --check-sparse [局数]
+// 在 20x20 棋盘的内圈随机落子/悔棋，同样的棋子平移到任意远处 (含负坐标、跨块) 摆在 CSparseBoard 上，
+// 每一步比对两边裁判的 CheckWin / CheckForbidden；隔几步比对全部格子和两格内的候选点；悔光以后块必须全部释放
+// 棋子离边至少两格，稠密棋盘的边不会影响判定和候选，两边应完全一致
+struct SSparseChecker {
+    typedef int ResultType;
+    int iGames;
+    minstd_rand* pRng;
+    long long* pSteps;
+
+    template <int N, class TRule>
+    int Run() {
+        minstd_rand& rng = *pRng;
+        int iMismatches = 0;
+        for (int g = 0; g < iGames; g++) {
+            CBoardT<N> board;
+            CSparseBoard sparse;
+            int ox = (int)(rng() % 200000001) - 100000000, oy = (int)(rng() % 200000001) - 100000000;
+            if (g % 3 == 0) { ox = -N / 2; oy = -N / 2; } // 跨过原点的四个块
+            vector<Point> vecMoves;
+            int color = BLACK;
+            int iSteps = N * N / 3 + (int)(rng() % (N * N / 3));
+            for (int k = 0; k < iSteps; k++) {
+                if (!vecMoves.empty() && rng() % 6 == 0) {
+                    Point p = vecMoves.back();
+                    vecMoves.pop_back();
+                    board.UndoPiece(p.iX, p.iY);
+                    sparse.UndoPiece(p.iX + ox, p.iY + oy);
+                    color = 3 - color;
+                    continue;
+                }
+                int x = 2 + (int)(rng() % (N - 4)), y = 2 + (int)(rng() % (N - 4));
+                if (!board.IsEmpty(x, y)) continue;
+                board.PlacePiece(x, y, color);
+                sparse.PlacePiece(x + ox, y + oy, color);
+                vecMoves.push_back({ x, y });
+                (*pSteps)++;
+
+                bool bWin = CRefereeT<N, TRule>::CheckWin(board, x, y);
+                bool bForbidden = CRefereeT<N, TRule>::CheckForbidden(board, x, y);
+                bool bSame = bWin == CSparseRefereeT<TRule>::CheckWin(sparse, x + ox, y + oy) &&
+                             bForbidden == CSparseRefereeT<TRule>::CheckForbidden(sparse, x + ox, y + oy) &&
+                             sparse.GetStoneCount() == (int)vecMoves.size();
+                if (bSame && k % 8 == 0) {
+                    vector<Point> vecSparse, vecDense;
+                    sparse.CollectCandidates(2, vecSparse);
+                    for (int cy = 0; cy < N; cy++) {
+                        for (int cx = 0; cx < N; cx++) {
+                            if (sparse.GetPiece(cx + ox, cy + oy) != board.GetPiece(cx, cy)) bSame = false;
+                            if (!board.IsEmpty(cx, cy)) continue;
+                            bool bNear = false;
+                            for (int dy = -2; dy <= 2 && !bNear; dy++) {
+                                for (int dx = -2; dx <= 2; dx++) {
+                                    if (board.IsValid(cx + dx, cy + dy) && !board.IsEmpty(cx + dx, cy + dy)) bNear = true;
+                                }
+                            }
+                            if (bNear) vecDense.push_back({ cx + ox, cy + oy });
+                        }
+                    }
+                    if (!vecMoves.empty() && vecSparse != vecDense) bSame = false;
+                }
+                if (!bSame) {
+                    if (iMismatches == 0) {
+                        cout << " [不一致] " << TRule::Name() << " 第 " << g << " 局 第 " << k << " 步 "
+                             << PointToString({ x, y }) << " 偏移 (" << ox << ", " << oy << ")" << endl;
+                    }
+                    iMismatches++;
+                }
+                // 成五或禁手后这一手收回，继续在同一盘上随机摆
+                if (bWin || bForbidden) {
+                    vecMoves.pop_back();
+                    board.UndoPiece(x, y);
+                    sparse.UndoPiece(x + ox, y + oy);
+                    continue;
+                }
+                color = 3 - color;
+            }
+            while (!vecMoves.empty()) {
+                sparse.UndoPiece(vecMoves.back().iX + ox, vecMoves.back().iY + oy);
+                vecMoves.pop_back();
+            }
+            if (sparse.GetChunkCount() != 0 || sparse.GetStoneCount() != 0) {
+                if (iMismatches == 0) cout << " [不一致] " << TRule::Name() << " 第 " << g << " 局 悔光后仍有块" << endl;
+                iMismatches++;
+            }
+        }
+        return iMismatches;
+    }
+};
+
+int RunSparseCheck(int argc, char* argv[]) {
+    int iGames = (argc > 2) ? atoi(argv[2]) : 30;
+    minstd_rand rng(44);
+    long long llSteps = 0;
+    const int arrRules[] = { RULE_RENJU, RULE_STANDARD, RULE_FREESTYLE };
+    int iMismatches = 0;
+    for (int j = 0; j < 3; j++) {
+        SSparseChecker checker = { iGames, &rng, &llSteps };
+        iMismatches += DispatchGame(20, arrRules[j], checker);
+    }
+    cout << (iMismatches == 0 ? "[通过]" : "[失败]") << " 3 种规则 x " << iGames << " 局, " << llSteps
+         << " 步, 不一致数: " << iMismatches << endl;
+    return iMismatches == 0 ? 0 : 1;
+}
+
+// 无边界棋盘的开销：WuZiQiDemo --bench-sparse [棋子数] [跨度]
+// 1. 棋子按小团散在 跨度 x 跨度 的范围里，看内存、候选点生成和判五的耗时是否只随棋子数增长
+// 2. 无边界自由规则的随机对局 (与 MCTS 模拟同样的走法)：每秒盘数、平均手数、最终的块数
+int RunSparseBench(int argc, char* argv[]) {
+    int iStones = (argc > 2) ? atoi(argv[2]) : 20000;
+    int iSpan = (argc > 3) ? atoi(argv[3]) : 100000000;
+    minstd_rand rng(44);
+
+    cout << "棋子 " << iStones << " 颗, 跨度 " << iSpan << endl;
+    for (int iCount = iStones / 16; iCount <= iStones; iCount *= 4) {
+        CSparseBoard board;
+        while (board.GetStoneCount() < iCount) {
+            int cx = (int)(rng() % (unsigned)iSpan) - iSpan / 2, cy = (int)(rng() % (unsigned)iSpan) - iSpan / 2;
+            for (int k = 0; k < 40 && board.GetStoneCount() < iCount; k++) {
+                int x = cx + (int)(rng() % 9) - 4, y = cy + (int)(rng() % 9) - 4;
+                if (board.IsEmpty(x, y)) board.PlacePiece(x, y, (k % 2) ? WHITE : BLACK);
+            }
+        }
+        vector<Point> vecStones, vecCand;
+        board.GetStones(vecStones);
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        board.CollectCandidates(2, vecCand);
+        double dCand = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        t0 = chrono::steady_clock::now();
+        int iWins = 0;
+        for (size_t i = 0; i < vecStones.size(); i++) {
+            iWins += CSparseRefereeT<CFreestyleRule>::CheckWin(board, vecStones[i].iX, vecStones[i].iY);
+        }
+        double dWin = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        cout << " " << iCount << " 颗: " << board.GetChunkCount() << " 块, 约 " << board.GetMemoryBytes() / 1024
+             << " KB, 候选 " << vecCand.size() << " 个用时 " << dCand * 1000 << " ms, 每颗判五 "
+             << dWin * 1e9 / vecStones.size() << " ns (成五 " << iWins << ")" << endl;
+        if (iCount == iStones) break;
+        if (iCount * 4 > iStones) iCount = iStones / 4;
+    }
+
+    // 随机对局：候选为与棋子相邻的空位，均匀随机选
+    int iGames = 200;
+    long long llMoves = 0, llChunks = 0;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int g = 0; g < iGames; g++) {
+        CSparseBoard board;
+        unordered_set<uint64_t> setSeen;
+        vector<Point> vecCells(1, Point{ 0, 0 });
+        setSeen.insert(0);
+        int color = BLACK;
+        while (!vecCells.empty()) {
+            int k = (int)(rng() % vecCells.size());
+            Point p = vecCells[k];
+            vecCells[k] = vecCells.back();
+            vecCells.pop_back();
+            board.PlacePiece(p.iX, p.iY, color);
+            llMoves++;
+            if (CSparseRefereeT<CFreestyleRule>::CheckWin(board, p.iX, p.iY)) break;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    Point q = { p.iX + dx, p.iY + dy };
+                    uint64_t ullKey = ((uint64_t)(uint32_t)q.iX << 32) | (uint32_t)q.iY;
+                    if (board.IsEmpty(q.iX, q.iY) && setSeen.insert(ullKey).second) vecCells.push_back(q);
+                }
+            }
+            color = 3 - color;
+        }
+        llChunks += board.GetChunkCount();
+    }
+    double dSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << " 无边界自由规则随机对局: " << (int)(iGames / dSeconds) << " 盘/秒, 平均 " << (double)llMoves / iGames
+         << " 手, 平均 " << (double)llChunks / iGames << " 块" << endl;
+    return 0;
+}
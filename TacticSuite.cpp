@@ -0,0 +1,230 @@
+#include "TacticSuite.h"
+#include "AIPlayer.h"
+#include "GameSession.h"
+#include "ProofSolver.h"
+#include "Referee.h"
+#include "Rules.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+using namespace std;
+
+// 证明题的置换表大小
+static const size_t TACTIC_PROOF_MEMORY = (size_t)32 << 20;
+
+static bool ParsePointList(const string& strList, vector<Point>& vecOut) {
+    stringstream ss(strList);
+    string strMove;
+    while (getline(ss, strMove, ',')) {
+        if (strMove.empty()) continue;
+        Point p;
+        if (!StringToPoint(strMove, &p)) return false;
+        vecOut.push_back(p);
+    }
+    return true;
+}
+
+static bool ContainsPoint(const vector<Point>& vec, Point p) {
+    return find(vec.begin(), vec.end(), p) != vec.end();
+}
+
+bool LoadTacticSuite(const string& strFile, vector<STacticPosition>& vecOut, string* pError) {
+    ifstream file(strFile);
+    if (!file.is_open()) {
+        if (pError) *pError = "无法打开 " + strFile;
+        return false;
+    }
+
+    string strLine;
+    int iLine = 0;
+    while (getline(file, strLine)) {
+        iLine++;
+        STacticPosition pos;
+        size_t iSemi = strLine.find(';');
+        if (iSemi != string::npos) {
+            pos.strComment = strLine.substr(iSemi + 1);
+            size_t iFirst = pos.strComment.find_first_not_of(' ');
+            pos.strComment = (iFirst == string::npos) ? "" : pos.strComment.substr(iFirst);
+            strLine = strLine.substr(0, iSemi);
+        }
+
+        stringstream ss(strLine);
+        string strSize, strRule, strMoves;
+        if (!(ss >> pos.strId) || pos.strId[0] == '#') continue;
+
+        string strBad;
+        if (!(ss >> strSize >> strRule >> strMoves)) strBad = "缺少棋盘大小/规则/着法";
+        pos.iSize = atoi(strSize.c_str());
+        if (strBad.empty() && !IsSupportedBoardSize(pos.iSize)) strBad = "不支持的棋盘大小 " + strSize;
+        if (strRule == "renju") pos.iRule = RULE_RENJU;
+        else if (strRule == "standard") pos.iRule = RULE_STANDARD;
+        else if (strRule == "freestyle") pos.iRule = RULE_FREESTYLE;
+        else if (strBad.empty()) strBad = "未知规则 " + strRule;
+        if (strBad.empty() && strMoves != "-" && !ParsePointList(strMoves, pos.vecMoves)) strBad = "无效着法 " + strMoves;
+
+        pos.iGoal = TACTIC_MOVE;
+        string strOp;
+        while (strBad.empty() && ss >> strOp) {
+            if (strOp == "win") pos.iGoal = TACTIC_WIN;
+            else if (strOp == "vcf") pos.iGoal = TACTIC_VCF;
+            else if (strOp == "vct") pos.iGoal = TACTIC_VCT;
+            else if (strOp.compare(0, 3, "bm=") == 0 && ParsePointList(strOp.substr(3), pos.vecBest)) {}
+            else if (strOp.compare(0, 3, "am=") == 0 && ParsePointList(strOp.substr(3), pos.vecAvoid)) {}
+            else strBad = "无法识别 " + strOp;
+        }
+        if (strBad.empty() && pos.iGoal == TACTIC_MOVE && pos.vecBest.empty() && pos.vecAvoid.empty()) {
+            strBad = "没有判定 (bm/am/win/vcf/vct)";
+        }
+
+        // 着法和答案要落在棋盘内，着法不能重叠
+        vector<Point> vecAnswers(pos.vecBest);
+        vecAnswers.insert(vecAnswers.end(), pos.vecAvoid.begin(), pos.vecAvoid.end());
+        for (size_t i = 0; strBad.empty() && i < vecAnswers.size(); i++) {
+            if (vecAnswers[i].iX >= pos.iSize || vecAnswers[i].iY < 0 || vecAnswers[i].iY >= pos.iSize) {
+                strBad = "答案不在棋盘内 " + PointToString(vecAnswers[i]);
+            }
+        }
+        if (strBad.empty()) {
+            vector<bool> vecUsed(pos.iSize * pos.iSize, false);
+            for (size_t i = 0; i < pos.vecMoves.size(); i++) {
+                Point p = pos.vecMoves[i];
+                if (p.iX < 0 || p.iX >= pos.iSize || p.iY < 0 || p.iY >= pos.iSize || vecUsed[p.iY * pos.iSize + p.iX]) {
+                    strBad = "着法越界或重复 " + PointToString(p);
+                    break;
+                }
+                vecUsed[p.iY * pos.iSize + p.iX] = true;
+            }
+        }
+
+        if (!strBad.empty()) {
+            if (pError) *pError = strFile + " 第 " + to_string(iLine) + " 行: " + strBad;
+            return false;
+        }
+        vecOut.push_back(pos);
+    }
+    return true;
+}
+
+// 在题目的棋盘大小和规则下做题
+struct STacticRunner {
+    typedef STacticResult ResultType;
+    const STacticPosition* pPos;
+    const STacticOptions* pOpt;
+
+    template <int N, class TRule>
+    STacticResult Run() {
+        const STacticPosition& pos = *pPos;
+        STacticResult result;
+        result.strId = pos.strId;
+        result.bSolved = false;
+        result.dSeconds = 0;
+        result.llNodes = 0;
+        result.iDepth = 0;
+        result.stAnswer.iX = -1;
+        result.stAnswer.iY = -1;
+
+        CBoardT<N> board;
+        int color = BLACK;
+        for (size_t i = 0; i < pos.vecMoves.size(); i++) {
+            board.PlacePiece(pos.vecMoves[i].iX, pos.vecMoves[i].iY, color);
+            color = 3 - color;
+        }
+
+        // 置换表清零不算在做题时间里
+        unique_ptr<CProofSolverT<N, TRule>> pSolver;
+        if (pos.iGoal == TACTIC_VCF || pos.iGoal == TACTIC_VCT) pSolver.reset(new CProofSolverT<N, TRule>(TACTIC_PROOF_MEMORY));
+
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        CSearchControl ctl(CSearchControl::Clock::now() + chrono::milliseconds(pOpt->iMillis), pOpt->llNodes, 1);
+
+        if (pSolver) {
+            CProofSolverT<N, TRule>& solver = *pSolver;
+            solver.SetFoursOnly(pos.iGoal == TACTIC_VCF);
+            SProofResult proof = solver.Solve(board, color, ctl);
+            result.bSolved = (proof.iResult == PROOF_WIN);
+            result.dSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            result.llNodes = proof.llNodes;
+            if (!proof.vecLine.empty()) result.stAnswer = proof.vecLine[0];
+            if (result.bSolved && !pos.vecBest.empty()) result.bSolved = ContainsPoint(pos.vecBest, result.stAnswer);
+            return result;
+        }
+
+        // 逐层加深，记下答案最后一次变对的那一层；置换表留在 AI 里，下一层接着用
+        CAIPlayerT<N, TRule> ai(color, make_shared<AIWeights>());
+        bool bCorrect = false;
+        for (int depth = 1; depth <= pOpt->iMaxDepth; depth++) {
+            ai.SetSearchDepth(depth);
+            Point p = ai.SearchMove(board, ctl, pOpt->iThreads);
+            const SSearchStats& st = ai.GetLastSearchStats();
+            if (st.iDepth < depth) break; // 这一层没搜完
+
+            bool bNow = (pos.vecBest.empty() || ContainsPoint(pos.vecBest, p)) && !ContainsPoint(pos.vecAvoid, p);
+            if (pos.iGoal == TACTIC_WIN && !(IsMateScore(st.iScore) && st.iScore > 0)) bNow = false;
+            if (bNow && !bCorrect) {
+                result.dSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+                result.llNodes = ctl.GetNodes();
+                result.iDepth = depth;
+            }
+            bCorrect = bNow;
+            result.stAnswer = p;
+            // 已经算出胜负，再加深也不会变
+            if (IsMateScore(st.iScore)) break;
+        }
+        result.bSolved = bCorrect;
+        if (!bCorrect) {
+            result.dSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            result.llNodes = ctl.GetNodes();
+            result.iDepth = 0;
+        }
+        return result;
+    }
+};
+
+STacticResult RunTacticPosition(const STacticPosition& pos, const STacticOptions& opt) {
+    STacticRunner runner = { &pos, &opt };
+    return DispatchGame(pos.iSize, pos.iRule, runner);
+}
+
+bool SaveTacticResults(const string& strFile, const vector<STacticResult>& vecResults) {
+    ofstream file(strFile);
+    if (!file.is_open()) return false;
+    file << "# 编号 是否解出 秒 节点 深度 答案" << endl;
+    for (size_t i = 0; i < vecResults.size(); i++) {
+        const STacticResult& r = vecResults[i];
+        file << r.strId << " " << (r.bSolved ? 1 : 0) << " " << r.dSeconds << " " << r.llNodes << " "
+             << r.iDepth << " " << (r.stAnswer.iX >= 0 ? PointToString(r.stAnswer) : "-") << endl;
+    }
+    return file.good();
+}
+
+bool LoadTacticResults(const string& strFile, vector<STacticResult>& vecOut, string* pError) {
+    ifstream file(strFile);
+    if (!file.is_open()) {
+        if (pError) *pError = "无法打开 " + strFile;
+        return false;
+    }
+    string strLine;
+    int iLine = 0;
+    while (getline(file, strLine)) {
+        iLine++;
+        if (strLine.empty() || strLine[0] == '#') continue;
+        stringstream ss(strLine);
+        STacticResult r;
+        int iSolved = 0;
+        string strAnswer;
+        if (!(ss >> r.strId >> iSolved >> r.dSeconds >> r.llNodes >> r.iDepth >> strAnswer)) {
+            if (pError) *pError = strFile + " 第 " + to_string(iLine) + " 行格式错误";
+            return false;
+        }
+        r.bSolved = (iSolved != 0);
+        if (strAnswer == "-" || !StringToPoint(strAnswer, &r.stAnswer)) {
+            r.stAnswer.iX = -1;
+            r.stAnswer.iY = -1;
+        }
+        vecOut.push_back(r);
+    }
+    return true;
+}
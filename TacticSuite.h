@@ -0,0 +1,60 @@
+#ifndef _TACTICSUITE_H_
+#define _TACTICSUITE_H_
+
+#include "Global.h"
+#include <string>
+#include <vector>
+
+// 战术题的判定方式
+enum ETacticGoal {
+    TACTIC_MOVE = 0, // 按 bm/am 判 Alpha-Beta 搜出的落点
+    TACTIC_WIN,      // Alpha-Beta 必须搜出轮到的一方必胜 (走哪一步不限)
+    TACTIC_VCF,      // 证明数搜索 (只走冲四) 必须证出轮到的一方必胜
+    TACTIC_VCT       // 同上，允许走活三
+};
+
+// 题库里的一道题
+// 文件每行一题：编号 棋盘大小 规则 着法 判定... [; 说明]
+//   着法从空棋盘起黑白交替，逗号分隔，空棋盘写 "-"；规则为 renju / standard / freestyle
+//   判定：bm=H8,J9 (答案必须是其中之一)  am=G7 (答案不能是它)  win  vcf  vct
+// 以 # 开头的行和空行忽略
+struct STacticPosition {
+    std::string strId;
+    int iSize;
+    int iRule;
+    std::vector<Point> vecMoves;
+    std::vector<Point> vecBest;
+    std::vector<Point> vecAvoid;
+    int iGoal;                 // ETacticGoal
+    std::string strComment;
+};
+
+struct STacticOptions {
+    int iMillis;         // 每题的时间上限
+    long long llNodes;   // 每题的节点上限，<0 不限
+    int iThreads;        // Alpha-Beta 的线程数 (VCF/VCT 题只用一个线程)
+    int iMaxDepth;       // Alpha-Beta 最多加深到几层
+};
+
+// 一道题的结果
+// 解出时，时间/节点数是答案最后一次变对 (之后各层不再变) 的那一层搜完时累计的量；没解出时为全部用量
+struct STacticResult {
+    std::string strId;
+    bool bSolved;
+    double dSeconds;
+    long long llNodes;
+    int iDepth;      // 解出的深度；VCF/VCT 题为 0
+    Point stAnswer;  // 最后的答案 (VCF/VCT 题为主线第一手)；iX < 0 表示没有
+};
+
+// 读题库；格式错误时返回 false，pError 给出行号
+bool LoadTacticSuite(const std::string& strFile, std::vector<STacticPosition>& vecOut, std::string* pError);
+
+// 按题目的棋盘大小和规则做一题
+STacticResult RunTacticPosition(const STacticPosition& pos, const STacticOptions& opt);
+
+// 结果存成基线 / 读回基线 (每行：编号 是否解出 秒 节点 深度 答案)
+bool SaveTacticResults(const std::string& strFile, const std::vector<STacticResult>& vecResults);
+bool LoadTacticResults(const std::string& strFile, std::vector<STacticResult>& vecOut, std::string* pError);
+
+#endif
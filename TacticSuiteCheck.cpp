@@ -0,0 +1,174 @@
+#include "TacticSuite.h"
+#include "Checks.h"
+#include "AIPlayer.h"
+#include "Board.h"
+#include "GameSession.h"
+#include "Rules.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 复盘分析：WuZiQiDemo --analyze <着法,逗号分隔> [K] [深度] [棋盘大小] [规则]
+// 给出轮到的一方前 K 个走法各自的评分和主变例，同时报告相对单主变例多花的节点数和时间
+struct SAnalyzeRunner {
+    typedef int ResultType;
+    string strMoves;
+    int iLines;
+    int iDepth;
+
+    template <int N, class TRule>
+    int Run() {
+        CBoardT<N> board;
+        int color = BLACK;
+        stringstream ss(strMoves);
+        string strMove;
+        while (getline(ss, strMove, ',')) {
+            if (strMove.empty()) continue;
+            Point p;
+            if (!StringToPoint(strMove, &p) || !board.IsValid(p.iX, p.iY) || !board.IsEmpty(p.iX, p.iY)) {
+                cout << "无效着法: " << strMove << endl;
+                return 1;
+            }
+            board.PlacePiece(p.iX, p.iY, color);
+            color = 3 - color;
+        }
+
+        shared_ptr<const AIWeights> pWeights = make_shared<AIWeights>(ReadAIWeights("ai_brain.txt"));
+        long long arrNodes[2] = { 0, 0 };
+        double arrSeconds[2] = { 0, 0 };
+        SSearchStats stats;
+        for (int k = 0; k < 2; k++) {
+            CAIPlayerT<N, TRule> ai(color, pWeights);
+            ai.SetSearchDepth(iDepth);
+            ai.SetMultiPV(k == 0 ? 1 : iLines);
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            ai.SearchMove(board);
+            arrSeconds[k] = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            arrNodes[k] = ai.GetLastSearchStats().llNodes;
+            stats = ai.GetLastSearchStats();
+        }
+
+        cout << N << "x" << N << " " << TRule::Name() << ", " << (color == BLACK ? "黑" : "白")
+             << "走, 深度 " << stats.iDepth << endl;
+        for (size_t i = 0; i < stats.vecLines.size(); i++) {
+            const SSearchLine& line = stats.vecLines[i];
+            cout << " " << (i + 1) << ". " << PointToString(line.stMove) << "  评分 " << line.iScore << "  ";
+            for (size_t k = 0; k < line.vecPV.size(); k++) cout << " " << PointToString(line.vecPV[k]);
+            cout << endl;
+        }
+        cout << " 节点 " << arrNodes[1] << " (单主变例 " << arrNodes[0] << ")  用时 " << arrSeconds[1]
+             << "s (单主变例 " << arrSeconds[0] << "s)" << endl;
+        return 0;
+    }
+};
+
+int RunAnalyze(int argc, char* argv[]) {
+    SAnalyzeRunner runner;
+    runner.strMoves = (argc > 2) ? argv[2] : "H8,H9,I8,I9";
+    runner.iLines = (argc > 3) ? atoi(argv[3]) : 3;
+    runner.iDepth = (argc > 4) ? atoi(argv[4]) : 4;
+    if (runner.iLines < 1) runner.iLines = 1;
+    if (runner.iDepth < 1) runner.iDepth = 1;
+    int iSize = (argc > 5) ? atoi(argv[5]) : BOARD_SIZE;
+    if (!IsSupportedBoardSize(iSize)) iSize = BOARD_SIZE;
+    int iRule = RULE_RENJU;
+    if (argc > 6 && string(argv[6]) == "standard") iRule = RULE_STANDARD;
+    else if (argc > 6 && string(argv[6]) == "freestyle") iRule = RULE_FREESTYLE;
+    return DispatchGame(iSize, iRule, runner);
+}
+
+// 战术题库：WuZiQiDemo --suite [题库文件] [每题毫秒] [节点上限] [线程数] [基线文件] [save]
+// 逐题在时间/节点上限内求解，打印是否解出、解出用时和节点数，以及按判定方式分类的通过率
+// 给了基线文件就逐题对比；最后加 save 则把这次的结果写成新的基线
+int RunSuite(int argc, char* argv[]) {
+    string strFile = (argc > 2) ? argv[2] : "tactics.txt";
+    STacticOptions opt;
+    opt.iMillis = (argc > 3) ? atoi(argv[3]) : 2000;
+    opt.llNodes = (argc > 4) ? atoll(argv[4]) : -1;
+    opt.iThreads = (argc > 5) ? atoi(argv[5]) : 1;
+    opt.iMaxDepth = SEARCH_MAX_PLY - 1;
+    string strBaseline = (argc > 6) ? argv[6] : "";
+    bool bSave = (argc > 7 && string(argv[7]) == "save");
+    if (opt.llNodes == 0) opt.llNodes = -1;
+    if (opt.iThreads < 1) opt.iThreads = 1;
+
+    vector<STacticPosition> vecPositions;
+    string strError;
+    if (!LoadTacticSuite(strFile, vecPositions, &strError)) {
+        cout << "读取题库失败: " << strError << endl;
+        return 1;
+    }
+    vector<STacticResult> vecBaseline;
+    if (!strBaseline.empty() && !bSave && !LoadTacticResults(strBaseline, vecBaseline, &strError)) {
+        cout << "读取基线失败: " << strError << endl;
+        return 1;
+    }
+
+    cout << strFile << ": " << vecPositions.size() << " 题, 每题 " << opt.iMillis << "ms";
+    if (opt.llNodes > 0) cout << " / " << opt.llNodes << " 节点";
+    cout << ", " << opt.iThreads << " 线程" << endl;
+
+    const char* arrGoals[] = { "着法", "必胜", "VCF", "VCT" };
+    int arrTotal[4] = { 0, 0, 0, 0 }, arrSolved[4] = { 0, 0, 0, 0 };
+    int iGained = 0, iLost = 0;
+    double dSolvedSeconds = 0;
+    vector<STacticResult> vecResults;
+    for (size_t i = 0; i < vecPositions.size(); i++) {
+        const STacticPosition& pos = vecPositions[i];
+        STacticResult r = RunTacticPosition(pos, opt);
+        vecResults.push_back(r);
+        arrTotal[pos.iGoal]++;
+        if (r.bSolved) {
+            arrSolved[pos.iGoal]++;
+            dSolvedSeconds += r.dSeconds;
+        }
+
+        char szLine[160];
+        snprintf(szLine, sizeof(szLine), " %-12s %-4s %-6s %8.3fs %10lld 节点  深度 %-2d 答案 %-4s",
+                 pos.strId.c_str(), arrGoals[pos.iGoal], r.bSolved ? "通过" : "失败", r.dSeconds, r.llNodes,
+                 r.iDepth, r.stAnswer.iX >= 0 ? PointToString(r.stAnswer).c_str() : "-");
+        cout << szLine;
+
+        for (size_t k = 0; k < vecBaseline.size(); k++) {
+            const STacticResult& b = vecBaseline[k];
+            if (b.strId != r.strId) continue;
+            if (b.bSolved != r.bSolved) {
+                cout << (r.bSolved ? "  [新通过]" : "  [新失败]");
+                (r.bSolved ? iGained : iLost)++;
+            } else if (r.bSolved && b.dSeconds > 0 && b.llNodes > 0) {
+                // 单线程时节点数是确定的，比用时更适合看搜索本身有没有变快
+                snprintf(szLine, sizeof(szLine), "  基线 %.3fs 用时 x%.2f 节点 x%.2f", b.dSeconds, r.dSeconds / b.dSeconds,
+                         (double)r.llNodes / b.llNodes);
+                cout << szLine;
+            }
+            break;
+        }
+        if (!pos.strComment.empty()) cout << "  ; " << pos.strComment;
+        cout << endl;
+    }
+
+    int iTotal = 0, iSolved = 0;
+    cout << "通过率:";
+    for (int g = 0; g < 4; g++) {
+        iTotal += arrTotal[g];
+        iSolved += arrSolved[g];
+        if (arrTotal[g] > 0) cout << "  " << arrGoals[g] << " " << arrSolved[g] << "/" << arrTotal[g];
+    }
+    cout << "  合计 " << iSolved << "/" << iTotal;
+    if (iSolved > 0) cout << ", 解出的平均用时 " << dSolvedSeconds / iSolved << "s";
+    cout << endl;
+    if (!vecBaseline.empty()) cout << "对比基线: 新通过 " << iGained << ", 新失败 " << iLost << endl;
+
+    if (bSave && !strBaseline.empty()) {
+        if (SaveTacticResults(strBaseline, vecResults)) cout << "已写出基线 " << strBaseline << endl;
+        else cout << "写出基线失败: " << strBaseline << endl;
+    }
+    return (iSolved == iTotal) ? 0 : 2;
+}
@@ -0,0 +1,64 @@
+#include "ThreadPool.h"
+#include "Trace.h"
+
+using namespace std;
+
+CThreadPool::CThreadPool(int iThreads) : m_bStopping(false) {
+    if (iThreads < 1) iThreads = 1;
+    for (int i = 0; i < iThreads; i++) {
+        m_vecWorkers.push_back(thread(&CThreadPool::WorkerLoop, this));
+    }
+}
+
+CThreadPool::~CThreadPool() {
+    Shutdown();
+}
+
+void CThreadPool::Submit(function<void()> fnTask) {
+    {
+        lock_guard<mutex> lock(m_mtx);
+        if (m_bStopping) return; // 已经关闭，丢弃任务
+        m_queTasks.push_back(std::move(fnTask));
+    }
+    m_cv.notify_one();
+}
+
+void CThreadPool::Shutdown() {
+    {
+        lock_guard<mutex> lock(m_mtx);
+        if (m_bStopping && m_vecWorkers.empty()) return;
+        m_bStopping = true;
+    }
+    m_cv.notify_all();
+    for (size_t i = 0; i < m_vecWorkers.size(); i++) {
+        if (m_vecWorkers[i].joinable()) m_vecWorkers[i].join();
+    }
+    m_vecWorkers.clear();
+}
+
+int CThreadPool::GetThreadCount() const {
+    return (int)m_vecWorkers.size();
+}
+
+int CThreadPool::GetQueueSize() {
+    lock_guard<mutex> lock(m_mtx);
+    return (int)m_queTasks.size();
+}
+
+void CThreadPool::WorkerLoop() {
+    CTrace::SetThreadName("pool worker");
+    while (true) {
+        function<void()> fnTask;
+        {
+            WZQ_TRACE_SCOPE("pool.wait", "pool");
+            unique_lock<mutex> lock(m_mtx);
+            m_cv.wait(lock, [this] { return m_bStopping || !m_queTasks.empty(); });
+            // 停止时也要把剩下的任务做完，避免对局卡在"思考中"
+            if (m_queTasks.empty()) return;
+            fnTask = std::move(m_queTasks.front());
+            m_queTasks.pop_front();
+        }
+        WZQ_TRACE_SCOPE("pool.task", "pool");
+        fnTask();
+    }
+}
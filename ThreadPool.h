@@ -0,0 +1,37 @@
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// 固定大小的工作线程池
+// 所有对局共用这一组线程：没有任务时线程阻塞在条件变量上，不占 CPU
+class CThreadPool {
+public:
+    explicit CThreadPool(int iThreads);
+    ~CThreadPool();
+
+    // 投递一个任务 (线程安全)
+    void Submit(std::function<void()> fnTask);
+
+    // 等待队列清空并停止所有线程
+    void Shutdown();
+
+    int GetThreadCount() const;
+    int GetQueueSize();
+
+private:
+    std::vector<std::thread> m_vecWorkers;
+    std::deque<std::function<void()>> m_queTasks;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_bStopping;
+
+    void WorkerLoop();
+};
+
+#endif
@@ -0,0 +1,298 @@
+#include "ThreatIndex.h"
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+static const int s_arrDX[4] = { 1, 0, 1, 1 };
+static const int s_arrDY[4] = { 0, 1, 1, -1 };
+
+// 槽位编号 = (窗口种类 * 4 + 方向) * N * N + 起点格子；种类 0 为 5 格窗口，1 为 6 格窗口
+template <int N, class TRule>
+CThreatIndexT<N, TRule>::CThreatIndexT() {
+    Reset();
+}
+
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::Reset() {
+    memset(m_arrGrid, -1, sizeof(m_arrGrid));
+    for (int y = 0; y < N; y++) memset(&m_arrGrid[(y + 1) * PADDED + 1], EMPTY, N);
+    memset(m_arrState, 0, sizeof(m_arrState));
+    memset(m_arrInner, 0, sizeof(m_arrInner));
+    memset(m_arrPos, -1, sizeof(m_arrPos));
+    m_vecActive[0].clear();
+    m_vecActive[1].clear();
+    memset(m_arrCount, 0, sizeof(m_arrCount));
+    memset(m_arrFiveGain, 0, sizeof(m_arrFiveGain));
+}
+
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::Rebuild(const Board& board) {
+    Reset();
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) m_arrGrid[(y + 1) * PADDED + x + 1] = (int8_t)board.GetPiece(x, y);
+    }
+    for (int iSlot = 0; iSlot < SLOTS; iSlot++) {
+        int iCell = iSlot % (N * N);
+        int sx = iCell % N, sy = iCell / N, d = (iSlot / (N * N)) % 4, kind = iSlot / (4 * N * N);
+        int ex = sx + s_arrDX[d] * (4 + kind), ey = sy + s_arrDY[d] * (4 + kind);
+        if (ex < 0 || ex >= N || ey < 0 || ey >= N) continue;
+        UpdateSlot(iSlot, sx, sy, d, kind);
+    }
+}
+
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::Sync(const Board& board) {
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            int piece = board.GetPiece(x, y);
+            int old = m_arrGrid[(y + 1) * PADDED + x + 1];
+            if (piece == old) continue;
+            if (old != EMPTY) Undo(x, y);
+            if (piece != EMPTY) Place(x, y, piece);
+        }
+    }
+}
+
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::Place(int x, int y, int color) {
+    m_arrGrid[(y + 1) * PADDED + x + 1] = (int8_t)color;
+    Refresh(x, y);
+}
+
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::Undo(int x, int y) {
+    m_arrGrid[(y + 1) * PADDED + x + 1] = EMPTY;
+    Refresh(x, y);
+}
+
+// 5 格窗口 (含两端外侧共 7 格) 的起点在 [-5, +1]，6 格窗口 (共 8 格) 的起点在 [-6, +1]
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::Refresh(int x, int y) {
+    for (int d = 0; d < 4; d++) {
+        int dx = s_arrDX[d], dy = s_arrDY[d];
+        for (int kind = 0; kind < WINDOW_KINDS; kind++) {
+            int iLen = 5 + kind;
+            for (int k = -iLen; k <= 1; k++) {
+                int sx = x + dx * k, sy = y + dy * k;
+                int ex = sx + dx * (iLen - 1), ey = sy + dy * (iLen - 1);
+                if (sx < 0 || sx >= N || sy < 0 || sy >= N || ex < 0 || ex >= N || ey < 0 || ey >= N) continue;
+                UpdateSlot((kind * 4 + d) * N * N + sy * N + sx, sx, sy, d, kind);
+            }
+        }
+    }
+}
+
+// 窗口必须整个在棋盘内 (由调用方保证)
+template <int N, class TRule>
+int CThreatIndexT<N, TRule>::Classify(int sx, int sy, int d, int kind, int* pInner) const {
+    int iLen = 5 + kind;
+    int iStep = s_arrDY[d] * PADDED + s_arrDX[d];
+    const int8_t* pFirst = &m_arrGrid[(sy + 1) * PADDED + sx + 1];
+
+    int arrCells[6];
+    for (int k = 0; k < iLen; k++) arrCells[k] = pFirst[k * iStep];
+    int before = pFirst[-iStep];           // 墙为 -1
+    int after = pFirst[iLen * iStep];
+
+    // 6 格窗口两端必须是空位，数子只看中间 4 格
+    int iFrom = 0, iTo = iLen;
+    if (kind == 1) {
+        if (arrCells[0] != EMPTY || arrCells[5] != EMPTY) return 0;
+        iFrom = 1;
+        iTo = 5;
+    }
+    int iBlack = 0, iWhite = 0, iEmptyAt = -1, iEmpty = 0;
+    for (int k = iFrom; k < iTo; k++) {
+        if (arrCells[k] == BLACK) iBlack++;
+        else if (arrCells[k] == WHITE) iWhite++;
+        else { iEmpty++; iEmptyAt = k; }
+    }
+    if (iBlack > 0 && iWhite > 0) return 0;
+    int color = iBlack > 0 ? BLACK : WHITE;
+    int iStones = iBlack + iWhite;
+
+    // 必须正好五连：外侧紧挨着己方子，成的就是长连
+    bool bExactFive = (color == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+    if (bExactFive && (before == color || after == color)) return 0;
+
+    int iShape = SHAPE_NONE;
+    if (kind == 0) {
+        if (iStones == 4 && iEmpty == 1) iShape = (iEmptyAt == 0 || iEmptyAt == 4) ? SHAPE_FOUR : SHAPE_BROKEN_FOUR;
+    } else {
+        if (iStones == 4) iShape = SHAPE_LIVE_FOUR;
+        else if (iStones == 3 && iEmpty == 1) iShape = (iEmptyAt == 1 || iEmptyAt == 4) ? SHAPE_OPEN_THREE : SHAPE_SPLIT_THREE;
+    }
+    if (iShape == SHAPE_NONE) return 0;
+    *pInner = iEmptyAt < 0 ? 0 : iEmptyAt; // 活四没有内部空位
+    return iShape | (color << 4);
+}
+
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::UpdateSlot(int iSlot, int sx, int sy, int d, int kind) {
+    int iInner = 0;
+    int iNew = Classify(sx, sy, d, kind, &iInner);
+    int iOld = m_arrState[iSlot];
+    if (iNew == iOld && (iNew == 0 || iInner == m_arrInner[iSlot])) return;
+    if (iOld != 0) Activate(iSlot, iOld, -1);
+    m_arrState[iSlot] = (uint8_t)iNew;
+    m_arrInner[iSlot] = (uint8_t)iInner;
+    if (iNew != 0) Activate(iSlot, iNew, 1);
+}
+
+// iSign = 1 加入，-1 移除：维护计数、活动列表和成五点计数
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::Activate(int iSlot, int iState, int iSign) {
+    int iShape = iState & 0xF;
+    int c = ((iState >> 4) == BLACK) ? 0 : 1;
+    m_arrCount[c][iShape] += iSign;
+
+    CFixedList<int, SLOTS>& vecActive = m_vecActive[c];
+    if (iSign > 0) {
+        m_arrPos[iSlot] = (int16_t)vecActive.size();
+        vecActive.push_back(iSlot);
+    } else {
+        int iPos = m_arrPos[iSlot];
+        int iLast = vecActive.back();
+        vecActive[iPos] = iLast;
+        m_arrPos[iLast] = (int16_t)iPos;
+        vecActive.pop_back();
+        m_arrPos[iSlot] = -1;
+    }
+
+    if (iShape == SHAPE_FOUR || iShape == SHAPE_BROKEN_FOUR || iShape == SHAPE_LIVE_FOUR) {
+        SThreatInfo info;
+        Describe(iSlot, &info);
+        for (int i = 0; i < info.iGainCount; i++) m_arrFiveGain[c][info.arrGain[i]] += iSign;
+    }
+}
+
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::Describe(int iSlot, SThreatInfo* pInfo) const {
+    int iState = m_arrState[iSlot];
+    int iCell = iSlot % (N * N);
+    int d = (iSlot / (N * N)) % 4;
+    int kind = iSlot / (4 * N * N);
+    int sx = iCell % N, sy = iCell / N;
+    int dx = s_arrDX[d], dy = s_arrDY[d];
+
+    pInfo->iShape = iState & 0xF;
+    pInfo->iColor = iState >> 4;
+    pInfo->iGainCount = 0;
+    pInfo->iDefenseCount = 0;
+
+    int iFirst = sy * N + sx;
+    int iStep = dy * N + dx;
+    int iLast = iFirst + iStep * (4 + kind);
+    int iInner = iFirst + iStep * m_arrInner[iSlot]; // 只从记录里取，移除时棋盘已经变了
+
+    if (pInfo->iShape == SHAPE_LIVE_FOUR) {
+        pInfo->arrGain[pInfo->iGainCount++] = iFirst;
+        pInfo->arrGain[pInfo->iGainCount++] = iLast;
+        pInfo->arrDefense[pInfo->iDefenseCount++] = iFirst;
+        pInfo->arrDefense[pInfo->iDefenseCount++] = iLast;
+    } else if (pInfo->iShape == SHAPE_FOUR || pInfo->iShape == SHAPE_BROKEN_FOUR) {
+        pInfo->arrGain[pInfo->iGainCount++] = iInner;
+        pInfo->arrDefense[pInfo->iDefenseCount++] = iInner;
+    } else if (pInfo->iShape != SHAPE_NONE) {
+        pInfo->arrGain[pInfo->iGainCount++] = iInner;
+        pInfo->arrDefense[pInfo->iDefenseCount++] = iInner;
+        pInfo->arrDefense[pInfo->iDefenseCount++] = iFirst;
+        pInfo->arrDefense[pInfo->iDefenseCount++] = iLast;
+    }
+}
+
+// 5 格窗口 3 子 2 空 (无对方子)：两个空位都能做成四
+// 6 格窗口两端空、中间 2 子 2 空：中间两个空位都能做成三
+// 必须正好五连的一方同样要求窗口外侧不紧挨己方子，与 Classify 落子后的判断一致
+template <int N, class TRule>
+void CThreatIndexT<N, TRule>::CollectMakingSquares(int color, bool bThrees, CMoveListT<N>& vecCells) const {
+    vecCells.clear();
+    bool bExactFive = (color == BLACK) ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+    bool arrMark[N * N] = {};
+    for (int d = 0; d < 4; d++) {
+        int dx = s_arrDX[d], dy = s_arrDY[d];
+        int iStep = dy * PADDED + dx;
+        for (int kind = 0; kind < (bThrees ? WINDOW_KINDS : 1); kind++) {
+            int iLen = 5 + kind;
+            for (int sy = 0; sy < N; sy++) {
+                for (int sx = 0; sx < N; sx++) {
+                    int ex = sx + dx * (iLen - 1), ey = sy + dy * (iLen - 1);
+                    if (ex < 0 || ex >= N || ey < 0 || ey >= N) continue;
+                    const int8_t* pFirst = &m_arrGrid[(sy + 1) * PADDED + sx + 1];
+                    if (kind == 1 && (pFirst[0] != EMPTY || pFirst[5 * iStep] != EMPTY)) continue;
+
+                    int iFrom = kind, iTo = 5;
+                    int iOwn = 0, arrEmpty[5], iEmpty = 0;
+                    bool bBlocked = false;
+                    for (int k = iFrom; k < iTo; k++) {
+                        int piece = pFirst[k * iStep];
+                        if (piece == color) iOwn++;
+                        else if (piece == EMPTY) arrEmpty[iEmpty++] = k;
+                        else { bBlocked = true; break; }
+                    }
+                    if (bBlocked || iOwn != 3 - kind || iEmpty != 2) continue;
+                    if (bExactFive && (pFirst[-iStep] == color || pFirst[iLen * iStep] == color)) continue;
+                    for (int e = 0; e < 2; e++) {
+                        int x = sx + dx * arrEmpty[e], y = sy + dy * arrEmpty[e];
+                        arrMark[y * N + x] = true;
+                    }
+                }
+            }
+        }
+    }
+    for (int i = 0; i < N * N; i++) {
+        if (arrMark[i]) vecCells.push_back(i);
+    }
+}
+
+// 同一个点可能被好几条威胁用到：必应点一般只有几个，直接在列表里查重
+template <int N>
+static void AddUnique(int iCell, CMoveListT<N>& vecCells) {
+    if (find(vecCells.begin(), vecCells.end(), iCell) == vecCells.end()) vecCells.push_back(iCell);
+}
+
+template <int N, class TRule>
+bool CThreatIndexT<N, TRule>::GetForcedMoves(int color, bool bThrees, CMoveListT<N>& vecCells) const {
+    int me = (color == BLACK) ? 0 : 1;
+    int enemy = 1 - me;
+    vecCells.clear();
+
+    // 1. 自己能成五
+    // 2. 对方能成五，必须挡
+    for (int pass = 0; pass < 2; pass++) {
+        int c = (pass == 0) ? me : enemy;
+        for (int i = 0; i < m_vecActive[c].size(); i++) {
+            int iShape = m_arrState[m_vecActive[c][i]] & 0xF;
+            if (iShape != SHAPE_FOUR && iShape != SHAPE_BROKEN_FOUR && iShape != SHAPE_LIVE_FOUR) continue;
+            SThreatInfo info;
+            Describe(m_vecActive[c][i], &info);
+            for (int k = 0; k < info.iGainCount; k++) AddUnique<N>(info.arrGain[k], vecCells);
+        }
+        if (!vecCells.empty()) break;
+    }
+
+    // 3. 对方有活三：挡住它，或者自己先做活四
+    if (vecCells.empty() && bThrees && m_arrCount[enemy][SHAPE_OPEN_THREE] + m_arrCount[enemy][SHAPE_SPLIT_THREE] > 0) {
+        for (int pass = 0; pass < 2; pass++) {
+            int c = (pass == 0) ? enemy : me;
+            for (int i = 0; i < m_vecActive[c].size(); i++) {
+                int iShape = m_arrState[m_vecActive[c][i]] & 0xF;
+                if (iShape != SHAPE_OPEN_THREE && iShape != SHAPE_SPLIT_THREE) continue;
+                SThreatInfo info;
+                Describe(m_vecActive[c][i], &info);
+                if (pass == 0) {
+                    for (int k = 0; k < info.iDefenseCount; k++) AddUnique<N>(info.arrDefense[k], vecCells);
+                } else {
+                    for (int k = 0; k < info.iGainCount; k++) AddUnique<N>(info.arrGain[k], vecCells);
+                }
+            }
+        }
+    }
+
+    sort(vecCells.begin(), vecCells.end());
+    return !vecCells.empty();
+}
+
+#define INSTANTIATE_THREATS(N, TRule) template class CThreatIndexT<N, TRule>;
+WZQ_FOR_EACH_GAME(INSTANTIATE_THREATS)
@@ -0,0 +1,97 @@
+#ifndef _THREATINDEX_H_
+#define _THREATINDEX_H_
+
+#include "Board.h"
+#include "Rules.h"
+#include "Global.h"
+#include "FixedList.h"
+#include <cstdint>
+
+// 威胁棋型
+enum EThreatShape {
+    SHAPE_NONE = 0,
+    SHAPE_FOUR,         // 冲四：5 格窗口里 4 子连续 + 1 空 (XXXX_)
+    SHAPE_BROKEN_FOUR,  // 跳四：空位在中间 (XX_XX、X_XXX)
+    SHAPE_LIVE_FOUR,    // 活四：_XXXX_
+    SHAPE_OPEN_THREE,   // 活三：_XXX__ / __XXX_
+    SHAPE_SPLIT_THREE,  // 跳活三：_XX_X_ / _X_XX_
+    SHAPE_COUNT
+};
+
+// 一条威胁的详情
+struct SThreatInfo {
+    int iShape;
+    int iColor;
+    int arrGain[2];     // 成型点：四的成五点，三的成活四点
+    int iGainCount;
+    int arrDefense[3];  // 防守点：对方必须下在其中之一才能化解
+    int iDefenseCount;
+};
+
+// 威胁索引：记录双方所有的四和活三，以及它们的成型点/防守点
+//
+// 每条直线上的每个 5 格窗口 (找四) 和 6 格窗口 (找活四、活三) 各占一个槽位，
+// 落子/提子时只重算窗口 (连同两端外各一格) 覆盖到该点的槽位：4 个方向 × 15 个窗口
+// 各条威胁挂在对应颜色的活动列表里，“谁有四/活三”“哪里能成五”都是直接查表
+// 必须正好五连的一方，成五点外侧紧挨着己方子 (会变成长连) 的不算威胁；黑棋的禁手点不在这里判断
+template <int N, class TRule>
+class CThreatIndexT {
+public:
+    typedef CBoardT<N> Board;
+
+    CThreatIndexT();
+
+    void Reset();
+    void Rebuild(const Board& board);
+    void Sync(const Board& board);       // 只对和上次不同的格子做增量更新
+    void Place(int x, int y, int color);
+    void Undo(int x, int y);
+
+    int GetCount(int color, int iShape) const { return m_arrCount[color == BLACK ? 0 : 1][iShape]; }
+    bool HasFour(int color) const {
+        return GetCount(color, SHAPE_FOUR) + GetCount(color, SHAPE_BROKEN_FOUR) + GetCount(color, SHAPE_LIVE_FOUR) > 0;
+    }
+    bool HasThree(int color) const {
+        return GetCount(color, SHAPE_OPEN_THREE) + GetCount(color, SHAPE_SPLIT_THREE) > 0;
+    }
+
+    // color 在 (x, y) 落子能否直接成五
+    bool IsFiveSquare(int color, int x, int y) const { return m_arrFiveGain[color == BLACK ? 0 : 1][y * N + x] > 0; }
+
+    // 活动威胁的遍历
+    int GetThreatCount(int color) const { return (int)m_vecActive[color == BLACK ? 0 : 1].size(); }
+    void GetThreat(int color, int i, SThreatInfo* pInfo) const { Describe(m_vecActive[color == BLACK ? 0 : 1][i], pInfo); }
+
+    // color 下一手能做成四 (以及 bThrees 时能做成活三) 的空位，按格子编号排好、去重
+    // 不落子试探：直接数每个窗口里差一子的组合，禁手由调用方判断
+    void CollectMakingSquares(int color, bool bThrees, CMoveListT<N>& vecCells) const;
+
+    // color 走棋时的必应点 (格子编号)，返回 false 表示局面不紧迫
+    // 1. 自己能成五：成五点  2. 对方能成五：对方的成五点
+    // 3. (bThrees 时) 对方有活三：它的防守点，加上自己做活四的点
+    // 结果按格子编号排好、去重
+    bool GetForcedMoves(int color, bool bThrees, CMoveListT<N>& vecCells) const;
+
+private:
+    enum { WINDOW_KINDS = 2, SLOTS = WINDOW_KINDS * 4 * N * N, PADDED = N + 2 };
+
+    // 四周各加一圈 -1 (墙) 的棋盘副本，窗口两端外侧的格子不用判越界
+    int8_t m_arrGrid[PADDED * PADDED];
+    uint8_t m_arrState[SLOTS];         // 低 4 位棋型，高 4 位颜色；0 表示无威胁
+    uint8_t m_arrInner[SLOTS];         // 窗口内部空位的偏移 (四的成五点、三的成活四点)
+    int16_t m_arrPos[SLOTS];           // 在活动列表里的下标
+    CFixedList<int, SLOTS> m_vecActive[2]; // 每个槽位最多挂一次，按槽位数给足
+    int m_arrCount[2][SHAPE_COUNT];
+    uint8_t m_arrFiveGain[2][N * N];   // 以该格为成五点的四的条数
+
+    int Classify(int sx, int sy, int d, int kind, int* pInner) const;
+    void UpdateSlot(int iSlot, int sx, int sy, int d, int kind);
+    void Refresh(int x, int y);
+    void Describe(int iSlot, SThreatInfo* pInfo) const;
+    void Activate(int iSlot, int iState, int iSign);
+};
+
+// 默认：15x15 连珠规则
+typedef CThreatIndexT<BOARD_SIZE, CRenjuRule> CThreatIndex;
+
+#endif
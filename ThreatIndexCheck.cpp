@@ -0,0 +1,113 @@
+#include "ThreatIndex.h"
+#include "Checks.h"
+#include "Board.h"
+#include "GameSession.h"
+#include "Referee.h"
+#include "Rules.h"
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// 威胁索引校验：WuZiQiDemo --check-threats [局数]
+// 随机落子/悔棋，每一步都检查：1. 增量维护的索引与从头重建的各棋型计数相同
+// 2. 每个空位“能否成五”与实际落子后 CheckWin 的结果相同
+template <int N, class TRule>
+static int CheckThreatIndex(int iGames, minstd_rand& rng, long long* pSteps, long long* pThreats) {
+    int iMismatches = 0;
+    for (int g = 0; g < iGames; g++) {
+        CBoardT<N> board;
+        CThreatIndexT<N, TRule> threats;
+        vector<Point> vecMoves;
+        int iSteps = N * N / 2 + (int)(rng() % (N * N / 2));
+        for (int k = 0; k < iSteps; k++) {
+            if (!vecMoves.empty() && rng() % 5 == 0) {
+                Point p = vecMoves.back();
+                vecMoves.pop_back();
+                board.UndoPiece(p.iX, p.iY);
+                threats.Undo(p.iX, p.iY);
+            } else {
+                int x = (int)(rng() % N), y = (int)(rng() % N);
+                if (!vecMoves.empty() && rng() % 4 != 0) {
+                    Point q = vecMoves[rng() % vecMoves.size()];
+                    x = q.iX + (int)(rng() % 5) - 2;
+                    y = q.iY + (int)(rng() % 5) - 2;
+                }
+                if (!board.IsEmpty(x, y)) continue;
+                int color = (rng() % 2 == 0) ? WHITE : BLACK;
+                board.PlacePiece(x, y, color);
+                threats.Place(x, y, color);
+                vecMoves.push_back({x, y});
+            }
+            (*pSteps)++;
+
+            CThreatIndexT<N, TRule> full;
+            full.Rebuild(board);
+            const int arrColors[] = { BLACK, WHITE };
+            for (int c = 0; c < 2; c++) {
+                *pThreats += threats.GetThreatCount(arrColors[c]);
+                for (int s = SHAPE_FOUR; s < SHAPE_COUNT; s++) {
+                    if (threats.GetCount(arrColors[c], s) != full.GetCount(arrColors[c], s)) {
+                        if (iMismatches == 0) {
+                            cout << " [不一致] " << N << "x" << N << " 第 " << g << " 局 第 " << k
+                                 << " 步 棋型 " << s << " 计数" << endl;
+                        }
+                        iMismatches++;
+                    }
+                }
+                for (int y = 0; y < N; y++) {
+                    for (int x = 0; x < N; x++) {
+                        bool bExpected = false;
+                        if (board.IsEmpty(x, y)) {
+                            board.PlacePiece(x, y, arrColors[c]);
+                            bExpected = CRefereeT<N, TRule>::CheckWin(board, x, y);
+                            board.UndoPiece(x, y);
+                        }
+                        if (threats.IsFiveSquare(arrColors[c], x, y) != bExpected) {
+                            if (iMismatches == 0) {
+                                cout << " [不一致] " << N << "x" << N << " 第 " << g << " 局 第 " << k
+                                     << " 步 成五点 " << PointToString({x, y}) << endl;
+                            }
+                            iMismatches++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return iMismatches;
+}
+
+struct SThreatChecker {
+    typedef int ResultType;
+    int iGames;
+    minstd_rand* pRng;
+    long long* pSteps;
+    long long* pThreats;
+
+    template <int N, class TRule>
+    int Run() { return CheckThreatIndex<N, TRule>(iGames, *pRng, pSteps, pThreats); }
+};
+
+int RunThreatCheck(int argc, char* argv[]) {
+    int iGames = (argc > 2) ? atoi(argv[2]) : 10;
+    minstd_rand rng(35);
+    long long llSteps = 0, llThreats = 0;
+
+    const int arrSizes[] = { 15, 19, 20 };
+    const int arrRules[] = { RULE_RENJU, RULE_STANDARD, RULE_FREESTYLE };
+    int iMismatches = 0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            SThreatChecker checker = { iGames, &rng, &llSteps, &llThreats };
+            iMismatches += DispatchGame(arrSizes[i], arrRules[j], checker);
+        }
+    }
+
+    cout << (iMismatches == 0 ? "[通过]" : "[失败]") << " 9 种组合 x " << iGames << " 局, "
+         << llSteps << " 步, 平均每步活动威胁 " << (llSteps ? (double)llThreats / llSteps : 0.0)
+         << " 条, 不一致数: " << iMismatches << endl;
+    return iMismatches == 0 ? 0 : 1;
+}
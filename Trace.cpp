@@ -0,0 +1,166 @@
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+atomic<int> CTrace::s_atLevel(TRACE_OFF);
+
+namespace {
+
+// 一个线程的环形缓冲区：只有所属线程写，导出时别的线程读
+// 线程退出后缓冲区保留在登记表里，线程池关掉以后照样能导出；之后新开的线程接着用它 (保留旧事件)，
+// 每手都开几个搜索辅助线程时环的个数只到同时活着的线程数为止
+struct STraceRing {
+    int iTid;
+    const char* pName;
+    bool bInUse;              // 有线程正在用 (登记表的锁保护)
+    atomic<uint64_t> atCount; // 写过的事件总数，下标 = 总数 % TRACE_RING_SIZE
+    STraceEvent arrEvents[TRACE_RING_SIZE];
+};
+
+struct STraceRegistry {
+    mutex mtx;
+    vector<unique_ptr<STraceRing>> vecRings;
+};
+
+STraceRegistry& GetRegistry() {
+    static STraceRegistry s_registry;
+    return s_registry;
+}
+
+thread_local STraceRing* t_pRing = nullptr;
+
+// 线程退出时把环还回登记表 (t_pRing 是普通指针，热路径上不用经过 thread_local 对象的初始化检查)
+struct SRingRelease {
+    STraceRing* pRing;
+    ~SRingRelease() {
+        if (pRing == nullptr) return;
+        STraceRegistry& reg = GetRegistry();
+        lock_guard<mutex> lock(reg.mtx);
+        pRing->bInUse = false;
+    }
+};
+thread_local SRingRelease t_release = { nullptr };
+
+bool SameName(const char* pA, const char* pB) {
+    return pA != nullptr && pB != nullptr && strcmp(pA, pB) == 0;
+}
+
+// pName 不为空时优先接手同名线程留下的环，时间线上同一类线程的事件排在一起
+STraceRing* GetRing(const char* pName = nullptr) {
+    if (t_pRing == nullptr) {
+        STraceRegistry& reg = GetRegistry();
+        lock_guard<mutex> lock(reg.mtx);
+        STraceRing* pFree = nullptr;
+        for (size_t i = 0; i < reg.vecRings.size(); i++) {
+            STraceRing* pRing = reg.vecRings[i].get();
+            if (pRing->bInUse) continue;
+            if (pFree == nullptr || SameName(pRing->pName, pName)) pFree = pRing;
+            if (pName == nullptr || SameName(pRing->pName, pName)) break;
+        }
+        if (pFree == nullptr) {
+            unique_ptr<STraceRing> pRing(new STraceRing());
+            pRing->iTid = (int)reg.vecRings.size() + 1;
+            pRing->pName = nullptr;
+            pRing->bInUse = false;
+            pRing->atCount = 0;
+            pFree = pRing.get();
+            reg.vecRings.push_back(std::move(pRing));
+        }
+        pFree->bInUse = true;
+        t_pRing = pFree;
+        t_release.pRing = pFree;
+    }
+    return t_pRing;
+}
+
+// 所有时间戳相对于第一次取时间的时刻，JSON 里的数字短一些
+chrono::steady_clock::time_point GetEpoch() {
+    static const chrono::steady_clock::time_point s_tpEpoch = chrono::steady_clock::now();
+    return s_tpEpoch;
+}
+
+} // namespace
+
+void CTrace::SetLevel(int iLevel) {
+    GetEpoch();
+    s_atLevel.store(iLevel);
+}
+
+void CTrace::SetThreadName(const char* pName) {
+    if (!IsEnabled()) return;
+    GetRing(pName)->pName = pName;
+}
+
+int64_t CTrace::NowNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - GetEpoch()).count();
+}
+
+void CTrace::Record(const char* pName, const char* pCategory, int64_t llStartNs, int64_t llDurNs) {
+    STraceRing* pRing = GetRing();
+    uint64_t ullCount = pRing->atCount.load(memory_order_relaxed);
+    STraceEvent& ev = pRing->arrEvents[ullCount % TRACE_RING_SIZE];
+    ev.pName = pName;
+    ev.pCategory = pCategory;
+    ev.llStartNs = llStartNs;
+    ev.llDurNs = llDurNs;
+    pRing->atCount.store(ullCount + 1, memory_order_release);
+}
+
+void CTrace::Clear() {
+    STraceRegistry& reg = GetRegistry();
+    lock_guard<mutex> lock(reg.mtx);
+    for (size_t i = 0; i < reg.vecRings.size(); i++) reg.vecRings[i]->atCount = 0;
+}
+
+long long CTrace::GetOverwrittenCount() {
+    STraceRegistry& reg = GetRegistry();
+    lock_guard<mutex> lock(reg.mtx);
+    long long llTotal = 0;
+    for (size_t i = 0; i < reg.vecRings.size(); i++) {
+        uint64_t ullCount = reg.vecRings[i]->atCount.load(memory_order_acquire);
+        if (ullCount > (uint64_t)TRACE_RING_SIZE) llTotal += (long long)(ullCount - TRACE_RING_SIZE);
+    }
+    return llTotal;
+}
+
+int CTrace::GetRingCount() {
+    STraceRegistry& reg = GetRegistry();
+    lock_guard<mutex> lock(reg.mtx);
+    return (int)reg.vecRings.size();
+}
+
+// {"traceEvents":[...]}：每条时间段一个 "ph":"X"，每个线程再加一条 thread_name 元数据
+// ts/dur 的单位是微秒，保留到纳秒
+bool CTrace::Flush(const string& strFile) {
+    FILE* pFile = fopen(strFile.c_str(), "w");
+    if (pFile == nullptr) return false;
+
+    STraceRegistry& reg = GetRegistry();
+    lock_guard<mutex> lock(reg.mtx);
+    fprintf(pFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool bFirst = true;
+    for (size_t i = 0; i < reg.vecRings.size(); i++) {
+        const STraceRing& ring = *reg.vecRings[i];
+        fprintf(pFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                bFirst ? "" : ",\n", ring.iTid, ring.pName ? ring.pName : "thread");
+        bFirst = false;
+
+        uint64_t ullCount = ring.atCount.load(memory_order_acquire);
+        uint64_t ullFrom = ullCount > (uint64_t)TRACE_RING_SIZE ? ullCount - TRACE_RING_SIZE : 0;
+        for (uint64_t k = ullFrom; k < ullCount; k++) {
+            const STraceEvent& ev = ring.arrEvents[k % TRACE_RING_SIZE];
+            fprintf(pFile, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    ev.pName, ev.pCategory, ring.iTid, ev.llStartNs / 1000.0, ev.llDurNs / 1000.0);
+        }
+    }
+    fprintf(pFile, "\n]}\n");
+    bool bOk = (ferror(pFile) == 0);
+    fclose(pFile);
+    return bOk;
+}
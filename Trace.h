@@ -0,0 +1,90 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 每个线程环形缓冲区的事件数 (写满后覆盖最旧的)
+const int TRACE_RING_SIZE = 1 << 16;
+
+// 记录级别：DETAIL 才记每个节点一次的细粒度时间段 (如置换表查询)，否则几毫秒就会把环形缓冲区冲掉
+enum ETraceLevel {
+    TRACE_OFF = 0,
+    TRACE_COARSE,
+    TRACE_DETAIL
+};
+
+// 一个完成的时间段 (Chrome trace 的 "X" 事件)
+// 名字和分类必须是字符串常量：只存指针，导出时才拼 JSON
+struct STraceEvent {
+    const char* pName;
+    const char* pCategory;
+    int64_t llStartNs;
+    int64_t llDurNs;
+};
+
+// 时间线记录：各线程把时间段写进自己的环形缓冲区，互不加锁
+// 导出为 Chrome / Perfetto 能直接打开的 trace-event JSON (chrome://tracing、ui.perfetto.dev)
+//
+// 关闭时 (默认) 每个埋点只多一次 relaxed 原子读和一个分支；命令行 --trace / --trace-detail 打开
+// 导出时正在写的线程可能覆盖掉最旧的几条，要完整的时间线就在空闲时导出
+class CTrace {
+public:
+    static void SetLevel(int iLevel);
+    static int GetLevel() { return s_atLevel.load(std::memory_order_relaxed); }
+    static bool IsEnabled(int iLevel = TRACE_COARSE) { return s_atLevel.load(std::memory_order_relaxed) >= iLevel; }
+
+    // 当前线程在时间线上显示的名字 (字符串常量)
+    static void SetThreadName(const char* pName);
+
+    // 把所有线程已记录的事件写成 JSON；返回是否写成功
+    static bool Flush(const std::string& strFile);
+
+    // 丢弃已记录的事件
+    static void Clear();
+
+    static int64_t NowNs();
+    static void Record(const char* pName, const char* pCategory, int64_t llStartNs, int64_t llDurNs);
+
+    // 因缓冲区写满被覆盖的事件数 (所有线程合计)
+    static long long GetOverwrittenCount();
+
+    // 已分配的环形缓冲区个数 (线程退出后环留给新线程用，所以不超过同时记录过的线程数的峰值)
+    static int GetRingCount();
+
+private:
+    static std::atomic<int> s_atLevel;
+};
+
+// 作用域计时：构造时记开始，析构时写一条完整事件
+class CTraceScope {
+public:
+    CTraceScope(const char* pName, const char* pCategory, int iLevel = TRACE_COARSE)
+        : m_pName(nullptr), m_pCategory(pCategory), m_llStartNs(0) {
+        if (CTrace::IsEnabled(iLevel)) {
+            m_pName = pName;
+            m_llStartNs = CTrace::NowNs();
+        }
+    }
+    ~CTraceScope() {
+        if (m_pName != nullptr) CTrace::Record(m_pName, m_pCategory, m_llStartNs, CTrace::NowNs() - m_llStartNs);
+    }
+
+private:
+    const char* m_pName;     // 为空表示开始时没开记录
+    const char* m_pCategory;
+    int64_t m_llStartNs;
+
+    CTraceScope(const CTraceScope&);
+    CTraceScope& operator=(const CTraceScope&);
+};
+
+#define WZQ_TRACE_CONCAT2(a, b) a##b
+#define WZQ_TRACE_CONCAT(a, b) WZQ_TRACE_CONCAT2(a, b)
+
+// 用法：WZQ_TRACE_SCOPE("search.depth", "search"); 记录到所在作用域结束
+#define WZQ_TRACE_SCOPE(name, category) CTraceScope WZQ_TRACE_CONCAT(traceScope_, __LINE__)(name, category)
+#define WZQ_TRACE_DETAIL(name, category) CTraceScope WZQ_TRACE_CONCAT(traceScope_, __LINE__)(name, category, TRACE_DETAIL)
+
+#endif
@@ -0,0 +1,63 @@
+#include "Trace.h"
+#include "Checks.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// 时间线缓冲区自检：WuZiQiDemo --check-trace [轮数] [每轮线程数]
+// 像每手开搜索辅助线程那样，一轮轮开出一批短命的线程，各记几条事件后退出：
+// 1. 环形缓冲区的个数不能随轮数增长，最多多出一轮的线程数
+// 2. 退出的线程记下的事件都还在，导出的 JSON 里一条不少
+int RunTraceCheck(int argc, char* argv[]) {
+    int iRounds = (argc > 2) ? atoi(argv[2]) : 200;
+    int iThreads = (argc > 3) ? atoi(argv[3]) : 3;
+    if (iRounds < 1) iRounds = 1;
+    if (iThreads < 1) iThreads = 1;
+    const int EVENTS_PER_THREAD = 4;
+    const string strFile = "check_trace.json";
+
+    int iOldLevel = CTrace::GetLevel();
+    if (!CTrace::IsEnabled()) CTrace::SetLevel(TRACE_COARSE);
+    int iRingsBefore = CTrace::GetRingCount();
+
+    for (int r = 0; r < iRounds; r++) {
+        vector<thread> vecThreads;
+        for (int t = 0; t < iThreads; t++) {
+            vecThreads.push_back(thread([] {
+                CTrace::SetThreadName("check helper");
+                for (int k = 0; k < EVENTS_PER_THREAD; k++) {
+                    WZQ_TRACE_SCOPE("check.trace", "check");
+                }
+            }));
+        }
+        for (size_t t = 0; t < vecThreads.size(); t++) vecThreads[t].join();
+    }
+    int iRingsAfter = CTrace::GetRingCount();
+
+    // 按事件名数导出的条数 (每轮的事件总数远小于环的容量，不会被覆盖)
+    long long llExpected = (long long)iRounds * iThreads * EVENTS_PER_THREAD;
+    long long llFound = 0;
+    bool bFlushed = CTrace::Flush(strFile);
+    if (bFlushed) {
+        ifstream file(strFile);
+        string strLine;
+        while (getline(file, strLine)) {
+            if (strLine.find("\"name\":\"check.trace\"") != string::npos) llFound++;
+        }
+    }
+    remove(strFile.c_str());
+    CTrace::SetLevel(iOldLevel);
+
+    bool bBounded = iRingsAfter - iRingsBefore <= iThreads;
+    bool bKept = bFlushed && llFound == llExpected;
+    cout << (bBounded && bKept ? "[通过]" : "[失败]") << " " << iRounds << " 轮 x " << iThreads << " 个线程, 环形缓冲区 "
+         << iRingsBefore << " -> " << iRingsAfter << " 个 (每个 " << sizeof(STraceEvent) * TRACE_RING_SIZE / 1024
+         << " KB), 导出事件 " << llFound << "/" << llExpected << endl;
+    return (bBounded && bKept) ? 0 : 1;
+}
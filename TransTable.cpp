@@ -0,0 +1,105 @@
+#include "TransTable.h"
+#include "ByteIO.h"
+
+using namespace std;
+
+// splitmix64：固定种子，保证每次运行哈希一致 (便于复现和存盘)
+static uint64_t SplitMix64(uint64_t& ullState) {
+    uint64_t z = (ullState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+CZobrist::CZobrist() {
+    uint64_t ullState = 20240615;
+    for (int c = 0; c < 2; c++) {
+        for (int i = 0; i < MAX_BOARD_SIZE * MAX_BOARD_SIZE; i++) {
+            m_arrKeys[c][i] = SplitMix64(ullState);
+        }
+    }
+    m_ullSide = SplitMix64(ullState);
+}
+
+const CZobrist& CZobrist::Get() {
+    static const CZobrist s_zobrist;
+    return s_zobrist;
+}
+
+// data 的布局：低 32 位为分值，其后 8 位深度、2 位边界类型、10 位走法 (+1，0 表示没有)
+static uint64_t PackEntry(int iValue, int iDepth, int iBound, int iMove) {
+    uint64_t ullData = (uint32_t)iValue;
+    ullData |= (uint64_t)(iDepth & 0xFF) << 32;
+    ullData |= (uint64_t)(iBound & 0x3) << 40;
+    ullData |= (uint64_t)((iMove + 1) & 0x3FF) << 42;
+    return ullData;
+}
+
+CTransTable::CTransTable(size_t iEntries) {
+    size_t iSize = 1;
+    while (iSize * 2 <= iEntries) iSize *= 2;
+    m_pSlots.reset(new SSlot[iSize]);
+    m_iSlots = iSize;
+    m_iMask = iSize - 1;
+    Clear();
+}
+
+CTransTable::CTransTable(size_t iEntries, const uint8_t* pRaw, uint64_t* pHash)
+    : m_pSlots(new SSlot[iEntries]), m_iSlots(iEntries), m_iMask(iEntries - 1) {
+    *pHash = LoadRaw(pRaw, *pHash);
+}
+
+void CTransTable::Clear() {
+    for (size_t i = 0; i < m_iSlots; i++) {
+        m_pSlots[i].atCheck.store(0, memory_order_relaxed);
+        m_pSlots[i].atData.store(0, memory_order_relaxed);
+    }
+}
+
+bool CTransTable::Probe(uint64_t ullKey, STTEntry* pOut) const {
+    const SSlot& slot = m_pSlots[ullKey & m_iMask];
+    uint64_t ullData = slot.atData.load(memory_order_relaxed);
+    uint64_t ullCheck = slot.atCheck.load(memory_order_relaxed);
+    if ((ullCheck ^ ullData) != ullKey || ullData == 0) return false;
+
+    pOut->iValue = (int32_t)(uint32_t)(ullData & 0xFFFFFFFFULL);
+    pOut->iDepth = (int)((ullData >> 32) & 0xFF);
+    pOut->iBound = (int)((ullData >> 40) & 0x3);
+    pOut->iMove = (int)((ullData >> 42) & 0x3FF) - 1;
+    return true;
+}
+
+void CTransTable::Store(uint64_t ullKey, int iValue, int iDepth, int iBound, int iMove) {
+    SSlot& slot = m_pSlots[ullKey & m_iMask];
+    uint64_t ullData = PackEntry(iValue, iDepth, iBound, iMove);
+    // 总是替换：局面一步一变，旧条目很快就用不上了
+    slot.atData.store(ullData, memory_order_relaxed);
+    slot.atCheck.store(ullKey ^ ullData, memory_order_relaxed);
+}
+
+// 校验和：两列 (check、data) 各自一条 HashWord 链，互不等待，最后再合成一个
+uint64_t CTransTable::SaveRaw(uint8_t* pOut, uint64_t ullHash) const {
+    uint64_t ullHashCheck = ullHash, ullHashData = ~ullHash;
+    for (size_t i = 0; i < m_iSlots; i++, pOut += 16) {
+        uint64_t ullCheck = m_pSlots[i].atCheck.load(memory_order_relaxed);
+        uint64_t ullData = m_pSlots[i].atData.load(memory_order_relaxed);
+        SetU64(pOut, ullCheck);
+        SetU64(pOut + 8, ullData);
+        ullHashCheck = HashWord(ullHashCheck, ullCheck);
+        ullHashData = HashWord(ullHashData, ullData);
+    }
+    return HashWord(ullHashCheck, ullHashData);
+}
+
+uint64_t CTransTable::LoadRaw(const uint8_t* pIn, uint64_t ullHash) {
+    uint64_t ullHashCheck = ullHash, ullHashData = ~ullHash;
+    for (size_t i = 0; i < m_iSlots; i++, pIn += 16) {
+        uint64_t ullCheck = GetU64(pIn);
+        uint64_t ullData = GetU64(pIn + 8);
+        m_pSlots[i].atCheck.store(ullCheck, memory_order_relaxed);
+        m_pSlots[i].atData.store(ullData, memory_order_relaxed);
+        ullHashCheck = HashWord(ullHashCheck, ullCheck);
+        ullHashData = HashWord(ullHashData, ullData);
+    }
+    return HashWord(ullHashCheck, ullHashData);
+}
@@ -0,0 +1,79 @@
+#ifndef _TRANSTABLE_H_
+#define _TRANSTABLE_H_
+
+#include "Global.h"
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+
+// Zobrist 哈希键：每个 (颜色, 格子) 一个随机 64 位数，局面哈希 = 所有棋子键的异或
+// 格子编号为 y * N + x，按最大棋盘分配，所有棋盘大小共用一份
+class CZobrist {
+public:
+    static uint64_t Piece(int color, int iCell) { return Get().m_arrKeys[color == BLACK ? 0 : 1][iCell]; }
+    static uint64_t WhiteToMove() { return Get().m_ullSide; }
+
+private:
+    uint64_t m_arrKeys[2][MAX_BOARD_SIZE * MAX_BOARD_SIZE];
+    uint64_t m_ullSide;
+
+    CZobrist();
+    static const CZobrist& Get();
+};
+
+// 置换表条目的边界类型
+enum ETTBound {
+    TT_NONE = 0,
+    TT_EXACT,   // 精确值
+    TT_LOWER,   // 下界 (发生了 beta 剪枝)
+    TT_UPPER    // 上界 (所有走法都没超过 alpha)
+};
+
+// 一次查询的结果
+struct STTEntry {
+    int iValue;
+    int iDepth;
+    int iBound;  // ETTBound
+    int iMove;   // 最佳走法的格子编号，-1 表示没有
+};
+
+// 置换表：多个搜索线程共享，无锁
+// 每个槽位存 (key ^ data, data) 两个 64 位数，读到撕裂的数据时校验自然失败，当作没命中
+// 表本身不计数 (所有线程抢同一个计数器太贵)，命中统计在各搜索的 SSearchStats 里
+class CTransTable {
+public:
+    // iEntries 会向下取整到 2 的幂
+    explicit CTransTable(size_t iEntries);
+
+    // 直接用快照里的槽位 (SaveRaw 的格式) 构造，iEntries 必须是 2 的幂；
+    // 槽位只写一遍，*pHash 从传进来的值接着算校验和 (与 LoadRaw 相同)
+    CTransTable(size_t iEntries, const uint8_t* pRaw, uint64_t* pHash);
+
+    bool Probe(uint64_t ullKey, STTEntry* pOut) const;
+    void Store(uint64_t ullKey, int iValue, int iDepth, int iBound, int iMove);
+
+    void Clear();
+
+    // 原样导出/导入所有槽位 (每个 16 字节，小端)，快照用；导入时条目数必须相同
+    // 两个函数都顺带从 ullHash 接着算这些字节的校验和并返回 (两列各一条 HashWord 链)，恢复时映射的内存只读一遍
+    // 调用期间不能有线程在读写这张表
+    size_t GetRawBytes() const { return m_iSlots * 16; }
+    uint64_t SaveRaw(uint8_t* pOut, uint64_t ullHash) const;
+    uint64_t LoadRaw(const uint8_t* pIn, uint64_t ullHash);
+
+    size_t GetEntryCount() const { return m_iSlots; }
+    size_t GetBytes() const { return m_iSlots * sizeof(SSlot); }
+
+private:
+    struct SSlot {
+        std::atomic<uint64_t> atCheck; // key ^ data
+        std::atomic<uint64_t> atData;
+    };
+
+    std::unique_ptr<SSlot[]> m_pSlots; // 不用 vector：从快照构造时不必先清零一遍
+    size_t m_iSlots;
+    size_t m_iMask;
+};
+
+#endif
@@ -24,6 +24,8 @@
 #include <utility>
 #include <map>
 
+#include "FixedList.h"
+
 // ============================================================================
 // Constants
 // ============================================================================
@@ -33,6 +35,9 @@ const int MAX_WARNINGS = 3;
 const int MCTS_ITERATIONS = 1000;
 const double UCB_CONSTANT = 1.414; // sqrt(2)
 
+// Move list with one slot per intersection: lives on the stack, never touches the heap
+typedef CFixedList<std::pair<int, int>, BOARD_SIZE * BOARD_SIZE> CMoveList;
+
 // ============================================================================
 // Enumerations
 // ============================================================================
@@ -100,7 +105,7 @@ public:
     bool HasLastMove() const;
     
     int GetEmptyCount() const;
-    std::vector<std::pair<int, int>> GetEmptyPositions() const;
+    void GetEmptyPositions(CMoveList& vecOut) const;
     
 private:
     EPieceColor m_arrGrid[BOARD_SIZE][BOARD_SIZE];
@@ -265,7 +270,7 @@ struct SMCTSNode {
     EPieceColor m_ePlayerColor;
     SMCTSNode* m_pParent;
     std::vector<std::unique_ptr<SMCTSNode>> m_vecChildren;
-    std::vector<std::pair<int, int>> m_vecUntriedMoves;
+    CMoveList m_vecUntriedMoves;
     
     SMCTSNode(int iRow, int iCol, EPieceColor eColor, SMCTSNode* pParent = nullptr);
     
@@ -301,7 +306,7 @@ private:
     /**
      * @brief Get promising moves (prioritize moves near existing stones)
      */
-    std::vector<std::pair<int, int>> GetPromisingMoves(const CBoard& board) const;
+    void GetPromisingMoves(const CBoard& board, CMoveList& vecOut) const;
     
     /**
      * @brief Evaluate position heuristically
@@ -1,76 +1,103 @@
 #include "Board.h"
 #include "Console.h"
+#include "BoardRenderer.h"
 #include "Player.h"
 #include "Referee.h"
 #include "AIPlayer.h" // [新增]
+#include "GameServer.h"
+#include "Checks.h"
+#include "Rules.h"
+#include "ForbiddenMap.h"
+#include "Trace.h"
+#include "NNUE.h"
+#include "Log.h"
 #include <cstdlib>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <ctime>      // [新增] 计时用
+#include <thread>
 
 using namespace std;
 
-string PointToString(Point p) {
-    string s = "";
-    s += (char)('A' + p.iX);
-    s += to_string(p.iY + 1);
-    return s;
-}
+// 服务器模式：WuZiQiDemo --server [线程数]
+// 一个进程托管所有对局，协议见 GameServer.h
+static int RunServer(int argc, char* argv[]) {
+    int iThreads = (int)thread::hardware_concurrency();
+    if (argc > 2) iThreads = atoi(argv[2]);
 
-int main() {
-    system("chcp 65001");
+    // 权重只读一次，所有对局共享
+    shared_ptr<const AIWeights> pWeights =
+        make_shared<AIWeights>(ReadAIWeights("ai_brain.txt"));
 
-    // --- 1. 游戏模式选择 ---
-    cout << "========================================" << endl;
-    cout << "        五子棋大战 (C++ Console)        " << endl;
-    cout << "========================================" << endl;
-    cout << " 1. 人人对战 (P v P)" << endl;
-    cout << " 2. 人机对战 (P v E) - 你执黑" << endl;
-    cout << " 3. 人机对战 (P v E) - 你执白" << endl;
-    cout << "========================================" << endl;
-    cout << " 请选择模式 (1-3): ";
-
-    int mode;
-    cin >> mode;
+    CGameServer server(iThreads, pWeights);
+    server.Run(cin, cout);
+    return 0;
+}
 
-    CBoard board;
-    CPlayer* pBlack = nullptr;
-    CPlayer* pWhite = nullptr;
+// 一局游戏：棋盘大小 N 和规则 TRule 都是编译期常量
+template <int N, class TRule>
+static void PlayGame(int mode, int iDepth, int iPlayouts) {
+    CBoardT<N> board;
+    CForbiddenMapT<N, TRule> forbidden; // 随每手落子增量更新，判黑棋禁手只需查表
+    CPlayerT<N>* pBlack = nullptr;
+    CPlayerT<N>* pWhite = nullptr;
+
+    // 有网络文件时，搜索用神经网络评估；没有或大小不符就用原来的棋型评估
+    shared_ptr<const CNNUENetwork> pNet;
+    if (mode == 2 || mode == 3) {
+        string strError;
+        pNet = CNNUENetwork::Load("ai_brain.nnue", &strError);
+        if (pNet && pNet->GetBoardSize() != N) pNet.reset();
+        if (pNet && iDepth > 0) cout << "[系统] 已加载神经网络评估 ai_brain.nnue" << endl;
+    }
 
     if (mode == 2) {
-        pBlack = new CHumanPlayer(BLACK);
-        pWhite = new CAIPlayer(WHITE);
+        CAIPlayerT<N, TRule>* pAI = new CAIPlayerT<N, TRule>(WHITE);
+        pAI->SetSearchDepth(iDepth);
+        pAI->SetMCTS(iPlayouts, MCTS_PUCT);
+        pAI->SetNetwork(pNet);
+        pBlack = new CHumanPlayerT<N>(BLACK);
+        pWhite = pAI;
     } else if (mode == 3) {
-        pBlack = new CAIPlayer(BLACK);
-        pWhite = new CHumanPlayer(WHITE);
+        CAIPlayerT<N, TRule>* pAI = new CAIPlayerT<N, TRule>(BLACK);
+        pAI->SetSearchDepth(iDepth);
+        pAI->SetMCTS(iPlayouts, MCTS_PUCT);
+        pAI->SetNetwork(pNet);
+        pBlack = pAI;
+        pWhite = new CHumanPlayerT<N>(WHITE);
     } else {
-        pBlack = new CHumanPlayer(BLACK);
-        pWhite = new CHumanPlayer(WHITE);
+        pBlack = new CHumanPlayerT<N>(BLACK);
+        pWhite = new CHumanPlayerT<N>(WHITE);
     }
 
     bool bIsBlackTurn = true;
     int round = 1;
     vector<string> history;
 
+    // 棋盘固定在屏幕顶部，每手只重画变化的行；对局文字显示在棋盘下方
+    CBoardRendererT<N> renderer;
+
     // 计时相关：超时警告次数
     int blackWarnings = 0;
     int whiteWarnings = 0;
 
     // --- 2. 游戏主循环 ---
     while (true) {
-        cout << "\n========================================\n";
+        string strFrame;
+        renderer.RenderDiff(board, strFrame);
+        CConsole::Write(strFrame);
+
+        cout << "========================================\n";
         cout << " 第 " << round << " 手  |  当前执子: "
              << (bIsBlackTurn ? "黑 (Black)" : "白 (White)") << endl;
         cout << "========================================\n";
 
-        board.Draw();
-
         if (!history.empty()) {
             cout << "\n[历史]: " << history.back() << endl;
         }
 
-        CPlayer* curr = bIsBlackTurn ? pBlack : pWhite;
+        CPlayerT<N>* curr = bIsBlackTurn ? pBlack : pWhite;
         Point p;
         bool bWin = false;
 
@@ -79,6 +106,7 @@ int main() {
 
         while(true) {
             p = curr->MakeMove(board);
+            CLog::Flush(); // AI 的思考记录先于下面的界面文字输出
 
             // --- 计时结束与判断 ---
             // 只有人类玩家需要判断超时，AI一般瞬间完成
@@ -102,54 +130,57 @@ int main() {
             }
 
             int color = bIsBlackTurn ? BLACK : WHITE;
-            board.PlacePiece(p.iX, p.iY, color);
 
-            // A. 检查胜利
-            if (CReferee::CheckWin(board, p.iX, p.iY)) {
-                bWin = true;
-                break;
+            // A. 检查禁手 (禁手图里已经排除了成五的点，五连优先)
+            if (bIsBlackTurn && forbidden.IsForbidden(p.iX, p.iY)) {
+                cout << "\n [警告] 禁手点 (长连/三三/四四)！请重下。" << endl;
+
+                // 注意：重下不重置计时器，依然算思考时间
+                continue;
             }
 
-            // B. 检查禁手
-            if (bIsBlackTurn) {
-                if (CReferee::CheckForbidden(board, p.iX, p.iY)) {
-                    cout << "\n [警告] 禁手点 (长连/三三/四四)！请重下。" << endl;
-                    board.UndoPiece(p.iX, p.iY);
+            board.PlacePiece(p.iX, p.iY, color);
+            forbidden.Place(p.iX, p.iY, color);
 
-                    // 注意：重下不重置计时器，依然算思考时间
-                    continue;
-                }
+            // B. 检查胜利
+            if (CRefereeT<N, TRule>::CheckWin(board, p.iX, p.iY)) {
+                bWin = true;
+                break;
             }
             break;
         }
 
         if (bWin) {
-            board.Draw();
+            string strLast;
+            renderer.RenderDiff(board, strLast);
+            CConsole::Write(strLast);
             cout << "\n########################################\n";
             cout << " 比赛结束！ " << (bIsBlackTurn ? "黑方" : "白方") << " 获胜！";
-            if (bIsBlackTurn) cout << "(五连)";
+            // 是否必须正好五连由规则决定
+            bool bExactFive = bIsBlackTurn ? TRule::BLACK_EXACT_FIVE : TRule::WHITE_EXACT_FIVE;
+            if (bExactFive) cout << "(五连)";
             else cout << "(五连或长连)";
             cout << "\n########################################\n";
 
             // ============== 学习逻辑开始 ==============
-            CAIPlayer* pAI = nullptr;
+            CAIPlayerT<N, TRule>* pAI = nullptr;
             bool bAiWon = false;
 
-            // 这里的 mode 变量必须是在 main 开头定义的那个
-            // 确保你没有把它定义在 if 块里导致这里访问不到
+            // mode 是 main 里选好的模式，作为参数传进 PlayGame
             if (mode == 2) {
                 // 模式2：人(黑) vs AI(白)。如果是黑赢(bIsBlackTurn=true)，则AI输
-                pAI = dynamic_cast<CAIPlayer*>(pWhite);
+                pAI = dynamic_cast<CAIPlayerT<N, TRule>*>(pWhite);
                 bAiWon = !bIsBlackTurn;
             }
             else if (mode == 3) {
                 // 模式3：AI(黑) vs 人(白)。如果是黑赢，则AI赢
-                pAI = dynamic_cast<CAIPlayer*>(pBlack);
+                pAI = dynamic_cast<CAIPlayerT<N, TRule>*>(pBlack);
                 bAiWon = bIsBlackTurn;
             }
 
             if (pAI != nullptr) {
                 pAI->Learn(bAiWon); // 这句话会触发 SaveWeights
+                CLog::Flush();
             }
             // ============== 学习逻辑结束 ==============
 
@@ -169,6 +200,157 @@ GAME_END:
     // 清理内存
     delete pBlack;
     delete pWhite;
+}
+
+// 开局时把 (大小, 规则) 分发成一次模板调用
+struct SGameRunner {
+    typedef void ResultType;
+    int iMode;
+    int iDepth;
+    int iPlayouts;
+
+    template <int N, class TRule>
+    void Run() { PlayGame<N, TRule>(iMode, iDepth, iPlayouts); }
+};
+
+// 时间线：任意模式前加 --trace <文件> 打开记录，--trace-detail <文件> 还记录置换表查询这类逐节点的时间段
+// 从参数里摘掉这两项，其余参数照旧解析；返回要写出的文件名 (没开为空)
+static string TakeTraceFlag(int& argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; i++) {
+        string strArg = argv[i];
+        if (strArg != "--trace" && strArg != "--trace-detail") continue;
+        string strFile = argv[i + 1];
+        CTrace::SetLevel(strArg == "--trace" ? TRACE_COARSE : TRACE_DETAIL);
+        for (int k = i; k + 2 < argc; k++) argv[k] = argv[k + 2];
+        argc -= 2;
+        return strFile;
+    }
+    return "";
+}
+
+// 日志：任意模式前加 --log <文件> 把记录按 JSON 行追加进文件，--log-level <0-4> 改运行期级别 (0 调试 … 3 错误，4 关闭)
+static void TakeLogFlags(int& argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc;) {
+        string strArg = argv[i];
+        if (strArg == "--log") {
+            if (!CLog::OpenFile(argv[i + 1])) cerr << "[log] 无法打开 " << argv[i + 1] << endl;
+        } else if (strArg == "--log-level") {
+            CLog::SetLevel(atoi(argv[i + 1]));
+        } else {
+            i++;
+            continue;
+        }
+        for (int k = i; k + 2 < argc; k++) argv[k] = argv[k + 2];
+        argc -= 2;
+    }
+}
+
+// main 从哪里返回都在退出前写出时间线
+struct STraceFlusher {
+    string strFile;
+    ~STraceFlusher() {
+        if (strFile.empty()) return;
+        if (CTrace::Flush(strFile)) {
+            cerr << "[trace] 已写出 " << strFile << " (覆盖 " << CTrace::GetOverwrittenCount() << " 条)" << endl;
+        } else {
+            cerr << "[trace] 写出失败: " << strFile << endl;
+        }
+    }
+};
+
+// 命令行模式：第一个参数 -> 入口 (各模块的自检和基准见 Checks.h)
+struct SCommand {
+    const char* szName;
+    int (*pfnRun)(int argc, char* argv[]);
+};
+
+static const SCommand s_arrCommands[] = {
+    { "--server", RunServer },
+    { "--check-eval", RunEvalCheck },
+    { "--check-forbidden", RunForbiddenCheck },
+    { "--check-threats", RunThreatCheck },
+    { "--check-alloc", RunAllocCheck },
+    { "--check-playouts", RunPlayoutCheck },
+    { "--check-sparse", RunSparseCheck },
+    { "--check-small", RunSmallSolveCheck },
+    { "--check-nnue", RunNNUECheck },
+    { "--check-budget", RunBudgetCheck },
+    { "--check-trace", RunTraceCheck },
+    { "--nnue-init", RunNNUEInit },
+    { "--bench-mcts", RunMCTSBench },
+    { "--bench-playouts", RunPlayoutBench },
+    { "--bench-log", RunLogBench },
+    { "--bench-sparse", RunSparseBench },
+    { "--solve", RunSolve },
+    { "--solve-small", RunSmallSolve },
+    { "--bench-snapshot", RunSnapshotBench },
+    { "--bench-search", RunSearchBench },
+    { "--bench-multipv", RunMultiPVBench },
+    { "--analyze", RunAnalyze },
+    { "--suite", RunSuite },
+    { "--audit", RunAudit },
+    { "--audit-gen", RunAuditGen },
+};
+
+int main(int argc, char* argv[]) {
+    STraceFlusher traceFlusher;
+    traceFlusher.strFile = TakeTraceFlag(argc, argv);
+    TakeLogFlags(argc, argv);
+    CTrace::SetThreadName("main");
+
+    if (argc > 1) {
+        for (size_t i = 0; i < sizeof(s_arrCommands) / sizeof(s_arrCommands[0]); i++) {
+            if (string(argv[1]) == s_arrCommands[i].szName) return s_arrCommands[i].pfnRun(argc, argv);
+        }
+    }
+
+    CConsole::Init();
+
+    // --- 1. 游戏模式选择 ---
+    cout << "========================================" << endl;
+    cout << "        五子棋大战 (C++ Console)        " << endl;
+    cout << "========================================" << endl;
+    cout << " 1. 人人对战 (P v P)" << endl;
+    cout << " 2. 人机对战 (P v E) - 你执黑" << endl;
+    cout << " 3. 人机对战 (P v E) - 你执白" << endl;
+    cout << "========================================" << endl;
+    cout << " 请选择模式 (1-3): ";
+
+    int mode;
+    cin >> mode;
+
+    // --- 棋盘大小与规则 ---
+    cout << " 棋盘大小 (15/19/20，默认15): ";
+    int iSize = BOARD_SIZE;
+    cin >> iSize;
+    if (!IsSupportedBoardSize(iSize)) iSize = BOARD_SIZE;
+
+    cout << " 规则 (1. 连珠-黑棋禁手  2. 标准-正好五连  3. 自由-五连以上): ";
+    int iRuleChoice = 1;
+    cin >> iRuleChoice;
+    int iRule = RULE_RENJU;
+    if (iRuleChoice == 2) iRule = RULE_STANDARD;
+    else if (iRuleChoice == 3) iRule = RULE_FREESTYLE;
+
+    int iDepth = 0;
+    int iPlayouts = 0;
+    if (mode == 2 || mode == 3) {
+        cout << " AI 算法 (1. 快速贪心  2. Alpha-Beta 搜索  3. 蒙特卡洛树搜索): ";
+        int iAlgo = 1;
+        cin >> iAlgo;
+        if (iAlgo == 2) {
+            cout << " 搜索深度 (2-6，每步最多 10 秒): ";
+            cin >> iDepth;
+            if (iDepth < 1) iDepth = 1;
+        } else if (iAlgo == 3) {
+            cout << " 每步模拟盘数 (例如 2000，每步最多 10 秒): ";
+            cin >> iPlayouts;
+            if (iPlayouts < 1) iPlayouts = 1;
+        }
+    }
+
+    SGameRunner runner = { mode, iDepth, iPlayouts };
+    DispatchGame(iSize, iRule, runner);
 
     cout << "按任意键退出...";
     cin.ignore(); cin.get();